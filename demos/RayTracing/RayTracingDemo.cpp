@@ -23,7 +23,7 @@ namespace {
   }
   
   void statusUpdate(float percentageCompleted, long ms) {
-    printf("%11.1f%%%12d", percentageCompleted, re::queriesMade);
+    printf("%11.1f%%%12d", percentageCompleted, re::queriesMade());
     if (ms < 1000) {
       printf("%12ld ms\n", ms);
     } else if (ms < 60 * 1000) {
@@ -209,19 +209,19 @@ const re::vec3 RayTracingDemo::shootRay(unsigned int depth, const re::vec3& orig
     
     // determine direction of shadow rays
     re::vec3 ray;
+    reFloat maxDist = RE_INFINITY;
     if (light->isDirectional()) {
       ray = re::normalize(-light->vect());
     } else {
       ray = re::normalize(light->vect() - intersect);
+      maxDist = re::length(light->vect() - intersect);
     }
     
     // trace shadow rays to light sources
-    re::vec3 objIntersect;
     _raysSent++;
-    re::Entity* other = _world.queryWithRay(intersect, ray, &objIntersect);
     
-    // if query is successful
-    if (other == nullptr || (!light->isDirectional() && re::lengthSq(objIntersect - intersect) > re::lengthSq(light->vect() - intersect))) {
+    // if the light is visible
+    if (!_world.queryOcclusion(intersect, ray, maxDist)) {
       const re::vec3 back = re::normalize(light->vect() - intersect);
       const re::vec3 halfVec = re::normalize(back + ray);
       
@@ -348,9 +348,9 @@ void RayTracingDemo::renderScene(GLsizei w, GLsizei h) {
   statusUpdate(100.0, timeBetween(start, now));
   gettimeofday(&lastChecked, nullptr);
   printf("---------------------------------------\n");
-  printf("Query Efficiency Increase: %.1f%%\n", 100.0 * (_world.entities().size() * _raysSent) / double(re::queriesMade) - 100.0);
+  printf("Query Efficiency Increase: %.1f%%\n", 100.0 * (_world.entities().size() * _raysSent) / double(re::queriesMade()) - 100.0);
   
-  re::queriesMade = 0;
+  re::resetQueriesMade();
   
   delete[] tanx;
 }
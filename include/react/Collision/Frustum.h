@@ -0,0 +1,72 @@
+/**
+ * @file
+ * Contains the definition of the re::Frustum class
+ */
+#ifndef RE_FRUSTUM_H
+#define RE_FRUSTUM_H
+
+#include "react/math.h"
+#include "react/Collision/Shapes/Plane.h"
+
+namespace re {
+
+  /**
+   * @ingroup collision
+   * A convex region bounded by six planes, typically the volume visible to a
+   * camera. The plane normals point out of the frustum.
+   */
+
+  class Frustum {
+  public:
+    enum Side {
+      LEFT = 0,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      NEAR_SIDE,
+      FAR_SIDE
+    };
+
+    Frustum(const re::Plane& left, const re::Plane& right, const re::Plane& bottom, const re::Plane& top, const re::Plane& nearPlane, const re::Plane& farPlane);
+    Frustum(const re::vec3& eye, const re::vec3& forward, const re::vec3& up, reFloat fovy, reFloat aspect, reFloat nearDist, reFloat farDist);
+
+    const re::Plane plane(reUInt i) const;
+    const re::vec3& corner(reUInt i) const;
+
+    bool containsPoint(const re::vec3& point) const;
+
+    /** The number of planes bounding the frustum */
+    static const reUInt NUM_PLANES = 6;
+    /** The number of corners of the frustum */
+    static const reUInt NUM_CORNERS = 8;
+
+  private:
+    void computeCorners();
+
+    /** The outward facing normals of each plane */
+    re::vec3 _normals[NUM_PLANES];
+    /** The offsets of each plane along its normal */
+    reFloat _offsets[NUM_PLANES];
+    /** The corners, indexed by right (bit 0), top (bit 1) and far (bit 2) */
+    re::vec3 _corners[NUM_CORNERS];
+  };
+
+  inline const re::Plane Frustum::plane(reUInt i) const {
+    return re::Plane(_normals[i], _offsets[i]);
+  }
+
+  inline const re::vec3& Frustum::corner(reUInt i) const {
+    return _corners[i];
+  }
+
+  inline bool Frustum::containsPoint(const re::vec3& point) const {
+    for (reUInt i = 0; i < NUM_PLANES; i++) {
+      if (re::dot(_normals[i], point) - _offsets[i] > RE_FP_TOLERANCE) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+#endif
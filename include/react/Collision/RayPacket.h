@@ -0,0 +1,75 @@
+/**
+ * @file
+ * Contains the definition of the re::RayPacket struct
+ */
+#ifndef RE_RAY_PACKET_H
+#define RE_RAY_PACKET_H
+
+#include "react/math.h"
+#include "react/Collision/Shapes/Ray.h"
+#include "react/Collision/reSpatialQueries.h"
+
+class reShape;
+
+namespace re {
+  class Entity;
+
+  /**
+   * @ingroup collision
+   * A group of up to four rays stored in a structure of arrays layout, so that
+   * a single shape can be tested against all rays in the packet at once. Each
+   * ray is identified by its lane, and sets of lanes are represented as bit
+   * masks where bit i corresponds to lane i.
+   */
+
+  struct RayPacket {
+    static const reUInt WIDTH = 4;
+
+    RayPacket(const re::Ray* rays, re::RayQuery* results, reUInt n);
+
+    void record(reUInt lane, reFloat t, re::Entity& entity);
+
+    /** The number of rays in the packet */
+    const reUInt size;
+    /** The mask of all lanes holding a ray */
+    const reUInt lanes;
+    /** The rays in the packet, used when a lane continues on its own */
+    const re::Ray* const rays;
+    /** The closest result found so far for each ray */
+    re::RayQuery* const results;
+
+    /** The ray origins */
+    alignas(16) reFloat ox[WIDTH];
+    alignas(16) reFloat oy[WIDTH];
+    alignas(16) reFloat oz[WIDTH];
+    /** The normalized ray directions */
+    alignas(16) reFloat dx[WIDTH];
+    alignas(16) reFloat dy[WIDTH];
+    alignas(16) reFloat dz[WIDTH];
+  };
+
+  /**
+   * Returns true if the shape can be tested against a re::RayPacket with
+   * re::intersects, otherwise each ray must be tested individually
+   *
+   * @param shape The shape to test
+   * @return True if a packet kernel exists for the shape
+   */
+
+  bool hasPacketKernel(const reShape& shape);
+
+  reUInt intersects(const reShape& shape, const re::Transform& inverse, const re::RayPacket& packet, reUInt mask, reFloat* t);
+
+  /**
+   * Returns the number of lanes in the mask
+   *
+   * @param mask The mask of lanes
+   * @return The number of set bits
+   */
+
+  inline reUInt countLanes(reUInt mask) {
+    return __builtin_popcount(mask);
+  }
+}
+
+#endif
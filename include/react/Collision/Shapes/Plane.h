@@ -50,7 +50,7 @@ namespace re {
     // do nothing
   }
 
-  inline Plane::Plane(const Plane& plane) : _normal(plane._normal), _offset(plane._offset) {
+  inline Plane::Plane(const Plane& plane) : reShape(plane), _normal(plane._normal), _offset(plane._offset) {
     // do nothing
   }
 
@@ -91,6 +91,7 @@ namespace re {
   }
 
   inline Plane& Plane::operator=(const Plane& plane) {
+    reShape::operator=(plane);
     _normal = plane._normal;
     _offset = plane._offset;
     return *this;
@@ -9,36 +9,54 @@ namespace re {
 
   /**
    * @ingroup shapes
-   * Defines an infinitely long segment
+   * Defines a half-infinite line. Only the interval [tMin, tMax] along the
+   * ray is considered by queries, where distances are measured from the
+   * origin along the normalized direction.
    */
 
   class Ray {
   public:
-    Ray(const re::vec3& origin, const re::vec3& dir);
+    Ray(const re::vec3& origin, const re::vec3& dir, reFloat tMin = 0.0, reFloat tMax = RE_INFINITY);
     Ray(const re::Ray& ray);
     Ray(const re::Ray& ray, const re::Transform& transform);
 
     const re::vec3& origin() const;
     const re::vec3& dir() const;
+    reFloat tMin() const;
+    reFloat tMax() const;
+    const re::vec3 pointAt(reFloat t) const;
 
     void setOrigin(const re::vec3& origin);
     void setDir(const re::vec3& dir);
+    void setInterval(reFloat tMin, reFloat tMax);
 
   private:
     re::vec3 _origin;
     re::vec3 _dir;
+    reFloat _tMin;
+    reFloat _tMax;
   };
 
-  inline Ray::Ray(const re::vec3& origin, const re::vec3& dir) : _origin(origin), _dir(re::normalize(dir)) {
+  inline Ray::Ray(const re::vec3& origin, const re::vec3& dir, reFloat tMin, reFloat tMax) : _origin(origin), _dir(re::normalize(dir)), _tMin(tMin), _tMax(tMax) {
     // do nothing
   }
 
-  inline Ray::Ray(const re::Ray& ray) : _origin(ray._origin), _dir(ray._dir) {
+  inline Ray::Ray(const re::Ray& ray) : _origin(ray._origin), _dir(ray._dir), _tMin(ray._tMin), _tMax(ray._tMax) {
     // do nothing
   }
 
-  inline Ray::Ray(const re::Ray& ray, const re::Transform& transform) : _origin(transform.applyToPoint(ray._origin)), _dir(re::normalize(transform.applyToDir(ray._dir))) {
-    // do nothing
+  /**
+   * Creates a copy of the ray transformed by the given transform. The interval
+   * is scaled along with the direction, so that it covers the same points.
+   */
+
+  inline Ray::Ray(const re::Ray& ray, const re::Transform& transform) : _origin(transform.applyToPoint(ray._origin)), _dir(transform.applyToDir(ray._dir)), _tMin(ray._tMin), _tMax(ray._tMax) {
+    const reFloat scale = re::length(_dir);
+    _dir /= scale;
+    _tMin *= scale;
+    if (_tMax < RE_INFINITY) {
+      _tMax *= scale;
+    }
   }
 
   inline const re::vec3& Ray::origin() const {
@@ -49,6 +67,18 @@ namespace re {
     return _dir;
   }
 
+  inline reFloat Ray::tMin() const {
+    return _tMin;
+  }
+
+  inline reFloat Ray::tMax() const {
+    return _tMax;
+  }
+
+  inline const re::vec3 Ray::pointAt(reFloat t) const {
+    return _origin + _dir * t;
+  }
+
   inline void Ray::setOrigin(const re::vec3& origin) {
     _origin = origin;
   }
@@ -56,6 +86,11 @@ namespace re {
   inline void Ray::setDir(const re::vec3& dir) {
     _dir = re::normalize(dir);
   }
+
+  inline void Ray::setInterval(reFloat tMin, reFloat tMax) {
+    _tMin = tMin;
+    _tMax = tMax;
+  }
 }
 
 #endif
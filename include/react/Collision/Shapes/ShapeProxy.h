@@ -18,19 +18,19 @@ namespace re {
 
   class ShapeProxy : public reShape {
   public:
-    ShapeProxy(reShape* shape);
-    ShapeProxy(reShape* shape, const re::Transform& transform);
+    ShapeProxy(const reShape* shape);
+    ShapeProxy(const reShape* shape, const re::Transform& transform);
     ShapeProxy(const ShapeProxy&) = delete;
     ~ShapeProxy();
     
     ShapeProxy& operator=(const ShapeProxy&) = delete;
     
-    reShape* shape();
     const reShape* shape() const;
     void setShape(const reShape& base);
     ShapeProxy& withShape(const reShape& base);
     
     const re::Transform& transform() const;
+    const re::Transform& transformInv() const;
     void setTransform(const re::Transform& transform);
     ShapeProxy& withTransform(const re::Transform& transform);
     
@@ -53,11 +53,14 @@ namespace re {
 
   private:
     re::Transform _transform;
-    reShape* const _shape;
+    /** The cached inverse of the proxy transform */
+    re::Transform _transformInv;
+    const reShape* const _shape;
   };
 
   inline void ShapeProxy::setTransform(const re::Transform& transform) {
     _transform = transform;
+    _transformInv = re::inverse(transform);
   }
 
   inline ShapeProxy& ShapeProxy::withTransform(const re::Transform& transform) {
@@ -65,10 +68,6 @@ namespace re {
     return *this;
   }
 
-  inline reShape* ShapeProxy::shape() {
-    return _shape;
-  }
-
   inline const reShape* ShapeProxy::shape() const {
     return _shape;
   }
@@ -77,6 +76,17 @@ namespace re {
     return _transform;
   }
 
+  /**
+   * Returns the inverse of the proxy transform, which is only recomputed when
+   * the transform changes
+   * 
+   * @return The inverse of the proxy transform
+   */
+
+  inline const re::Transform& ShapeProxy::transformInv() const {
+    return _transformInv;
+  }
+
   inline reShape::Type ShapeProxy::type() const {
     return reShape::PROXY;
   }
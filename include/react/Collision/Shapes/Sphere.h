@@ -21,6 +21,8 @@ namespace re {
     Sphere(const Sphere& sphere);
     ~Sphere();
     
+    Sphere& operator=(const Sphere& sphere);
+    
     reFloat radius() const;
     Type type() const override;
     reUInt numVerts() const override;
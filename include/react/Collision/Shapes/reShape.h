@@ -37,7 +37,10 @@ public:
   };
   
   reShape();
+  reShape(const reShape& shape);
   virtual ~reShape();
+
+  reShape& operator=(const reShape& shape);
   
   // shape representation
   virtual Type type() const = 0;
@@ -57,8 +60,17 @@ public:
   bool containsPoint(const re::Transform& transform, const re::vec3& point) const;
   
   virtual bool containsPoint(const re::vec3& point) const = 0;
+  
+  // reference counting
+  void retain() const;
+  reUInt release() const;
+  reUInt references() const;
+  
 protected:
   reFloat _shell;
+  
+private:
+  mutable reUInt _references;
 };
 
 /**
@@ -106,9 +118,31 @@ protected:
  * @return True if the ray intersects
  */
 
-inline reShape::reShape() : _shell(RE_FP_TOLERANCE) { }
+inline reShape::reShape() : _shell(RE_FP_TOLERANCE), _references(0) { }
+
+/**
+ * Copies the shape's value. The reference count belongs to the original
+ * shape's owners, so the copy starts out unowned.
+ * 
+ * @param shape The shape to copy
+ */
+
+inline reShape::reShape(const reShape& shape) : _shell(shape._shell), _references(0) { }
 inline reShape::~reShape() { }
 
+/**
+ * Copies the shape's value. The reference count is kept, since it belongs to
+ * the owners of the shape assigned to rather than those of the original.
+ * 
+ * @param shape The shape to copy
+ * @return A reference to this shape
+ */
+
+inline reShape& reShape::operator=(const reShape& shape) {
+  _shell = shape._shell;
+  return *this;
+}
+
 /**
  * Returns the shell layer thickness used in collision detection
  * 
@@ -119,6 +153,41 @@ inline reFloat reShape::shell() const {
   return _shell;
 }
 
+/**
+ * Registers an additional owner of the shape. Shapes which are shared between
+ * entities are only destroyed once every owner has released them
+ * 
+ * @see re::ShapeCache
+ */
+
+inline void reShape::retain() const {
+  _references++;
+}
+
+/**
+ * Releases a reference to the shape. The count never drops below zero, so
+ * that shapes which were never retained are treated as having a single owner
+ * 
+ * @return The number of references remaining
+ */
+
+inline reUInt reShape::release() const {
+  if (_references > 0) {
+    _references--;
+  }
+  return _references;
+}
+
+/**
+ * Returns the number of owners currently sharing the shape
+ * 
+ * @return The reference count
+ */
+
+inline reUInt reShape::references() const {
+  return _references;
+}
+
 /**
  * Returns the offset required from the entity center of mass to reach 
  * the shape centroid
@@ -21,6 +21,8 @@ public:
   /** Destructor does nothing */
   ~reTriangle();
   
+  reTriangle& operator=(const reTriangle& other);
+  
   reTriangle& withVertex(reUInt i, const re::vec3& vert);
   
   // shape representation
@@ -55,7 +57,7 @@ inline reTriangle::reTriangle() : _verts() {
  * @param other The other reTriangle to copy
  */
 
-inline reTriangle::reTriangle(const reTriangle& other) : _verts() {
+inline reTriangle::reTriangle(const reTriangle& other) : reShape(other), _verts() {
   for (int i = 0; i < 3; i++) {
     _verts[i] = other._verts[i];
   }
@@ -79,6 +81,14 @@ inline reTriangle::~reTriangle() {
   // do nothing
 }
 
+inline reTriangle& reTriangle::operator=(const reTriangle& other) {
+  reShape::operator=(other);
+  for (int i = 0; i < 3; i++) {
+    _verts[i] = other._verts[i];
+  }
+  return *this;
+}
+
 inline reUInt reTriangle::numVerts() const {
   return 3;
 }
@@ -13,16 +13,30 @@ namespace re {
 
   class Ray;
   class Plane;
-  class Segment;
+  struct Segment;
   class Intersect;
 
   bool intersects(const reShape& shape, const re::Transform& transform, const re::Ray& ray, Intersect& intersect);
 
+  bool intersects(const reShape& shape, const re::Transform& transform, const re::Transform& inverse, const re::Ray& ray, Intersect& intersect);
+
+  bool intersects(const reShape& shape, const re::RigidTransform& transform, const re::Ray& ray, Intersect& intersect);
+
+  bool occludes(const reShape& shape, const re::Transform& inverse, const re::Ray& ray, reFloat maxDist);
+
   Location relativeToPlane(const reShape& shape, const re::Plane& plane);
 
   Location relativeToPlane(const reShape& shape, const re::Transform& transform, const re::Plane& plane);
 
+  Location relativeToPlane(const reShape& shape, const re::Transform& transform, const re::Transform& inverse, const re::Plane& plane);
+
+  Location relativeToPlane(const reShape& shape, const re::RigidTransform& transform, const re::Plane& plane);
+
   bool intersects(const reShape& A, const re::Transform& tA, const reShape& B, const re::Transform& tB, Intersect& intersect);
+
+  void boundingSphere(const reShape& shape, const re::Transform& transform, re::vec3& center, reFloat& radius);
+
+  bool sweep(const reShape& shape, const re::Transform& transform, const re::vec3& motion, const reShape& target, const re::Transform& targetTransform, reFloat maxTime, reFloat& time, Intersect& intersect);
 }
 
 #endif
@@ -7,11 +7,12 @@
 
 #include "react/math.h"
 #include "react/Collision/Shapes/Plane.h"
-#include "react/Utilities/reLinkedList.h"
 
 class reBSPNode;
 
 namespace re {
+  class Entity;
+
   class Strategy {
   public:
     Strategy();
@@ -19,7 +20,7 @@ namespace re {
     bool shouldMerge(const reBSPNode& node);
     bool shouldSplit(const reBSPNode& node);
     
-    Plane computeSplitPlane(const re::vec3& axis, const reLinkedList<Entity*>& sample);
+    Plane computeSplitPlane(const re::vec3& axis, Entity* const* sample, reUInt n);
   };
 
   inline Strategy::Strategy() {
@@ -7,6 +7,7 @@
 
 #include "react/Collision/reBroadPhase.h"
 #include "react/Collision/reAABB.h"
+#include "react/Collision/RayPacket.h"
 
 class reBSPNode;
 class reBSPTree;
@@ -22,11 +23,15 @@ class reBSPNode {
 public:
   
   struct Marker {
-    Marker(re::Entity& e) : entity(e), node(nullptr), queryID(0) { }
+    Marker(re::Entity& e) : entity(e), node(nullptr), queryID(0), index(0), nodeIndex(0) { }
     
     re::Entity& entity;
     reBSPNode* node;
     reUInt queryID;
+    /** The index of the marker in the tree's list of all markers */
+    reUInt index;
+    /** The index of the marker in its node's list of markers */
+    reUInt nodeIndex;
   };
   
   reBSPNode(reAllocator& allocator, reUInt depth);
@@ -54,18 +59,31 @@ public:
   void split(re::Strategy& strategy);
   void merge();
   
-  const reLinkedList<re::Entity*> sample(reUInt size) const;
+  reUInt sample(re::Entity** results, reUInt num) const;
+  
+  reUInt writeLayout(reBPSplit* splits, reUInt capacity, reUInt count) const;
+  const reBPSplit* readLayout(const reBPSplit* split, const reBPSplit* end);
   
   // spatial queries
   void queryWithRay(const re::Ray& ray, re::RayQuery& result) const;
+  void queryWithPacket(re::RayPacket& packet, reUInt mask) const;
+  bool queryOcclusion(const re::Ray& ray, reFloat maxDist) const;
 
   reBSPNode* place(Marker& marker);
   
 protected:
+  void queryWithRay(const re::Ray& ray, reFloat tNear, reFloat tFar, re::RayQuery& result) const;
+  bool queryOcclusion(const re::Ray& ray, reFloat tNear, reFloat tFar) const;
+  template <class Region>
+  reUInt queryRegion(const Region& region, re::Entity** results, reUInt capacity, reUInt found) const;
+  void queryNearest(const re::vec3& point, reFloat bound, re::SingleResult* results, reUInt k, reUInt& found) const;
+  reUInt queryWithinRadius(const re::vec3& point, reFloat radiusSq, re::SingleResult* results, reUInt capacity, reUInt found) const;
+  void querySweep(const reShape& shape, const re::Transform& transform, const re::vec3& motion, const re::vec3& center, reFloat radius, const re::Entity* ignore, re::SweepQuery& result) const;
+
   /** The allocator object used for allocating memory */
   reAllocator& _allocator;
   /** The list of entities contained in this structure */
-  reLinkedList<Marker*> _markers;
+  reDenseArray<Marker*> _markers;
   /** The direct descendents of this node */
   reBSPNode* _children[2];
   /** The split plane of the node */
@@ -83,34 +101,51 @@ protected:
 class reBSPTree : public reBroadPhase, public reBSPNode {
 public:
   reBSPTree(reAllocator& allocator);
+  reBSPTree(reAllocator& allocator, reAllocator& contacts);
   ~reBSPTree();
   
   void clear() override;
   bool add(re::Entity& ent) override;
+  reUInt add(re::Entity* const* entities, reUInt n) override;
   bool remove(re::Entity& ent) override;
   bool contains(const re::Entity& ent) const override;
   reUInt size() const override;
   void rebalance(re::Strategy* strategy = nullptr) override;
-  void advance(re::Integrator& integrator, reFloat dt) override;
+  void advance(re::Integrator& integrator, reFloat dt, reAllocator& scratch) override;
+  
+  reUInt layout(reBPSplit* splits, reUInt capacity) const override;
+  bool setLayout(const reBPSplit* splits, reUInt n) override;
   
   void addInteraction(reInteraction& action, re::Entity& A, re::Entity& B) override;
+  re::ContactGraph& contacts() override;
   
-  const reLinkedList<re::Entity*>& entities() const override;
+  const reDenseArray<re::Entity*>& entities() const override;
   
   // spatial queries
   re::RayQuery queryWithRay(const re::Ray& ray) const override;
+  void queryWithRays(const re::Ray* rays, re::RayQuery* results, reUInt n) const override;
+  bool queryOcclusion(const re::Ray& ray, reFloat maxDist = RE_INFINITY) const override;
+  reUInt queryWithAABB(const reAABB& aabb, const re::vec3& center, re::Entity** results, reUInt capacity) const override;
+  reUInt queryWithSphere(const re::vec3& center, reFloat radius, re::Entity** results, reUInt capacity) const override;
+  reUInt queryWithShape(const reShape& shape, const re::Transform& transform, re::Entity** results, reUInt capacity) const override;
+  reUInt queryWithFrustum(const re::Frustum& frustum, re::Entity** results, reUInt capacity) const override;
+  reUInt queryNearest(const re::vec3& point, re::SingleResult* results, reUInt k) const override;
+  reUInt queryWithinRadius(const re::vec3& point, reFloat radius, re::SingleResult* results, reUInt capacity) const override;
+  bool querySweep(const reShape& shape, const re::Segment& path, re::SweepQuery& result, const re::quat& orientation = re::quat()) const override;
   
   // measurement
   reBPMeasure measure() const override;
   
 protected:
+  void advanceContinuous(re::Integrator& integrator, re::Entity& entity, reFloat dt);
   
   /** The structure maintaining collision interactions between entities */
   re::ContactGraph _contacts;
   /** The strategy used to balance the tree */
   re::Strategy _strategy;
-  reLinkedList<Marker*> _allMarkers;
-  reLinkedList<re::Entity*> _masterEntityList;
+  /** All markers, with the same index as their entity in the master list */
+  reDenseArray<Marker*> _allMarkers;
+  reDenseArray<re::Entity*> _masterEntityList;
 };
 
 inline const reBSPNode& reBSPNode::child(reUInt i) const {
@@ -141,7 +176,11 @@ inline reUInt reBSPNode::placements() const {
   return _markers.size();
 }
 
-inline const reLinkedList<re::Entity*>& reBSPTree::entities() const {
+inline re::ContactGraph& reBSPTree::contacts() {
+  return _contacts;
+}
+
+inline const reDenseArray<re::Entity*>& reBSPTree::entities() const {
   return _masterEntityList;
 }
 
@@ -155,6 +194,10 @@ inline re::RayQuery reBSPTree::queryWithRay(const re::Ray& ray) const {
   return result;
 }
 
+inline bool reBSPTree::queryOcclusion(const re::Ray& ray, reFloat maxDist) const {
+  return reBSPNode::queryOcclusion(ray, maxDist);
+}
+
 inline reBPMeasure reBSPTree::measure() const {
   reBPMeasure m;
   m.entities = _masterEntityList.size();
@@ -10,17 +10,27 @@
 #include "react/Dynamics/ContactGraph.h"
 #include "react/Collision/reSpatialQueries.h"
 #include "react/Collision/Strategy.h"
+#include "react/Collision/reAABB.h"
+#include "react/Utilities/reDenseArray.h"
 
 namespace re {
   class Entity;
+  class Frustum;
+  struct Segment;
 }
+class reShape;
 class reBPMeasure;
+struct reBPSplit;
 
 /**
  * @ingroup collision
  * An abstract class which describes the interface for a broad phase collision
  * detection system. It represents a structure used to accelerate spatial
- * queries to all entities contained within.
+ * queries to all entities contained within. Region queries write the entities
+ * found to a buffer supplied by the caller and never allocate. The spatial
+ * queries and contains only read from the structure, so they may be called
+ * from multiple threads at once, provided the structure is not modified or
+ * advanced meanwhile.
  */
 
 class reBroadPhase {
@@ -32,18 +42,32 @@ public:
 
   virtual void clear() = 0;
   virtual bool add(re::Entity& ent) = 0;
+  virtual reUInt add(re::Entity* const* entities, reUInt n) = 0;
   virtual bool remove(re::Entity& ent) = 0;
   virtual bool contains(const re::Entity& ent) const = 0;
   virtual reUInt size() const = 0;
   virtual void rebalance(re::Strategy* strategy = nullptr) = 0;
-  virtual void advance(re::Integrator& integrator, reFloat dt) = 0;
+  virtual void advance(re::Integrator& integrator, reFloat dt, reAllocator& scratch) = 0;
+  
+  virtual reUInt layout(reBPSplit* splits, reUInt capacity) const = 0;
+  virtual bool setLayout(const reBPSplit* splits, reUInt n) = 0;
   
   virtual void addInteraction(reInteraction& action, re::Entity& A, re::Entity& B) = 0;
+  virtual re::ContactGraph& contacts() = 0;
   
-  virtual const reLinkedList<re::Entity*>& entities() const = 0;
+  virtual const reDenseArray<re::Entity*>& entities() const = 0;
   
   // spatial queries
   virtual re::RayQuery queryWithRay(const re::Ray& ray) const = 0;
+  virtual void queryWithRays(const re::Ray* rays, re::RayQuery* results, reUInt n) const = 0;
+  virtual bool queryOcclusion(const re::Ray& ray, reFloat maxDist = RE_INFINITY) const = 0;
+  virtual reUInt queryWithAABB(const reAABB& aabb, const re::vec3& center, re::Entity** results, reUInt capacity) const = 0;
+  virtual reUInt queryWithSphere(const re::vec3& center, reFloat radius, re::Entity** results, reUInt capacity) const = 0;
+  virtual reUInt queryWithShape(const reShape& shape, const re::Transform& transform, re::Entity** results, reUInt capacity) const = 0;
+  virtual reUInt queryWithFrustum(const re::Frustum& frustum, re::Entity** results, reUInt capacity) const = 0;
+  virtual reUInt queryNearest(const re::vec3& point, re::SingleResult* results, reUInt k) const = 0;
+  virtual reUInt queryWithinRadius(const re::vec3& point, reFloat radius, re::SingleResult* results, reUInt capacity) const = 0;
+  virtual bool querySweep(const reShape& shape, const re::Segment& path, re::SweepQuery& result, const re::quat& orientation = re::quat()) const = 0;
   
   // measurement functions
   virtual reBPMeasure measure() const = 0;
@@ -68,6 +92,28 @@ struct reBPMeasure {
   reFloat meanLeafDepth;
 };
 
+/**
+ * @ingroup collision
+ * A single node of the broad phase structure, used to save and restore the
+ * layout of the structure. Nodes are listed in depth first order, each node
+ * followed by its children. The layout is stored as plain numbers so that it
+ * can be read directly from a snapshot.
+ */
+
+struct reBPSplit {
+  /** The normal of the node's split plane */
+  reFloat normal[3];
+  /** The offset of the node's split plane from the origin */
+  reFloat offset;
+  /** One if the node has children, zero otherwise */
+  reUInt children;
+  /** Keeps the size a multiple of the float size */
+  reUInt padding;
+  
+  /** The deepest node a layout may contain, which bounds reading it back */
+  static const reUInt MAX_DEPTH = 64;
+};
+
 inline reBroadPhase::reBroadPhase() {
   // do nothing
 }
@@ -96,6 +142,39 @@ inline reBroadPhase::~reBroadPhase() {
  * @return True if the operation was successful
  */
 
+/**
+ * @fn reUInt reBroadPhase::add(re::Entity* const* entities, reUInt n)
+ * Adds many re::Entity objects into the structure at once. A structure which
+ * has not been subdivided yet is built once all of them are in place, while
+ * an existing subdivision is kept as it is, so rebalance() should be called
+ * after adding many entities to it. Entities which are already in the structure, or
+ * repeated in the array, are skipped.
+ * 
+ * @param entities The re::Entity objects to add
+ * @param n The number of entities
+ * @return The number of entities added
+ */
+
+/**
+ * @fn reUInt reBroadPhase::layout(reBPSplit* splits, reUInt capacity) const
+ * Writes the layout of the structure, without the entities it contains. At
+ * most capacity nodes are written, but all are counted.
+ * 
+ * @param splits The buffer the nodes are written to
+ * @param capacity The number of nodes the buffer can hold
+ * @return The number of nodes in the structure
+ */
+
+/**
+ * @fn bool reBroadPhase::setLayout(const reBPSplit* splits, reUInt n)
+ * Replaces the layout of the structure with one written by
+ * reBroadPhase::layout, placing the contained entities into the new layout
+ * 
+ * @param splits The nodes of the layout
+ * @param n The number of nodes
+ * @return False if the nodes do not describe a complete layout
+ */
+
 /**
  * @fn void reBroadPhase::remove(re::Entity* ent)
  * Removes the re::Entity from the broad phase
@@ -112,12 +191,22 @@ inline reBroadPhase::~reBroadPhase() {
  */
 
 /**
- * @fn void reBroadPhase::advance(reIntegrator& integrator, reFloat dt)
+ * @fn void reBroadPhase::advance(reIntegrator& integrator, reFloat dt, reAllocator& scratch)
  * Advances the entities forward in time and also resolves all collisions
  * in the process
  * 
  * @param integrator The desired integrator to use
  * @param dt The time step to advance, in user-defined units
+ * @param scratch The allocator for temporary data used within the time step,
+ * which must remain valid until the step completes
+ */
+
+/**
+ * @fn re::ContactGraph& reBroadPhase::contacts()
+ * Returns the contact graph used to resolve collisions between the entities,
+ * which can be used to configure the contact solver
+ * 
+ * @return The contact graph
  */
 
 /**
@@ -130,6 +219,129 @@ inline reBroadPhase::~reBroadPhase() {
  * @return The re::Entity which was found
  */
 
+/**
+ * @fn void reBroadPhase::queryWithRays(const re::Ray* rays,
+ * re::RayQuery* results, reUInt n) const
+ * Performs a spatial query for each ray in the array, writing the closest
+ * intersection for each ray to the corresponding element of the results.
+ * Coherent rays, such as those sharing an origin, are answered considerably
+ * faster than with individual queries.
+ * 
+ * @param rays The array of rays
+ * @param results The array of results, with one element for each ray
+ * @param n The number of rays
+ */
+
+/**
+ * @fn bool reBroadPhase::queryOcclusion(const re::Ray& ray,
+ * reFloat maxDist) const
+ * Returns true if any entity blocks the ray before the maximum distance. The
+ * query stops at the first blocking entity found, which need not be the
+ * closest, and no intersection point or normal is computed. It is intended
+ * for shadow and line of sight tests.
+ * 
+ * @param ray The ray to test with
+ * @param maxDist The distance along the ray beyond which entities are ignored
+ * @return True if the ray is blocked
+ */
+
+/**
+ * @fn reUInt reBroadPhase::queryWithAABB(const reAABB& aabb,
+ * const re::vec3& center, re::Entity** results, reUInt capacity) const
+ * Finds all entities overlapping the axis aligned box. Entities are tested
+ * against each face of the box, so the results may include entities close to
+ * its edges and corners which do not overlap it.
+ * 
+ * @param aabb The box dimensions
+ * @param center The center of the box
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @return The number of entities found, which may exceed the capacity
+ */
+
+/**
+ * @fn reUInt reBroadPhase::queryWithSphere(const re::vec3& center,
+ * reFloat radius, re::Entity** results, reUInt capacity) const
+ * Finds all entities overlapping the sphere
+ * 
+ * @param center The center of the sphere
+ * @param radius The radius of the sphere
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @return The number of entities found, which may exceed the capacity
+ */
+
+/**
+ * @fn reUInt reBroadPhase::queryWithShape(const reShape& shape,
+ * const re::Transform& transform, re::Entity** results, reUInt capacity) const
+ * Finds all entities overlapping the transformed convex shape. Each entity is
+ * tested with re::intersects, except for pairs of triangles, which are only
+ * compared by their bounding spheres and so may include nearby triangles.
+ * 
+ * @param shape The shape to test with
+ * @param transform The transform of the shape
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @return The number of entities found, which may exceed the capacity
+ */
+
+/**
+ * @fn reUInt reBroadPhase::queryWithFrustum(const re::Frustum& frustum,
+ * re::Entity** results, reUInt capacity) const
+ * Finds all entities which may be visible within the frustum. As with
+ * queryWithAABB, entities near the edges of the frustum may be included.
+ * 
+ * @param frustum The view frustum
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @return The number of entities found, which may exceed the capacity
+ */
+
+/**
+ * @fn reUInt reBroadPhase::queryNearest(const re::vec3& point,
+ * re::SingleResult* results, reUInt k) const
+ * Finds the k entities with centers closest to the point. The results are
+ * sorted from nearest to furthest, and hold the squared distance to each
+ * entity's center.
+ * 
+ * @param point The point to search around
+ * @param results The buffer the results are written to, holding at least k
+ * @param k The number of entities to find
+ * @return The number of entities found, which is less than k only if the
+ * structure holds fewer entities
+ */
+
+/**
+ * @fn reUInt reBroadPhase::queryWithinRadius(const re::vec3& point,
+ * reFloat radius, re::SingleResult* results, reUInt capacity) const
+ * Finds all entities with centers within the radius of the point, in no
+ * particular order
+ * 
+ * @param point The point to search around
+ * @param radius The search radius
+ * @param results The buffer the results are written to
+ * @param capacity The number of results the buffer can hold
+ * @return The number of entities found, which may exceed the capacity
+ */
+
+/**
+ * @fn bool reBroadPhase::querySweep(const reShape& shape,
+ * const re::Segment& path, re::SweepQuery& result,
+ * const re::quat& orientation) const
+ * Moves the shape in a straight line along the path and finds the first
+ * entity it touches. The shape keeps the given orientation throughout, and
+ * its origin travels from the start to the end of the path. Pairs of shapes
+ * which re::sweep does not support, such as two triangles, are never hit.
+ * Entities which the shape initially overlaps only count as hits if the path
+ * leads further into them.
+ * 
+ * @param shape The shape to sweep
+ * @param path The path travelled by the shape's origin
+ * @param result The first impact found, which is left unchanged on a miss
+ * @param orientation The orientation of the shape
+ * @return True if the shape touches an entity along the path
+ */
+
 /**
  * @fn reBPMeasure reBroadPhase::measure()
  * Stores usage data related to the structures and returns it
@@ -20,17 +20,22 @@ namespace re {
 
   struct RayQuery : public Intersect {
     RayQuery() : Intersect(), entity(nullptr) { }
-    RayQuery& operator=(const RayQuery& q) {
-      depth = q.depth;
-      point = q.point;
-      normal = q.normal;
-      entity = q.entity;
-      return *this;
-    }
     Entity* entity;
   };
 
-  extern reUInt globalQueryID;  // defined in common.h
+  /**
+   * The result of sweeping a shape along a segment. The depth holds the
+   * distance travelled before the impact, and the normal faces from the
+   * entity hit towards the swept shape.
+   */
+
+  struct SweepQuery : public RayQuery {
+    SweepQuery() : RayQuery(), time(1.0) { }
+    /** The fraction of the segment travelled before the impact */
+    reFloat time;
+  };
+
+  reUInt nextQueryID();  // defined in common.cpp
 };
 
 /**
@@ -41,10 +46,7 @@ struct reSpatialQuery {
   /** A unique query ID to avoid redundant queries */
   const reUInt ID;
 protected:
-  // ensures the ID is never zero
-  reSpatialQuery() : ID(
-    (++re::globalQueryID == 0) ? ++re::globalQueryID : re::globalQueryID
-  ) { }
+  reSpatialQuery() : ID(re::nextQueryID()) { }
 };
 
 /**
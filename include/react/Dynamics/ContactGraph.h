@@ -7,26 +7,44 @@
 #define RE_COLLISION_GRAPH_H
 
 #include "react/Entities/Entity.h"
-#include "react/Utilities/reLinkedList.h"
+#include "react/Utilities/reDenseArray.h"
+#include "react/Utilities/reSmallVector.h"
 #include "react/Dynamics/reInteraction.h"
+#include "react/Dynamics/ContactManifold.h"
+#include "react/Dynamics/ContactLanes.h"
 #include "react/Utilities/ContactFilter.h"
 
 namespace re {
+  class ThreadPool;
+
   /**
    * @ingroup dynamics
-   * Represents the contact interaction between two entities
+   * Represents the contact interaction between two entities. The most recent
+   * narrow phase result is stored in the re::Intersect base, while the
+   * manifold accumulates contact points over successive time steps.
    */
 
   struct ContactEdge : public re::Intersect {
     ContactEdge(reAllocator& allocator, Entity& a, Entity& b);
     
     void check();
+    void prepare(reFloat dt);
+    void warmStart();
+    void solve();
     
     Entity& A;
     Entity& B;
     bool contact;
     reUInt timeLimit;
-    reLinkedList<reInteraction*> interactions;
+    reSmallVector<reInteraction*, 2> interactions;
+    /** The persistent contact points between the two entities */
+    re::ContactManifold manifold;
+    /** The combined friction coefficient, set before solving */
+    reFloat friction;
+    /** The world space inverse inertia of A, set before solving */
+    re::mat3 inertiaInvA;
+    /** The world space inverse inertia of B, set before solving */
+    re::mat3 inertiaInvB;
   };
 
   /**
@@ -39,17 +57,83 @@ namespace re {
     ContactGraph(reAllocator& allocator);
     ~ContactGraph();
     
-    void solve();
+    void solve(reFloat dt, reAllocator& scratch);
     void check(Entity& entA, Entity& entB);
     void advance();
     
     void addInteraction(reInteraction& action, Entity& A, Entity& B);
+    void clear();
+    
+    const reDenseArray<ContactEdge*>& edges() const;
+    reUInt iterations() const;
+    void setIterations(reUInt iterations);
+    reUInt threads() const;
+    void setThreads(reUInt threads);
     
   private:
+    void color(reAllocator& scratch);
+    void solveColored();
+
     reAllocator& _allocator;
-    reLinkedList<ContactEdge*> _edges;
+    /** The number of solver passes over the contacts in each time step */
+    reUInt _iterations;
+    /** The number of threads used by the colored solver */
+    reUInt _threads;
+    /** The threads used by the colored solver, null for the serial solver */
+    re::ThreadPool* _pool;
+    /** The lanes of all colored batches, ordered by color */
+    reDenseArray<re::ContactLanes> _lanes;
+    /** The end of each color's lanes in ContactGraph::_lanes */
+    reDenseArray<reUInt> _colorEnds;
+    /** The contacts which could not be colored, solved serially */
+    reDenseArray<ContactEdge*> _uncolored;
+    reDenseArray<ContactEdge*> _edges;
     re::ContactFilter _filter;
   };
+
+  /**
+   * Returns every pair of entities in contact or bound by interactions
+   * 
+   * @return The edges of the contact graph
+   */
+
+  inline const reDenseArray<ContactEdge*>& ContactGraph::edges() const {
+    return _edges;
+  }
+
+  /**
+   * Returns the number of solver passes made over all contacts in each time
+   * step
+   * 
+   * @return The number of solver iterations
+   */
+
+  inline reUInt ContactGraph::iterations() const {
+    return _iterations;
+  }
+
+  /**
+   * Sets the number of solver passes made over all contacts in each time
+   * step. More iterations improve the accuracy of stacked contacts, at a
+   * proportional cost.
+   * 
+   * @param iterations The number of solver iterations
+   */
+
+  inline void ContactGraph::setIterations(reUInt iterations) {
+    _iterations = iterations;
+  }
+
+  /**
+   * Returns the number of threads used by the colored solver, or 0 if the
+   * contacts are solved serially
+   * 
+   * @return The number of solver threads
+   */
+
+  inline reUInt ContactGraph::threads() const {
+    return _threads;
+  }
 }
 
 #endif
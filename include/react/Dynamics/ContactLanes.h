@@ -0,0 +1,70 @@
+/**
+ * @file
+ * Contains the definition of the re::ContactLanes struct
+ */
+#ifndef RE_CONTACT_LANES_H
+#define RE_CONTACT_LANES_H
+
+#include "react/Dynamics/ContactManifold.h"
+
+namespace re {
+  struct ContactEdge;
+
+  /**
+   * @ingroup dynamics
+   * A single constraint row for each lane of a re::ContactLanes, stored in a
+   * structure of arrays layout
+   */
+
+  struct LaneRow {
+    static const reUInt WIDTH = 4;
+
+    /** The direction of the constraint */
+    reFloat dx[WIDTH], dy[WIDTH], dz[WIDTH];
+    /** The lever arm of A crossed with the direction */
+    reFloat ax[WIDTH], ay[WIDTH], az[WIDTH];
+    /** The lever arm of B crossed with the direction */
+    reFloat bx[WIDTH], by[WIDTH], bz[WIDTH];
+    /** The angular velocity change of A for a unit impulse */
+    reFloat iax[WIDTH], iay[WIDTH], iaz[WIDTH];
+    /** The angular velocity change of B for a unit impulse */
+    reFloat ibx[WIDTH], iby[WIDTH], ibz[WIDTH];
+    /** The effective mass along the direction, zero for unused lanes */
+    reFloat mass[WIDTH];
+  };
+
+  /**
+   * @ingroup dynamics
+   * Up to four contact edges packed side by side, so that the solver can
+   * process one contact point from each edge at once. The edges must not
+   * share any dynamic entity, as the velocities of all entities are gathered
+   * before solving and written back afterwards. Static entities may be
+   * shared, since their velocities are never written.
+   */
+
+  struct ContactLanes {
+    static const reUInt WIDTH = LaneRow::WIDTH;
+
+    void pack(ContactEdge* const* edges, reUInt n);
+    void solve();
+
+    /** The packed edges */
+    ContactEdge* edges[WIDTH];
+    /** The number of packed edges */
+    reUInt size;
+    /** The largest number of contact points in any packed edge */
+    reUInt points;
+    /** The inverse masses of the entities in each lane */
+    reFloat massInvA[WIDTH], massInvB[WIDTH];
+    /** The friction coefficient of each lane */
+    reFloat friction[WIDTH];
+    /** The tangent and normal rows for each contact point */
+    LaneRow rows[ContactManifold::MAX_POINTS][3];
+    /** The target normal velocity for each contact point */
+    reFloat bias[ContactManifold::MAX_POINTS][WIDTH];
+    /** The accumulated impulses of each row */
+    reFloat impulses[ContactManifold::MAX_POINTS][3][WIDTH];
+  };
+}
+
+#endif
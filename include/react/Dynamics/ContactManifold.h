@@ -0,0 +1,93 @@
+/**
+ * @file
+ * Contains the definition of the re::ContactPoint and re::ContactManifold
+ * structs
+ */
+#ifndef RE_CONTACT_MANIFOLD_H
+#define RE_CONTACT_MANIFOLD_H
+
+#include "react/Entities/Entity.h"
+
+namespace re {
+
+  /**
+   * @ingroup dynamics
+   * A single point of contact between two entities. The point is anchored to
+   * both entities, so that it can be tracked as they move, and it remembers
+   * the impulses applied at the point over previous time steps.
+   */
+
+  struct ContactPoint {
+    ContactPoint();
+
+    /** The contact point in the body space of entity A */
+    re::vec3 localA;
+    /** The contact point in the body space of entity B */
+    re::vec3 localB;
+    /** The contact point in world space */
+    re::vec3 point;
+    /** The penetration depth along the manifold normal */
+    reFloat depth;
+    /** The accumulated impulse along the manifold normal */
+    reFloat normalImpulse;
+    /** The accumulated impulses along each of the manifold tangents */
+    reFloat tangentImpulse[2];
+
+    /** The offset of the point from the center of A, set before solving */
+    re::vec3 rA;
+    /** The offset of the point from the center of B, set before solving */
+    re::vec3 rB;
+    /** The effective mass along the normal, set before solving */
+    reFloat normalMass;
+    /** The effective mass along each tangent, set before solving */
+    reFloat tangentMass[2];
+    /** The target separating velocity, set before solving */
+    reFloat bias;
+  };
+
+  /**
+   * @ingroup dynamics
+   * A set of contact points between two entities which persists over time
+   * steps. Points reported by the narrow phase are merged with the existing
+   * points, so that the impulses accumulated in previous steps can be used to
+   * warm start the solver. All points share the manifold normal, which points
+   * from entity B towards entity A.
+   */
+
+  struct ContactManifold {
+    static const reUInt MAX_POINTS = 4;
+
+    ContactManifold();
+
+    void refresh(const re::Entity& A, const re::Entity& B);
+    void add(const re::Entity& A, const re::Entity& B, const re::Intersect& intersect);
+    void clear();
+
+    /** The contact normal, pointing from entity B towards entity A */
+    re::vec3 normal;
+    /** Two directions perpendicular to the normal and to each other */
+    re::vec3 tangents[2];
+    /** The contact points, only the first ContactManifold::size are valid */
+    ContactPoint points[MAX_POINTS];
+    /** The number of contact points in the manifold */
+    reUInt size;
+  };
+
+  inline ContactPoint::ContactPoint() : localA(), localB(), point(), depth(0.0), normalImpulse(0.0), tangentImpulse{0.0, 0.0}, rA(), rB(), normalMass(0.0), tangentMass{0.0, 0.0}, bias(0.0) {
+    // do nothing
+  }
+
+  inline ContactManifold::ContactManifold() : normal(), tangents(), points(), size(0) {
+    // do nothing
+  }
+
+  /**
+   * Removes all points from the manifold, discarding the accumulated impulses
+   */
+
+  inline void ContactManifold::clear() {
+    size = 0;
+  }
+}
+
+#endif
@@ -15,6 +15,7 @@
 
 class reGravAction : public reInteraction {
 public:
+  Type type() const override;
   void solve(re::Entity& A, re::Entity& B) override;
 };
 
@@ -22,6 +23,10 @@ namespace {
   const reFloat G = 0.0001;
 }
 
+inline reInteraction::Type reGravAction::type() const {
+  return GRAVITY;
+}
+
 inline void reGravAction::solve(re::Entity& A, re::Entity& B) {
   const re::vec3 diff = A.center() - B.center();
   const re::vec3 f = (G*A.mass()*B.mass() / re::lengthSq(diff)) * re::normalize(diff);
@@ -9,9 +9,22 @@
 
 class reInteraction {
 public:
+  /** Defines the built in interactions, which can be saved in snapshots */
+  enum Type {
+    /** Gravitational attraction @see reGravAction */
+    GRAVITY,
+    /** An interaction defined by the user, which is not saved */
+    CUSTOM
+  };
+  
   virtual ~reInteraction() { }
   
+  virtual Type type() const;
   virtual void solve(re::Entity& A, re::Entity& B) = 0;
 };
 
+inline reInteraction::Type reInteraction::type() const {
+  return CUSTOM;
+}
+
 #endif
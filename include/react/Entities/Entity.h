@@ -8,7 +8,11 @@
 #include "react/math.h"
 #include "react/Math/Integrator.h"
 #include "react/Collision/Shapes/reShape.h"
+#include "react/Collision/Shapes/ShapeProxy.h"
 #include "react/Collision/reSpatialQueries.h"
+#include "react/Entities/EntityHandle.h"
+
+class reBSPTree;
 
 namespace re {
   class Plane;
@@ -41,7 +45,7 @@ namespace re {
     /** Disable default constructor */
     Entity() = delete;
     /** Creates an entity from a parent reWorld object */
-    Entity(reShape& shape);
+    Entity(const reShape& shape, const re::RigidTransform& offset = re::RigidTransform());
     /** Default destructor does nothing */
     virtual ~Entity();
 
@@ -51,14 +55,16 @@ namespace re {
  
     virtual Type type() const = 0;
     re::ID id() const;
+    re::EntityHandle handle() const;
 
     //=====================================================
     //    PHYSICAL GEOMETRY
     //=====================================================
 
     // getters
-    reShape& shape();
     const reShape& shape() const;
+    const reShape& baseShape() const;
+    const re::RigidTransform& shapeOffset() const;
 
     //=====================================================
     //    PHYSICAL STATE
@@ -71,6 +77,9 @@ namespace re {
     virtual const re::vec3& vel() const = 0;
     virtual const re::vec3& angVel() const = 0;
     const re::Transform transform() const;
+    const re::RigidTransform rigidTransform() const;
+    const re::Transform& shapeTransform() const;
+    const re::Transform& shapeTransformInv() const;
     const re::vec3 center() const;
 
     // setters
@@ -80,11 +89,20 @@ namespace re {
     virtual void setVel(reFloat x, reFloat y, reFloat z) = 0;
     virtual void setAngVel(const re::vec3&) = 0;
     virtual void setAngVel(reFloat, reFloat, reFloat) = 0; 
+    virtual void setOrient(const re::quat& orient) = 0;
     virtual void setFacing(const re::vec3& dir, const re::vec3& up = re::vec3(0.0, 0.0, 1.0)) = 0; 
 
     // operations
     virtual void advance(re::Integrator& integrator, reFloat dt) = 0;
     virtual void addImpulse(const re::vec3& impulse) = 0;
+    void updateTransform();
+
+    //=====================================================
+    //    COLLISION SETTINGS
+    //=====================================================
+
+    bool isContinuous() const;
+    void setContinuous(bool continuous);
 
     //=====================================================
     //    PHYSICAL PROPERTIES
@@ -122,31 +140,58 @@ namespace re {
     virtual Entity& withRestitution(reFloat restitution) = 0;
     virtual Entity& withFriction(reFloat friction) = 0;
     virtual Entity& withResistance(reFloat resistance) = 0;
+    virtual Entity& withContinuousCollision() = 0;
 
     //=====================================================
     //    COLLISION QUERIES
     //=====================================================
 
     bool intersects(const re::Ray& ray, re::Intersect& intersect) const;
+    bool occludes(const re::Ray& ray, reFloat maxDist) const;
     re::Location relativeToPlane(const re::Plane& plane);
 
     /** a pointer to arbitrary data, defined by the user */
     void* userdata;
 
   protected:
+    void updateTransform(const re::RigidTransform& transform);
+
     /** A unique identifier for the re::Entity */
     const re::ID _id;
-    /** The entity's reShape */
-    reShape& _shape;
+    /** The entity's reShape, which may be shared with other entities */
+    const reShape& _shape;
     /** The entity's position vector */
     re::vec3 _pos;
+    /** True if the entity is swept along its path to prevent tunneling */
+    bool _continuous;
 
   private:
+    /** The innermost shape, with all proxies flattened into _shapeTransform */
+    const reShape* _base;
+    /** The placement of the shape relative to the entity */
+    re::RigidTransform _shapeOffset;
+    /** The cached transform from the base shape's space to world space */
+    re::Transform _shapeTransform;
+    /** The cached transform from world space to the base shape's space */
+    re::Transform _shapeTransformInv;
+
+    /** The handle issued by the re::EntityRegistry, null if unregistered */
+    re::EntityHandle _handle;
+    /** The index of the entity in the one reBSPTree which may contain it */
+    reUInt _treeIndex;
+
     static re::ID globalEntID;
+
+    friend class EntityRegistry;
+    friend class ::reBSPTree;
   };
 
-  inline Entity::Entity(reShape& shape) : userdata(nullptr), _id(globalEntID++), _shape(shape), _pos() {
-    // do nothing
+  inline Entity::Entity(const reShape& shape, const re::RigidTransform& offset) : userdata(nullptr), _id(globalEntID++), _shape(shape), _pos(), _continuous(false), _base(&shape), _shapeOffset(offset), _shapeTransform(), _shapeTransformInv(), _handle(), _treeIndex(0) {
+    while (_base->type() == reShape::PROXY) {
+      _base = ((const re::ShapeProxy*)_base)->shape();
+    }
+    // entities are always created at the origin with no rotation
+    updateTransform(re::RigidTransform());
   }
 
   inline Entity::~Entity() {
@@ -154,23 +199,39 @@ namespace re {
   }
 
   /**
-   * Returns the reShape of the object
+   * Returns the reShape of the object. Shapes may be shared between entities
+   * through the re::ShapeCache, so they can not be modified in place.
    * 
    * @return The reShape of the object
    */
 
-  inline reShape& Entity::shape() {
+  inline const reShape& Entity::shape() const {
     return _shape;
   }
 
   /**
-   * Returns the reShape of the object. Enforces constant constraint
+   * Returns the innermost shape of the object, which is the shape wrapped by
+   * any re::ShapeProxy layers. Queries against the base shape should use
+   * Entity::shapeTransform() to account for the flattened proxy transforms.
    * 
-   * @return The reShape of the object
+   * @return The base shape of the object
    */
 
-  inline const reShape& Entity::shape() const {
-    return _shape;
+  inline const reShape& Entity::baseShape() const {
+    return *_base;
+  }
+
+  /**
+   * Returns the placement of the shape relative to the entity. Rigid
+   * placements are kept on the entity rather than wrapping the shape in a
+   * re::ShapeProxy, so that entities with differently placed copies of a
+   * shape can all share the same shape.
+   * 
+   * @return The rigid transform from the shape's space to the entity's space
+   */
+
+  inline const re::RigidTransform& Entity::shapeOffset() const {
+    return _shapeOffset;
   }
 
   /**
@@ -200,6 +261,73 @@ namespace re {
     return re::Transform(rot(), _pos);
   }
 
+  /**
+   * Returns the entity's transformation as a rotation and translation, which
+   * is considerably cheaper to invert than the matrix form
+   * 
+   * @return The rigid transformation of the entity
+   */
+
+  inline const re::RigidTransform Entity::rigidTransform() const {
+    return re::RigidTransform(orient(), _pos);
+  }
+
+  /**
+   * Returns the cached transform from the base shape's space to world space.
+   * This combines the entity's transform with the shape offset and all proxy
+   * transforms.
+   * 
+   * @return The world transform of the base shape
+   */
+
+  inline const re::Transform& Entity::shapeTransform() const {
+    return _shapeTransform;
+  }
+
+  /**
+   * Returns the cached inverse of Entity::shapeTransform()
+   * 
+   * @return The transform from world space to the base shape's space
+   */
+
+  inline const re::Transform& Entity::shapeTransformInv() const {
+    return _shapeTransformInv;
+  }
+
+  /**
+   * Recomputes the cached shape transforms from the entity's current state.
+   * This is done automatically whenever the entity moves, but must be called
+   * explicitly if a re::ShapeProxy owned by the entity is modified.
+   */
+
+  inline void Entity::updateTransform() {
+    updateTransform(rigidTransform());
+  }
+
+  /**
+   * Returns true if continuous collision detection is enabled for the
+   * re::Entity
+   * 
+   * @return True if the entity is swept along its path each time step
+   */
+
+  inline bool Entity::isContinuous() const {
+    return _continuous;
+  }
+
+  /**
+   * Enables or disables continuous collision detection for the re::Entity.
+   * Continuous entities are swept against the broad phase whenever they
+   * travel far enough in a single time step to pass through thin shapes,
+   * at the cost of an additional query per step.
+   * 
+   * @param continuous True to enable continuous collision detection
+   */
+
+  inline void Entity::setContinuous(bool continuous) {
+    _continuous = continuous;
+  }
+
   /**
    * Returns the position of the center of the reShape associated with the re::Entity.
    * This differs from Entity::pos() when the shape has an offset
@@ -208,7 +336,7 @@ namespace re {
    */
 
   inline const re::vec3 Entity::center() const {
-    return _pos + shape().center();
+    return _pos + _shapeOffset.applyToPoint(shape().center());
   }
 
   /**
@@ -221,6 +349,18 @@ namespace re {
     return _id;
   }
 
+  /**
+   * Returns the handle issued for the re::Entity when it was registered.
+   * Unlike references, handles can be checked for validity after the entity
+   * has been removed.
+   * 
+   * @return The handle of the re::Entity, or a null handle if unregistered
+   */
+
+  inline re::EntityHandle Entity::handle() const {
+    return _handle;
+  }
+
   /**
    * Set the re::Entity's position
    * 
@@ -229,6 +369,7 @@ namespace re {
 
   inline void Entity::setPos(const re::vec3& position) {
     _pos = position;
+    updateTransform();
   }
 
   /**
@@ -241,6 +382,7 @@ namespace re {
 
   inline void Entity::setPos(reFloat x, reFloat y, reFloat z) {
     _pos.set(x, y, z);
+    updateTransform();
   }
 
   /**
@@ -388,6 +530,7 @@ namespace re {
       KLASS& rotatingWith(reFloat wx, reFloat wy, reFloat wz) override { setAngVel(wx, wy, wz); return *this; } \
       KLASS& withRestitution(reFloat restitution) override { setRestitution(restitution); return *this; } \
       KLASS& withFriction(reFloat friction) override { setFriction(friction); return *this; } \
-      KLASS& withResistance(reFloat resistance) override { setResistance(resistance); return *this; }
+      KLASS& withResistance(reFloat resistance) override { setResistance(resistance); return *this; } \
+      KLASS& withContinuousCollision() override { setContinuous(true); return *this; }
 
 #endif
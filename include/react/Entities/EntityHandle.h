@@ -0,0 +1,96 @@
+/**
+ * @file
+ * Contains the definition of the re::EntityHandle struct
+ */
+#ifndef RE_ENTITY_HANDLE_H
+#define RE_ENTITY_HANDLE_H
+
+#include "react/common.h"
+
+namespace re {
+
+  /**
+   * @ingroup entities
+   * A weak reference to a re::Entity registered in a re::EntityRegistry. The
+   * handle packs the index of the entity's slot in the registry with the
+   * generation of the slot, which changes each time the slot is freed. A
+   * handle to an entity which has since been removed can therefore be
+   * detected, rather than referring to whichever entity reused the slot.
+   *
+   * A handle with a value of zero never refers to an entity.
+   *
+   * @see EntityRegistry
+   */
+
+  struct EntityHandle {
+    /** The number of bits used by the slot index */
+    static const reUInt INDEX_BITS = 20;
+    /** The number of bits used by the slot generation */
+    static const reUInt GENERATION_BITS = 32 - INDEX_BITS;
+    /** The mask for the slot index */
+    static const reUInt INDEX_MASK = (1u << INDEX_BITS) - 1;
+    /** The mask for the slot generation, after shifting */
+    static const reUInt GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+    EntityHandle();
+    EntityHandle(reUInt index, reUInt generation);
+
+    reUInt index() const;
+    reUInt generation() const;
+    bool isNull() const;
+
+    bool operator==(const EntityHandle& handle) const;
+    bool operator!=(const EntityHandle& handle) const;
+
+    /** The packed index and generation */
+    reUInt value;
+  };
+
+  inline EntityHandle::EntityHandle() : value(0) {
+    // do nothing
+  }
+
+  inline EntityHandle::EntityHandle(reUInt index, reUInt generation) : value((generation << INDEX_BITS) | (index & INDEX_MASK)) {
+    // do nothing
+  }
+
+  /**
+   * Returns the index of the slot in the registry referred to by the handle
+   *
+   * @return The slot index
+   */
+
+  inline reUInt EntityHandle::index() const {
+    return value & INDEX_MASK;
+  }
+
+  /**
+   * Returns the generation of the slot at the time the handle was issued
+   *
+   * @return The slot generation
+   */
+
+  inline reUInt EntityHandle::generation() const {
+    return value >> INDEX_BITS;
+  }
+
+  /**
+   * Returns true if the handle was never issued by a registry
+   *
+   * @return True if the handle is null
+   */
+
+  inline bool EntityHandle::isNull() const {
+    return value == 0;
+  }
+
+  inline bool EntityHandle::operator==(const EntityHandle& handle) const {
+    return value == handle.value;
+  }
+
+  inline bool EntityHandle::operator!=(const EntityHandle& handle) const {
+    return value != handle.value;
+  }
+}
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file
+ * Contains the definition of the re::EntityRegistry class
+ */
+#ifndef RE_ENTITY_REGISTRY_H
+#define RE_ENTITY_REGISTRY_H
+
+#include "react/Entities/EntityHandle.h"
+#include "react/Utilities/reDenseArray.h"
+
+namespace re {
+  class Entity;
+
+  /**
+   * @ingroup entities
+   * Issues re::EntityHandle objects for entities, and resolves them back to
+   * the entities in constant time. Registered entities are kept packed
+   * together so that they can be iterated without gaps. Each slot remembers
+   * where its entity lives in the packed array, and each entry in the packed
+   * array remembers its slot, so removal is also constant time.
+   *
+   * The registry does not own the entities it refers to.
+   */
+
+  class EntityRegistry {
+  public:
+    EntityRegistry(reAllocator& allocator);
+    /** Prohibit copying */
+    EntityRegistry(const EntityRegistry&) = delete;
+    ~EntityRegistry();
+
+    /** Prohibit copying */
+    EntityRegistry& operator=(const EntityRegistry&) = delete;
+
+    EntityHandle add(Entity& entity);
+    bool remove(EntityHandle handle);
+    void remove(Entity& entity);
+    void reserve(reUInt capacity);
+    void clear();
+
+    Entity* get(EntityHandle handle) const;
+    bool contains(EntityHandle handle) const;
+    reUInt size() const;
+    bool empty() const;
+    const reDenseArray<Entity*>& entities() const;
+
+    Entity** begin();
+    Entity** end();
+    Entity* const* begin() const;
+    Entity* const* end() const;
+
+    /** The maximum number of entities which can be registered at once */
+    static const reUInt MAX_ENTITIES = EntityHandle::INDEX_MASK + 1;
+
+  private:
+    struct Slot {
+      /** The generation of handles issued for the slot */
+      reUInt generation;
+      /** The index of the entity in the packed array, or the next free slot */
+      reUInt next;
+    };
+
+    /** The slot for every handle ever issued */
+    reDenseArray<Slot> _slots;
+    /** The packed array of registered entities */
+    reDenseArray<Entity*> _entities;
+    /** The slot of each entity in the packed array */
+    reDenseArray<reUInt> _owners;
+    /** The first slot available for reuse */
+    reUInt _free;
+  };
+
+  /**
+   * Returns true if the handle refers to an entity which is still registered
+   *
+   * @param handle The handle to check
+   * @return True if the handle is valid
+   */
+
+  inline bool EntityRegistry::contains(EntityHandle handle) const {
+    return handle.index() < _slots.size() &&
+      _slots[handle.index()].generation == handle.generation();
+  }
+
+  /**
+   * Resolves the handle to the entity it refers to
+   *
+   * @param handle The handle to resolve
+   * @return The entity, or a null pointer if the handle is no longer valid
+   */
+
+  inline Entity* EntityRegistry::get(EntityHandle handle) const {
+    return contains(handle) ? _entities[_slots[handle.index()].next] : nullptr;
+  }
+
+  inline reUInt EntityRegistry::size() const {
+    return _entities.size();
+  }
+
+  inline bool EntityRegistry::empty() const {
+    return _entities.empty();
+  }
+
+  /**
+   * Returns the packed array of registered entities. The order of the
+   * entities changes as entities are removed.
+   *
+   * @return The registered entities
+   */
+
+  inline const reDenseArray<Entity*>& EntityRegistry::entities() const {
+    return _entities;
+  }
+
+  inline Entity** EntityRegistry::begin() {
+    return _entities.begin();
+  }
+
+  inline Entity** EntityRegistry::end() {
+    return _entities.end();
+  }
+
+  inline Entity* const* EntityRegistry::begin() const {
+    return _entities.begin();
+  }
+
+  inline Entity* const* EntityRegistry::end() const {
+    return _entities.end();
+  }
+}
+
+#endif
@@ -18,7 +18,7 @@ namespace re {
 
   class Rigid : public Entity {
   public:
-    Rigid(reShape& shape);
+    Rigid(const reShape& shape, const re::RigidTransform& offset = re::RigidTransform());
     Rigid(const re::Rigid&) = delete;
     virtual ~Rigid();
     
@@ -45,6 +45,7 @@ namespace re {
     void setVel(reFloat x, reFloat y, reFloat z) override;
     void setAngVel(const re::vec3&) override;
     void setAngVel(reFloat, reFloat, reFloat) override; 
+    void setOrient(const re::quat& orient) override;
     void setFacing(const re::vec3& dir, const re::vec3& up = re::vec3(0.0, 0.0, 1.0)) override; 
 
     // operations
@@ -91,7 +92,7 @@ namespace re {
     void updateInertia();
   };
 
-  inline Rigid::Rigid(reShape& shape) : Entity(shape), _vel(0.0), _orient(), _angVel(0.0), _massInv(1.0), _inertiaInv(1.0), _linearImpulse(0.0), _restitution(0.6), _friction(0.3), _resistance(0.01) {
+  inline Rigid::Rigid(const reShape& shape, const re::RigidTransform& offset) : Entity(shape, offset), _vel(0.0), _orient(), _angVel(0.0), _massInv(1.0), _inertiaInv(1.0), _linearImpulse(0.0), _restitution(0.6), _friction(0.3), _resistance(0.01) {
     updateInertia();
   }
 
@@ -135,8 +136,14 @@ namespace re {
     _angVel.set(wx, wy, wz);
   }
 
+  inline void Rigid::setOrient(const re::quat& orient) {
+    _orient = orient;
+    updateTransform();
+  }
+
   inline void Rigid::setFacing(const re::vec3& dir, const re::vec3& up) {
     _orient = re::toQuat(re::orientY(dir, up));
+    updateTransform();
   }
 
   inline void Rigid::advance(re::Integrator& op, reFloat dt) {
@@ -144,6 +151,7 @@ namespace re {
     op.integrate(_pos, _vel, dt);
     op.integrate(_orient, _angVel, dt);
     _linearImpulse.set(0.0, 0.0, 0.0);
+    updateTransform();
   }
 
   inline void Rigid::addImpulse(const re::vec3& impulse) {
@@ -205,7 +213,9 @@ namespace re {
   }
 
   inline void Rigid::updateInertia() {
-    _inertiaInv = re::inverse(_shape.computeInertia()) / _massInv;
+    // the shape's inertia is turned into the entity's space by the offset
+    const re::mat3 rot = re::toMat(shapeOffset().q);
+    _inertiaInv = rot * re::inverse(_shape.computeInertia()) * re::transpose(rot) / _massInv;
   }
 }
 
@@ -10,7 +10,7 @@
 namespace re {
   class Static : public Entity {
   public:
-    Static(reShape& shape);
+    Static(const reShape& shape, const re::RigidTransform& offset = re::RigidTransform());
     Static(const Static&) = delete;
     virtual ~Static();
 
@@ -37,6 +37,7 @@ namespace re {
     void setVel(reFloat x, reFloat y, reFloat z) override;
     void setAngVel(const re::vec3&) override;
     void setAngVel(reFloat, reFloat, reFloat) override; 
+    void setOrient(const re::quat& orient) override;
     void setFacing(const re::vec3& dir, const re::vec3& up = re::vec3(0.0, 0.0, 1.0)) override; 
 
     void advance(re::Integrator& integrator, reFloat dt) override;
@@ -65,7 +66,7 @@ namespace re {
     reFloat _resistance;
   };
 
-  inline Static::Static(reShape& shape) : Entity(shape), _orient(), _restitution(0.6), _friction(0.3), _resistance(0.01) {
+  inline Static::Static(const reShape& shape, const re::RigidTransform& offset) : Entity(shape, offset), _orient(), _restitution(0.6), _friction(0.3), _resistance(0.01) {
     // do nothing
   }
 
@@ -109,8 +110,14 @@ namespace re {
     // do nothing
   }
 
+  inline void Static::setOrient(const re::quat& orient) {
+    _orient = orient;
+    updateTransform();
+  }
+
   inline void Static::setFacing(const re::vec3& dir, const re::vec3& up) {
     _orient = re::toQuat(re::orientY(dir, up));
+    updateTransform();
   }
 
   inline void Static::advance(re::Integrator&, reFloat) {
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * Contains the definition of the re::RigidTransform struct
+ */
+#ifndef RE_RIGID_TRANSFORM_H
+#define RE_RIGID_TRANSFORM_H
+
+#include "react/Math/vec3.h"
+#include "react/Math/quat.h"
+#include "react/Math/Transform.h"
+#include "react/Math/math_ops.h"
+
+namespace re {
+
+  /**
+   * @ingroup maths
+   * A transform consisting only of a rotation followed by a translation. Unlike
+   * a general re::Transform, it can be inverted cheaply by conjugating the
+   * rotation, and is therefore used to represent the placement of entities.
+   */
+
+  struct RigidTransform {
+    RigidTransform();
+    RigidTransform(const RigidTransform& that);
+    RigidTransform(const quat& rotation, const vec3& translation);
+
+    RigidTransform& operator=(const RigidTransform& that);
+    RigidTransform& operator*=(const RigidTransform& that);
+
+    const RigidTransform operator*(const RigidTransform& that) const;
+
+    const vec3 applyToPoint(const vec3& point) const;
+    const vec3 applyToDir(const vec3& dir) const;
+
+    /** Represents the rotational component as a unit quaternion */
+    quat q;
+    /** Represents the translational component */
+    vec3 v;
+  };
+
+  inline RigidTransform::RigidTransform() : q(), v(0.0, 0.0, 0.0) {
+    // do nothing
+  }
+
+  inline RigidTransform::RigidTransform(const RigidTransform& that) : q(that.q), v(that.v) {
+    // do nothing
+  }
+
+  inline RigidTransform::RigidTransform(const quat& rotation, const vec3& translation) : q(rotation), v(translation) {
+    // do nothing
+  }
+
+  inline RigidTransform& RigidTransform::operator=(const RigidTransform& that) {
+    q = that.q;
+    v = that.v;
+    return *this;
+  }
+
+  inline RigidTransform& RigidTransform::operator*=(const RigidTransform& that) {
+    v += re::rotate(q, that.v);
+    q *= that.q;
+    return *this;
+  }
+
+  inline const RigidTransform RigidTransform::operator*(const RigidTransform& that) const {
+    return RigidTransform(*this) *= that;
+  }
+
+  inline const vec3 RigidTransform::applyToPoint(const vec3& point) const {
+    return re::rotate(q, point) + v;
+  }
+
+  inline const vec3 RigidTransform::applyToDir(const vec3& dir) const {
+    return re::rotate(q, dir);
+  }
+
+  /**
+   * @ingroup maths
+   * Computes the inverse of the rigid transform by conjugating the rotation,
+   * which avoids a general matrix inversion entirely
+   *
+   * @param tm The transform to invert
+   * @return The inverse of the input transform
+   */
+
+  inline const re::RigidTransform inverse(const re::RigidTransform& tm) {
+    const re::quat q = re::conjugate(tm.q);
+    return re::RigidTransform(q, -re::rotate(q, tm.v));
+  }
+
+  /**
+   * @ingroup maths
+   * Converts the rigid transform into the equivalent general transform
+   *
+   * @param tm The rigid transform
+   * @return The equivalent re::Transform
+   */
+
+  inline const re::Transform toTransform(const re::RigidTransform& tm) {
+    return re::Transform(re::toMat(tm.q), tm.v);
+  }
+
+  /**
+   * @ingroup maths
+   * Returns true if the two transforms are similar
+   *
+   * @param a The first transform
+   * @param b The second transform
+   * @return True if the two transforms are similar
+   */
+
+  inline bool similar(const re::RigidTransform& a, const re::RigidTransform& b) {
+    // q and -q represent the same rotation
+    return re::similar(a.v, b.v) && (re::similar(a.q, b.q) || re::similar(a.q, b.q * -1.0));
+  }
+}
+
+#endif
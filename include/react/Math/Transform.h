@@ -44,6 +44,7 @@ namespace re {
     
     const vec3 applyToPoint(const vec3& point) const;
     const vec3 applyToDir(const vec3& dir) const;
+    void applyToPoints(const vec3* points, vec3* results, reUInt n) const;
     
     /** Represents the scaling and/or rotational component */
     mat3x3 m;
@@ -51,6 +52,8 @@ namespace re {
     vec3 v;
   };
 
+  const Transform inverse(const Transform& tm);
+
   inline Transform::Transform() : m(1.0), v(0.0, 0.0, 0.0) {
     // do nothing
   }
@@ -74,7 +77,7 @@ namespace re {
   }
 
   inline const Transform Transform::operator*(const Transform& that) const {
-    return Transform(*this) *= that;
+    return Transform(m * that.m, m * that.v + v);
   }
 
   inline Transform& Transform::operator=(const Transform& that) {
@@ -147,34 +150,7 @@ namespace re {
   }
 
   inline Transform& Transform::inverted() {
-    Transform tmp(*this);
-    
-    const reFloat a = tmp.v[1]*tmp.m[2][2] - tmp.v[2]*tmp.m[1][2];
-    const reFloat b = tmp.v[1]*tmp.m[2][1] - tmp.v[2]*tmp.m[1][1];
-    const reFloat c = tmp.v[1]*tmp.m[2][0] - tmp.v[2]*tmp.m[1][0];
-    
-    m[0][0] = tmp.m[1][1]*tmp.m[2][2] - tmp.m[1][2]*tmp.m[2][1];
-    m[0][1] = tmp.m[0][2]*tmp.m[2][1] - tmp.m[0][1]*tmp.m[2][2];
-    m[0][2] = tmp.m[0][1]*tmp.m[1][2] - tmp.m[0][2]*tmp.m[1][1];
-    v[0]    = a*tmp.m[0][1] - b*tmp.m[0][2] - tmp.v[0]*m[0][0];
-    
-    m[1][0] = tmp.m[1][2]*tmp.m[2][0] - tmp.m[1][0]*tmp.m[2][2];
-    m[1][1] = tmp.m[0][0]*tmp.m[2][2] - tmp.m[0][2]*tmp.m[2][0];
-    m[1][2] = tmp.m[0][2]*tmp.m[1][0] - tmp.m[0][0]*tmp.m[1][2];
-    v[1]    = c*tmp.m[0][2] - a*tmp.m[0][0] - tmp.v[0]*m[1][0];
-    
-    m[2][0] = tmp.m[1][0]*tmp.m[2][1] - tmp.m[1][1]*tmp.m[2][0];
-    m[2][1] = tmp.m[0][1]*tmp.m[2][0] - tmp.m[0][0]*tmp.m[2][1];
-    m[2][2] = tmp.m[0][0]*tmp.m[1][1] - tmp.m[0][1]*tmp.m[1][0];
-    v[2]    = b*tmp.m[0][0] - c*tmp.m[0][1] - tmp.v[0]*m[2][0];
-    
-    const reFloat det = tmp.m[0][0]*m[0][0] + tmp.m[0][1]*m[1][0] +
-                        tmp.m[0][2]*m[2][0];
-    
-    m /= det;
-    v /= det;
-    
-    return *this;
+    return *this = re::inverse(*this);
   }
 
   inline const Transform Transform::inverse() const {
@@ -182,19 +158,48 @@ namespace re {
   }
 
   inline const vec3 Transform::applyToPoint(const vec3& point) const {
-    return vec3(
-      m[0][0] * point.x + m[0][1] * point.y + m[0][2] * point.z + v[0],
-      m[1][0] * point.x + m[1][1] * point.y + m[1][2] * point.z + v[1],
-      m[2][0] * point.x + m[2][1] * point.y + m[2][2] * point.z + v[2]
-    );
+    return m * point + v;
   }
 
   inline const vec3 Transform::applyToDir(const vec3& dir) const {
-    return vec3(
-      m[0][0] * dir.x + m[0][1] * dir.y + m[0][2] * dir.z,
-      m[1][0] * dir.x + m[1][1] * dir.y + m[1][2] * dir.z,
-      m[2][0] * dir.x + m[2][1] * dir.y + m[2][2] * dir.z
-    );
+    return m * dir;
+  }
+
+  /**
+   * Applies the transform to an array of points. This is considerably faster
+   * than transforming each point individually, as the matrix is only
+   * rearranged once for the whole batch.
+   * 
+   * @param points The points to transform
+   * @param results The array to store the transformed points in, which may
+   * be the same as the input array
+   * @param n The number of points
+   */
+
+  inline void Transform::applyToPoints(const vec3* points, vec3* results, reUInt n) const {
+#ifdef RE_SIMD
+    // the columns of the matrix are scaled by each coordinate of the point
+    __m128 c0 = m.row(0);
+    __m128 c1 = m.row(1);
+    __m128 c2 = m.row(2);
+    __m128 c3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    for (reUInt i = 0; i < n; i++) {
+      const __m128 p = points[i].m;
+      results[i].m = _mm_add_ps(
+        _mm_add_ps(
+          _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)), c0),
+          _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)), c1)
+        ),
+        _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)), c2), v.m)
+      );
+    }
+#else
+    for (reUInt i = 0; i < n; i++) {
+      results[i] = applyToPoint(points[i]);
+    }
+#endif
   }
 }
 
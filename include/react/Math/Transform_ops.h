@@ -22,34 +22,67 @@ namespace re {
    */
   
   inline const re::Transform inverse(const re::Transform& tm) {
-    Transform tmp(tm);
-    
-    const reFloat a = tm.v[1]*tm.m[2][2] - tm.v[2]*tm.m[1][2];
-    const reFloat b = tm.v[1]*tm.m[2][1] - tm.v[2]*tm.m[1][1];
-    const reFloat c = tm.v[1]*tm.m[2][0] - tm.v[2]*tm.m[1][0];
-    
-    tmp.m[0][0] = tm.m[1][1]*tm.m[2][2] - tm.m[1][2]*tm.m[2][1];
-    tmp.m[0][1] = tm.m[0][2]*tm.m[2][1] - tm.m[0][1]*tm.m[2][2];
-    tmp.m[0][2] = tm.m[0][1]*tm.m[1][2] - tm.m[0][2]*tm.m[1][1];
-    tmp.v[0]    = a*tm.m[0][1] - b*tm.m[0][2] - tm.v[0]*tmp.m[0][0];
-    
-    tmp.m[1][0] = tm.m[1][2]*tm.m[2][0] - tm.m[1][0]*tm.m[2][2];
-    tmp.m[1][1] = tm.m[0][0]*tm.m[2][2] - tm.m[0][2]*tm.m[2][0];
-    tmp.m[1][2] = tm.m[0][2]*tm.m[1][0] - tm.m[0][0]*tm.m[1][2];
-    tmp.v[1]    = c*tm.m[0][2] - a*tm.m[0][0] - tm.v[0]*tmp.m[1][0];
-    
-    tmp.m[2][0] = tm.m[1][0]*tm.m[2][1] - tm.m[1][1]*tm.m[2][0];
-    tmp.m[2][1] = tm.m[0][1]*tm.m[2][0] - tm.m[0][0]*tm.m[2][1];
-    tmp.m[2][2] = tm.m[0][0]*tm.m[1][1] - tm.m[0][1]*tm.m[1][0];
-    tmp.v[2]    = b*tm.m[0][0] - c*tm.m[0][1] - tm.v[0]*tmp.m[2][0];
-    
-    const reFloat det = tm.m[0][0]*tmp.m[0][0] + tm.m[0][1]*tmp.m[1][0] +
-                        tm.m[0][2]*tmp.m[2][0];
-    
-    tmp.m /= det;
-    tmp.v /= det;
-    
-    return tmp;
+#ifdef RE_SIMD
+    const re::vec3 r0(tm.m.row(0));
+    const re::vec3 r1(tm.m.row(1));
+    const re::vec3 r2(tm.m.row(2));
+    __m128 c0 = re::cross(r1, r2).m;
+    __m128 c1 = re::cross(r2, r0).m;
+    __m128 c2 = re::cross(r0, r1).m;
+    __m128 c3 = _mm_setzero_ps();
+    const __m128 detInv = _mm_set1_ps(-1.0f / re::dot(r0, re::vec3(c0)));
+    // the inverse applied to the translation is a combination of the cross
+    // products, so it is computed before they are transposed
+    const __m128 v = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(tm.v.x), c0), _mm_mul_ps(_mm_set1_ps(tm.v.y), c1)),
+      _mm_mul_ps(_mm_set1_ps(tm.v.z), c2)
+    );
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    // the negated reciprocal also negates the translation
+    re::Transform result;
+    result.m.setRows(_mm_xor_ps(_mm_mul_ps(c0, detInv), _mm_set1_ps(-0.0f)),
+                     _mm_xor_ps(_mm_mul_ps(c1, detInv), _mm_set1_ps(-0.0f)),
+                     _mm_xor_ps(_mm_mul_ps(c2, detInv), _mm_set1_ps(-0.0f)));
+    result.v.m = _mm_mul_ps(v, detInv);
+    return result;
+#else
+    const re::mat3x3 inv = re::inverse(tm.m);
+    return re::Transform(inv, -(inv * tm.v));
+#endif
+  }
+  
+  /**
+   * @ingroup maths
+   * Computes the inverse of a rigid transform, which consists of only a
+   * rotation and translation. The inverse of the rotation is its transpose,
+   * which is much cheaper to compute than a general inverse. The result is
+   * undefined if the transform contains any scaling or shearing.
+   * 
+   * @param tm The rigid transform to invert
+   * @return The inverse of the input transform
+   */
+  
+  inline const re::Transform rigidInverse(const re::Transform& tm) {
+#ifdef RE_SIMD
+    __m128 r0 = tm.m.row(0);
+    __m128 r1 = tm.m.row(1);
+    __m128 r2 = tm.m.row(2);
+    __m128 r3 = _mm_setzero_ps();
+    // the transposed matrix applied to the translation is a combination of the
+    // original rows, so it is computed before the rows are transposed
+    const __m128 v = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(tm.v.x), r0), _mm_mul_ps(_mm_set1_ps(tm.v.y), r1)),
+      _mm_mul_ps(_mm_set1_ps(tm.v.z), r2)
+    );
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    re::Transform result;
+    result.m.setRows(r0, r1, r2);
+    result.v.m = _mm_xor_ps(v, _mm_set1_ps(-0.0f));
+    return result;
+#else
+    const re::mat3x3 inv = re::transpose(tm.m);
+    return re::Transform(inv, -(inv * tm.v));
+#endif
   }
   
   /**
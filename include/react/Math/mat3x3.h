@@ -56,6 +56,11 @@ namespace re{
     const mat3x3 operator-(const mat3x3& m) const;
     const mat3x3 operator*(const mat3x3& m) const;
     
+#ifdef RE_SIMD
+    __m128 row(int i) const;
+    void setRows(__m128 r0, __m128 r1, __m128 r2);
+#endif
+    
     /** the elements of the matrix stored as an array */
     reFloat e[9];
     
@@ -163,6 +168,41 @@ namespace re{
     return &e[3*i];
   }
 
+#ifdef RE_SIMD
+  /**
+   * Loads a row of the matrix into an SSE register. The last element of the
+   * register holds no meaningful value.
+   * 
+   * @param i The row number
+   * @return The row as an SSE register
+   */
+
+  inline __m128 mat3x3::row(int i) const {
+    RE_ASSERT(i < 3)
+    if (i < 2) {
+      return _mm_loadu_ps(&e[3*i]);
+    }
+    // avoid reading past the end of the matrix
+    return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*)&e[6])), _mm_load_ss(&e[8]));
+  }
+
+  /**
+   * Stores the first three elements of each register as rows in the matrix
+   * 
+   * @param r0 The first row
+   * @param r1 The second row
+   * @param r2 The third row
+   */
+
+  inline void mat3x3::setRows(__m128 r0, __m128 r1, __m128 r2) {
+    // the later rows overwrite the padding written by the earlier ones
+    _mm_storeu_ps(&e[0], r0);
+    _mm_storeu_ps(&e[3], r1);
+    _mm_store_sd((double*)&e[6], _mm_castps_pd(r2));
+    _mm_store_ss(&e[8], _mm_movehl_ps(r2, r2));
+  }
+#endif
+
   /**
    * Set the matrix to be equal the input
    * 
@@ -211,18 +251,7 @@ namespace re{
    */
 
   inline re::mat3x3& mat3x3::operator*=(const re::mat3x3& m) {
-    mat3x3 tmp(*this);
-    
-    for (int i = 0; i < 3; i++) {
-      for (int j = 0; j < 3; j++) {
-        (*this)[i][j] = 0.0;
-        for (int k = 0; k < 3; k++) {
-          (*this)[i][j] += tmp[i][k] * m[k][j];
-        }
-      }
-    }
-    
-    return *this;
+    return *this = *this * m;
   }
 
   /**
@@ -261,9 +290,21 @@ namespace re{
    */
 
   inline const vec3 mat3x3::operator*(const vec3& v) const {
+#ifdef RE_SIMD
+    // transpose the row products so that the dot products become vertical sums
+    __m128 t0 = _mm_mul_ps(row(0), v.m);
+    __m128 t1 = _mm_mul_ps(row(1), v.m);
+    __m128 t2 = _mm_mul_ps(row(2), v.m);
+    __m128 t3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+    vec3 result;
+    result.m = _mm_add_ps(_mm_add_ps(t0, t1), t2);
+    return result;
+#else
     return vec3(v[0]*e[0] + v[1]*e[1] + v[2]*e[2],
                v[0]*e[3] + v[1]*e[4] + v[2]*e[5],
                v[0]*e[6] + v[1]*e[7] + v[2]*e[8]);
+#endif
   }
 
   /**
@@ -318,7 +359,28 @@ namespace re{
    */
 
   inline const mat3x3 mat3x3::operator*(const mat3x3& m) const {
-    return mat3x3(*this) *= m;
+    mat3x3 result(0.0);
+#ifdef RE_SIMD
+    // each row of the result is a combination of the rows of the operand
+    const __m128 b0 = m.row(0);
+    const __m128 b1 = m.row(1);
+    const __m128 b2 = m.row(2);
+    __m128 r[3];
+    for (int i = 0; i < 3; i++) {
+      r[i] = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[3*i]), b0), _mm_mul_ps(_mm_set1_ps(e[3*i + 1]), b1)),
+        _mm_mul_ps(_mm_set1_ps(e[3*i + 2]), b2)
+      );
+    }
+    result.setRows(r[0], r[1], r[2]);
+#else
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        result.e[3*i + j] = e[3*i]*m.e[j] + e[3*i + 1]*m.e[3 + j] + e[3*i + 2]*m.e[6 + j];
+      }
+    }
+#endif
+    return result;
   }
 
   inline const mat3x3 mat3x3::rand(reFloat b) {
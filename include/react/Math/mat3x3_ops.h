@@ -18,11 +18,22 @@ namespace re {
    */
   
   inline const re::mat3x3 transpose(const re::mat3x3& m) {
+#ifdef RE_SIMD
+    __m128 r0 = m.row(0);
+    __m128 r1 = m.row(1);
+    __m128 r2 = m.row(2);
+    __m128 r3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    re::mat3x3 result(0.0);
+    result.setRows(r0, r1, r2);
+    return result;
+#else
     return re::mat3x3(
       m[0][0], m[1][0], m[2][0],
       m[0][1], m[1][1], m[2][1],
       m[0][2], m[1][2], m[2][2]
     );
+#endif
   }
   
   /**
@@ -34,33 +45,47 @@ namespace re {
    */
   
   inline reFloat determinant(const re::mat3x3& m) {
-    return m[0][0]*(m[1][1]*m[2][2] - m[1][2]*m[2][1]) -
-           m[0][1]*(m[1][0]*m[2][2] - m[1][2]*m[2][0]) +
-           m[0][2]*(m[1][0]*m[2][1] - m[1][1]*m[2][0]);
+    return re::dot(re::vec3(m[0]), re::cross(re::vec3(m[1]), re::vec3(m[2])));
   }
   
   /**
    * @ingroup maths
-   * Calculates the inverse of a 3x3 matrix.
+   * Calculates the inverse of a 3x3 matrix. The columns of the inverse are
+   * the cross products of pairs of rows, which shares the work with the
+   * determinant.
    * 
    * @param a The matrix operand
    * @return The resulting matrix
    */
   
   inline const re::mat3x3 inverse(const re::mat3x3& m) {
+#ifdef RE_SIMD
+    const re::vec3 r0(m.row(0));
+    const re::vec3 r1(m.row(1));
+    const re::vec3 r2(m.row(2));
+    __m128 c0 = re::cross(r1, r2).m;
+    __m128 c1 = re::cross(r2, r0).m;
+    __m128 c2 = re::cross(r0, r1).m;
+    __m128 c3 = _mm_setzero_ps();
+    const __m128 detInv = _mm_set1_ps(1.0f / re::dot(r0, re::vec3(c0)));
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    re::mat3x3 result(0.0);
+    result.setRows(_mm_mul_ps(c0, detInv), _mm_mul_ps(c1, detInv), _mm_mul_ps(c2, detInv));
+    return result;
+#else
+    const re::vec3 r0(m[0]);
+    const re::vec3 r1(m[1]);
+    const re::vec3 r2(m[2]);
+    const re::vec3 c0 = re::cross(r1, r2);
+    const re::vec3 c1 = re::cross(r2, r0);
+    const re::vec3 c2 = re::cross(r0, r1);
+    const reFloat detInv = 1.0 / re::dot(r0, c0);
     return re::mat3x3(
-      m[1][1]*m[2][2] - m[1][2]*m[2][1],
-      m[0][2]*m[2][1] - m[0][1]*m[2][2],
-      m[0][1]*m[1][2] - m[0][2]*m[1][1],
-      
-      m[1][2]*m[2][0] - m[1][0]*m[2][2],
-      m[0][0]*m[2][2] - m[0][2]*m[2][0],
-      m[0][2]*m[1][0] - m[0][0]*m[1][2],
-      
-      m[1][0]*m[2][1] - m[1][1]*m[2][0],
-      m[0][1]*m[2][0] - m[0][0]*m[2][1],
-      m[0][0]*m[1][1] - m[0][1]*m[1][0]
-    ) /= determinant(m);
+      c0.x * detInv, c1.x * detInv, c2.x * detInv,
+      c0.y * detInv, c1.y * detInv, c2.y * detInv,
+      c0.z * detInv, c1.z * detInv, c2.z * detInv
+    );
+#endif
   }
   
   /**
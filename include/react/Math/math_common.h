@@ -9,6 +9,16 @@
 #include <cstdlib>
 #include "react/common.h"
 
+/**
+ * Defined when the math library uses SSE intrinsics. This is only possible
+ * with single precision floating point values, where a re::vec3 or re::quat
+ * fits exactly within a single 128-bit register.
+ */
+#if defined(RE_USE_SSE) && !defined(RE_DOUBLE_PRECISION)
+  #define RE_SIMD
+  #include <emmintrin.h>
+#endif
+
 /** Default value for the mathematical constant, pi */
 #define RE_PI                   3.14159265359
 
@@ -39,6 +49,10 @@ namespace re {
     return std::cos(x);
   }
   
+  inline reFloat tan(reFloat x) {
+    return std::tan(x);
+  }
+  
   inline bool isnan(reFloat x) {
     return std::isnan(x);
   }
@@ -11,7 +11,8 @@ namespace re {
 
   /**
    * @ingroup maths
-   * Represents a quaternion
+   * Represents a quaternion. When RE_SIMD is defined, the quaternion is
+   * aligned so that it can be operated on as a single SSE register.
    */
  
   struct quat {
@@ -53,6 +54,10 @@ namespace re {
         /** The quarternion as an array */
         reFloat v[4];
       };
+#ifdef RE_SIMD
+      /** The quaternion as an SSE register */
+      __m128 m;
+#endif
     };
     
     static const quat rand(reFloat b = 1.0);
@@ -65,6 +70,15 @@ namespace re {
     // do nothing
   }
 
+#ifdef RE_SIMD
+  inline quat::quat(const quat& that) : m(that.m) {
+    // do nothing
+  }
+
+  inline quat::quat(reFloat r, reFloat i, reFloat j, reFloat k) : m(_mm_set_ps(k, j, i, r)) {
+    // do nothing
+  }
+#else
   inline quat::quat(const quat& that) {
     for (reUInt i = 0; i < 4; i++) {
       v[i] = that.v[i];
@@ -74,11 +88,16 @@ namespace re {
   inline quat::quat(reFloat r, reFloat i, reFloat j, reFloat k) : v{ r, i, j, k } {
     // do nothing
   }
+#endif
 
   inline quat& quat::operator=(const quat& that) {
+#ifdef RE_SIMD
+    m = that.m;
+#else
     for (reUInt i = 0; i < 4; i++) {
       v[i] = that.v[i];
     }
+#endif
     return *this;
   }
 
@@ -93,26 +112,49 @@ namespace re {
   }
 
   inline quat& quat::operator+=(const quat& that) {
+#ifdef RE_SIMD
+    m = _mm_add_ps(m, that.m);
+#else
     for (reUInt i = 0; i < 4; i++) {
       v[i] += that.v[i];
     }
+#endif
     return *this;
   }
 
   inline quat& quat::operator-=(const quat& that) {
+#ifdef RE_SIMD
+    m = _mm_sub_ps(m, that.m);
+#else
     for (reUInt i = 0; i < 4; i++) {
       v[i] -= that.v[i];
     }
+#endif
     return *this;
   }
 
   inline quat& quat::operator*=(const quat& that) {
+#ifdef RE_SIMD
+    // each lane of the product is a signed sum of the lanes of this quaternion
+    // against a permutation of the lanes of the other quaternion
+    const __m128 b = that.m;
+    const __m128 p0 = _mm_mul_ps(_mm_shuffle_ps(m, m, _MM_SHUFFLE(0, 0, 0, 0)), b);
+    const __m128 p1 = _mm_mul_ps(_mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)),
+      _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f)));
+    const __m128 p2 = _mm_mul_ps(_mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2)),
+      _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), _mm_set_ps(-0.0f, 0.0f, 0.0f, -0.0f)));
+    const __m128 p3 = _mm_mul_ps(_mm_shuffle_ps(m, m, _MM_SHUFFLE(3, 3, 3, 3)),
+      _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), _mm_set_ps(0.0f, 0.0f, -0.0f, -0.0f)));
+    m = _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3));
+    return *this;
+#else
     quat tmp(*this);
     r = tmp.r * that.r - tmp.i * that.i - tmp.j * that.j - tmp.k * that.k;
     i = tmp.r * that.i + tmp.i * that.r + tmp.j * that.k - tmp.k * that.j;
     j = tmp.r * that.j - tmp.i * that.k + tmp.j * that.r + tmp.k * that.i;
     k = tmp.r * that.k + tmp.i * that.j - tmp.j * that.i + tmp.k * that.r;
     return *this;
+#endif
   }
 
   inline quat& quat::operator*=(const re::vec3& that) {
@@ -125,16 +167,24 @@ namespace re {
   }
 
   inline quat& quat::operator*=(reFloat s) {
+#ifdef RE_SIMD
+    m = _mm_mul_ps(m, _mm_set1_ps(s));
+#else
     for (reUInt i = 0; i < 4; i++) {
       v[i] *= s;
     }
+#endif
     return *this;
   }
 
   inline quat& quat::operator/=(reFloat s) {
+#ifdef RE_SIMD
+    m = _mm_div_ps(m, _mm_set1_ps(s));
+#else
     for (reUInt i = 0; i < 4; i++) {
       v[i] /= s;
     }
+#endif
     return *this;
   }
 
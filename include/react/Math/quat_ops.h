@@ -19,7 +19,13 @@ namespace re {
    */
 
   inline reFloat lengthSq(const re::quat& q) {
+#ifdef RE_SIMD
+    const __m128 p = _mm_mul_ps(q.m, q.m);
+    const __m128 sum = _mm_add_ps(p, _mm_movehl_ps(p, p));
+    return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1))));
+#else
     return q.r*q.r + q.i*q.i + q.j*q.j + q.k*q.k;
+#endif
   }
   
   /**
@@ -46,6 +52,41 @@ namespace re {
     return re::quat(q) /= re::length(q);
   }
   
+  /**
+   * @ingroup maths
+   * Calculates the conjugate of the quaternion. For unit quaternions, this is
+   * equivalent to the inverse.
+   * 
+   * @param q The input quaternion
+   * @return The conjugate of the quaternion
+   */
+
+  inline const re::quat conjugate(const re::quat& q) {
+#ifdef RE_SIMD
+    re::quat result;
+    result.m = _mm_xor_ps(q.m, _mm_set_ps(-0.0f, -0.0f, -0.0f, 0.0f));
+    return result;
+#else
+    return re::quat(q.r, -q.i, -q.j, -q.k);
+#endif
+  }
+  
+  /**
+   * @ingroup maths
+   * Rotates the vector by the unit quaternion, without constructing the
+   * equivalent rotation matrix
+   * 
+   * @param q The unit quaternion
+   * @param v The vector to rotate
+   * @return The rotated vector
+   */
+
+  inline const re::vec3 rotate(const re::quat& q, const re::vec3& v) {
+    const re::vec3 u(q.i, q.j, q.k);
+    const re::vec3 t = re::cross(u, v) * 2.0;
+    return v + t * q.r + re::cross(u, t);
+  }
+  
   /**
    * Generates a random unit quaternion
    * 
@@ -11,7 +11,9 @@ namespace re {
 
   /**
    * @ingroup maths
-   * Represents a single 3D vector
+   * Represents a single 3D vector. When RE_SIMD is defined, the vector is
+   * padded to 16 bytes and aligned so that it can be operated on as a single
+   * SSE register. The padding element holds no meaningful value.
    */
  
   struct vec3 {
@@ -23,6 +25,10 @@ namespace re {
     explicit vec3(const reFloat* array);
     /** initializes the vector with the input coordinates */
     vec3(reFloat _x, reFloat _y, reFloat _z);
+#ifdef RE_SIMD
+    /** initializes the vector from the contents of an SSE register */
+    explicit vec3(__m128 a);
+#endif
     
     // inline functions
     reFloat& operator[](int i);
@@ -71,6 +77,10 @@ namespace re {
         /** the vector as an array */
         reFloat v[3];
       };
+#ifdef RE_SIMD
+      /** the vector as an SSE register, the last element is padding */
+      __m128 m;
+#endif
     };
     
     static const vec3 rand(reFloat b = 1.0);
@@ -81,6 +91,23 @@ namespace re {
   };
 
   // inline constructors
+#ifdef RE_SIMD
+  inline vec3::vec3() : m(_mm_setzero_ps()) {
+    // do nothing
+  }
+  
+  inline vec3::vec3(reFloat s) : m(_mm_set_ss(s)) {
+    // do nothing
+  }
+  
+  inline vec3::vec3(const vec3& a) : m(a.m) {
+    // do nothing
+  }
+  
+  inline vec3::vec3(__m128 a) : m(a) {
+    // do nothing
+  }
+#else
   inline vec3::vec3() : v{0.0} {
     // do nothing
   }
@@ -92,6 +119,7 @@ namespace re {
   inline vec3::vec3(const vec3& a) : x(a.x), y(a.y), z(a.z) {
     // do nothing
   }
+#endif
 
   /**
    * @brief Copies the first 3 elements of the input array into the vec3
@@ -99,13 +127,15 @@ namespace re {
    * @param array An array of values
    */
 
-  inline vec3::vec3(const reFloat* array) : v{0.0} {
-    for (int i = 0; i < 3; i++) {
-      v[i] = array[i];
-    }
+  inline vec3::vec3(const reFloat* array) : vec3(array[0], array[1], array[2]) {
+    // do nothing
   }
 
+#ifdef RE_SIMD
+  inline vec3::vec3(reFloat _x, reFloat _y, reFloat _z) : m(_mm_set_ps(0.0f, _z, _y, _x)) { }
+#else
   inline vec3::vec3(reFloat _x, reFloat _y, reFloat _z) : x(_x), y(_y), z(_z) { }
+#endif
 
   /**
    * @brief Access an element in the vector
@@ -139,7 +169,13 @@ namespace re {
    */
 
   inline const vec3 vec3::operator-() const {
+#ifdef RE_SIMD
+    vec3 result;
+    result.m = _mm_xor_ps(m, _mm_set1_ps(-0.0f));
+    return result;
+#else
     return vec3(*this) *= -1.0;
+#endif
   }
 
   /**
@@ -150,9 +186,13 @@ namespace re {
    */
 
   inline vec3& vec3::operator=(const vec3& a) {
+#ifdef RE_SIMD
+    m = a.m;
+#else
     for (int i = 0; i < 3; i++) {
       v[i] = a.v[i];
     }
+#endif
     return *this;
   }
 
@@ -164,9 +204,13 @@ namespace re {
    */
 
   inline vec3& vec3::operator+=(const vec3& a) {
+#ifdef RE_SIMD
+    m = _mm_add_ps(m, a.m);
+#else
     for (int i = 0; i < 3; i++) {
       v[i] += a.v[i];
     }
+#endif
     return *this;
   }
 
@@ -178,9 +222,13 @@ namespace re {
    */
 
   inline vec3& vec3::operator-=(const vec3& a) {
+#ifdef RE_SIMD
+    m = _mm_sub_ps(m, a.m);
+#else
     for (int i = 0; i < 3; i++) {
       v[i] -= a.v[i];
     }
+#endif
     return *this;
   }
 
@@ -192,9 +240,13 @@ namespace re {
    */
 
   inline vec3& vec3::operator*=(const vec3& a) {
+#ifdef RE_SIMD
+    m = _mm_mul_ps(m, a.m);
+#else
     for (int i = 0; i < 3; i++) {
       v[i] *= a.v[i];
     }
+#endif
     return *this;
   }
 
@@ -206,9 +258,13 @@ namespace re {
    */
 
   inline vec3& vec3::operator+=(reFloat s) {
+#ifdef RE_SIMD
+    m = _mm_add_ps(m, _mm_set1_ps(s));
+#else
     for (int i = 0; i < 3; i++) {
       v[i] += s;
     }
+#endif
     return *this;
   }
 
@@ -220,9 +276,13 @@ namespace re {
    */
 
   inline vec3& vec3::operator-=(reFloat s) {
+#ifdef RE_SIMD
+    m = _mm_sub_ps(m, _mm_set1_ps(s));
+#else
     for (int i = 0; i < 3; i++) {
       v[i] -= s;
     }
+#endif
     return *this;
   }
 
@@ -234,9 +294,13 @@ namespace re {
    */
 
   inline vec3& vec3::operator*=(reFloat s) {
+#ifdef RE_SIMD
+    m = _mm_mul_ps(m, _mm_set1_ps(s));
+#else
     for (int i = 0; i < 3; i++) {
       v[i] *= s;
     }
+#endif
     return *this;
   }
 
@@ -248,9 +312,13 @@ namespace re {
    */
 
   inline vec3& vec3::operator/=(reFloat s) {
+#ifdef RE_SIMD
+    m = _mm_div_ps(m, _mm_set1_ps(s));
+#else
     for (int i = 0; i < 3; i++) {
       v[i] /= s;
     }
+#endif
     return *this;
   }
 
@@ -339,12 +407,18 @@ namespace re {
    */
 
   inline bool vec3::equals(const vec3& a) const {
+#ifdef RE_SIMD
+    // clear the sign bit to find the absolute difference, ignoring the padding
+    const __m128 diff = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(m, a.m));
+    return (_mm_movemask_ps(_mm_cmpgt_ps(diff, _mm_set1_ps(RE_FP_TOLERANCE))) & 0x7) == 0;
+#else
     for (int i = 0; i < 3; i++) {
       if (re::abs(v[i] - a.v[i]) > RE_FP_TOLERANCE) {
         return false;
       }
     }
     return true;
+#endif
   }
 
   /**
@@ -357,9 +431,13 @@ namespace re {
    */
 
   inline void vec3::set(reFloat _x, reFloat _y, reFloat _z) {
+#ifdef RE_SIMD
+    m = _mm_set_ps(0.0f, _z, _y, _x);
+#else
     x = _x;
     y = _y;
     z = _z;
+#endif
   }
 
   /**
@@ -377,7 +455,11 @@ namespace re {
    */
 
   inline void vec3::setZero() {
+#ifdef RE_SIMD
+    m = _mm_setzero_ps();
+#else
     x = y = z = 0.0;
+#endif
   }
   
   /**
@@ -19,7 +19,18 @@ namespace re {
    */
    
   inline const re::vec3 cross(const re::vec3& a, const re::vec3& b) {
+#ifdef RE_SIMD
+    // a.yzx * b.zxy - a.zxy * b.yzx
+    const __m128 aYZX = _mm_shuffle_ps(a.m, a.m, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 bYZX = _mm_shuffle_ps(b.m, b.m, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 aZXY = _mm_shuffle_ps(a.m, a.m, _MM_SHUFFLE(3, 1, 0, 2));
+    const __m128 bZXY = _mm_shuffle_ps(b.m, b.m, _MM_SHUFFLE(3, 1, 0, 2));
+    re::vec3 result;
+    result.m = _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+    return result;
+#else
     return re::vec3(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x);
+#endif
   }
   
   /**
@@ -32,7 +43,14 @@ namespace re {
    */
   
   inline reFloat dot(const re::vec3& a, const re::vec3& b) {
+#ifdef RE_SIMD
+    // sum only the first three lanes, the padding is ignored
+    const __m128 p = _mm_mul_ps(a.m, b.m);
+    const __m128 sum = _mm_add_ss(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(_mm_add_ss(sum, _mm_movehl_ps(p, p)));
+#else
     return a.x*b.x + a.y*b.y + a.z*b.z;
+#endif
   }
   
   /**
@@ -0,0 +1,99 @@
+/**
+ * @file
+ * Contains the definition of the re::MemoryTag enum and the re::MemoryStats
+ * struct
+ */
+#ifndef RE_MEMORY_STATS_H
+#define RE_MEMORY_STATS_H
+
+#include "react/Memory/reAllocator.h"
+
+namespace re {
+
+  /**
+   * @ingroup memory
+   * Identifies the subsystem responsible for an allocation. Containers are
+   * accounted to the subsystem which owns them.
+   */
+
+  enum MemoryTag {
+    MEMORY_GENERAL = 0,
+    MEMORY_BROAD_PHASE,
+    MEMORY_CONTACTS,
+    MEMORY_SHAPES,
+    MEMORY_ENTITIES,
+    MEMORY_FRAME,
+    NUM_MEMORY_TAGS
+  };
+
+  const char* memoryTagName(MemoryTag tag);
+
+  /**
+   * @ingroup memory
+   * The allocations made with a single re::MemoryTag
+   */
+
+  struct TagStats {
+    TagStats() : used(0), peak(0), numAllocs(0), totalAllocs(0), totalFrees(0) { }
+
+    /** The number of bytes requested by live allocations */
+    u32 used;
+    /** The highest number of bytes in use at any time */
+    u32 peak;
+    /** The number of live allocations */
+    u32 numAllocs;
+    /** The number of allocations made since the allocator was created */
+    uint64_t totalAllocs;
+    /** The number of deallocations made since the allocator was created */
+    uint64_t totalFrees;
+  };
+
+  /**
+   * @ingroup memory
+   * A snapshot of the memory used by a reWorld, broken down by subsystem
+   */
+
+  struct MemoryStats {
+    MemoryStats() : tags(), requested(0), used(0), reserved(0), stepAllocs(0), stepFrees(0) { }
+
+    float internalFragmentation() const;
+    float externalFragmentation() const;
+
+    /** The allocations made with each tag */
+    TagStats tags[NUM_MEMORY_TAGS];
+    /** The number of bytes requested by all live allocations */
+    u32 requested;
+    /** The number of bytes in use by the allocator, including any rounding and headers */
+    u32 used;
+    /** The number of bytes obtained from the system */
+    u32 reserved;
+    /** The number of allocations made in the most recent time step */
+    u32 stepAllocs;
+    /** The number of deallocations made in the most recent time step */
+    u32 stepFrees;
+  };
+
+  /**
+   * Returns the fraction of the memory in use which was not requested, lost
+   * to rounding up to block sizes and to bookkeeping
+   *
+   * @return The internal fragmentation between 0 and 1
+   */
+
+  inline float MemoryStats::internalFragmentation() const {
+    return used == 0 ? 0.0f : 1.0f - (float)requested / used;
+  }
+
+  /**
+   * Returns the fraction of the memory obtained from the system which is not
+   * in use, sitting in free blocks and unused chunks
+   *
+   * @return The external fragmentation between 0 and 1
+   */
+
+  inline float MemoryStats::externalFragmentation() const {
+    return reserved == 0 ? 0.0f : 1.0f - (float)used / reserved;
+  }
+}
+
+#endif
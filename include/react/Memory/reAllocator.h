@@ -37,6 +37,7 @@ public:
   template <class T> T* alloc_new();
   template <class X, class Y> X* alloc_new(Y& arg);
   template <class X, class Y> X* alloc_new(const Y& arg);
+  template <class X, class Y, class Z> X* alloc_new(Y& arg1, Z& arg2);
   template <class X, class Y, class Z> X* alloc_new(Y& arg1, const Z& arg2);
   template <class X, class Y, class Z> X* alloc_new(const Y& arg1, const Z& arg2);
   template <class X, class Y, class Z, class W> X* alloc_new(Y& arg1, Z& arg2, W& arg3);
@@ -99,6 +100,10 @@ template <class X, class Y> inline X* reAllocator::alloc_new(const Y& arg) {
  * @return The allocated instance
  */
 
+template <class X, class Y, class Z> inline X* reAllocator::alloc_new(Y& arg1, Z& arg2) {
+  return new (alloc(sizeof(X), __alignof(X))) X(arg1, arg2);
+}
+
 template <class X, class Y, class Z> inline X* reAllocator::alloc_new(Y& arg1, const Z& arg2) {
   return new (alloc(sizeof(X), __alignof(X))) X(arg1, arg2);
 }
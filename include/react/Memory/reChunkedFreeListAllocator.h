@@ -0,0 +1,111 @@
+/**
+ * @file
+ * Contains the definition of the reChunkedFreeListAllocator class
+ */
+#ifndef RE_CHUNKEDFREELISTALLOCATOR_H
+#define RE_CHUNKEDFREELISTALLOCATOR_H
+
+#include "react/Memory/reFreeListAllocator.h"
+
+/**
+ * @ingroup memory
+ * Implements a free list allocator which grows on demand. Memory is mapped
+ * from the operating system in chunks, using huge pages where available, and
+ * each chunk keeps a reFreeListAllocator of its own. When no chunk has a
+ * large enough free block, a new chunk is mapped. Allocations too large for
+ * a regular chunk are given a chunk of their own, which serves no other
+ * allocation. Chunks are aligned to the
+ * chunk size, so the chunk of any allocation is found from its address.
+ *
+ * A chunk which becomes completely empty is unmapped, except for a single
+ * spare chunk kept to avoid mapping and unmapping repeatedly.
+ *
+ * @see reFreeListAllocator
+ */
+
+class reChunkedFreeListAllocator : public reBaseAllocator {
+public:
+  reChunkedFreeListAllocator();
+  /** Prohibit copying */
+  reChunkedFreeListAllocator(const reChunkedFreeListAllocator&) = delete;
+  ~reChunkedFreeListAllocator();
+
+  void* alloc(u32 size, u8 alignment) override;
+  void dealloc(void* p) override;
+
+  /** Prohibit copying */
+  reChunkedFreeListAllocator& operator=(const reChunkedFreeListAllocator&) = delete;
+
+  u32 used() const override;
+  u32 numAllocs() const override;
+  u32 size() const override;
+  void* ptr() const override;
+  u32 numChunks() const;
+
+  /** The size and alignment of each chunk, matching the huge page size */
+  static const u32 CHUNK_SIZE = 2 * 1024 * 1024;
+
+private:
+  struct Chunk {
+    Chunk(u32 bytes, void* start);
+
+    /** The neighbouring chunks in the list of mapped chunks */
+    Chunk* prev;
+    Chunk* next;
+    /** The number of bytes mapped for the chunk */
+    u32 bytes;
+    /** Manages the memory after the chunk header */
+    reFreeListAllocator list;
+  };
+
+  Chunk* map(u32 bytes);
+  void unmap(Chunk* chunk);
+
+  u32 _used;
+  u32 _numAllocs;
+  u32 _size;
+  /** All mapped chunks, the most recently mapped first */
+  Chunk* _chunks;
+  /** The number of mapped chunks */
+  u32 _numChunks;
+};
+
+inline u32 reChunkedFreeListAllocator::used() const {
+  return _used;
+}
+
+inline u32 reChunkedFreeListAllocator::numAllocs() const {
+  return _numAllocs;
+}
+
+/**
+ * Returns the total number of bytes mapped from the operating system
+ *
+ * @return The number of bytes reserved by the allocator
+ */
+
+inline u32 reChunkedFreeListAllocator::size() const {
+  return _size;
+}
+
+/**
+ * The memory is spread over many chunks, so there is no single pointer to it
+ *
+ * @return Always returns a null pointer
+ */
+
+inline void* reChunkedFreeListAllocator::ptr() const {
+  return nullptr;
+}
+
+/**
+ * Returns the number of chunks currently mapped
+ *
+ * @return The number of chunks
+ */
+
+inline u32 reChunkedFreeListAllocator::numChunks() const {
+  return _numChunks;
+}
+
+#endif
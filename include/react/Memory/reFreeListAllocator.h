@@ -23,6 +23,7 @@ public:
   
   void* alloc(u32 size, u8 alignment) override;
   void dealloc(void* p) override;
+  void* tryAlloc(u32 size, u8 alignment);
   
   /** Prohibit copying */
   reFreeListAllocator& operator=(const reFreeListAllocator&) = delete;
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * Contains the definition of the reLinearAllocator class
+ */
+#ifndef RE_LINEARALLOCATOR_H
+#define RE_LINEARALLOCATOR_H
+
+#include "react/Memory/reBaseAllocator.h"
+
+/**
+ * @ingroup memory
+ * Implements a linear (arena) allocator for short lived scratch memory.
+ * Allocations are carved one after another from a single buffer, and
+ * individual deallocations do nothing. All memory is released at once with
+ * reset. When the buffer runs out, overflow pages are taken from the backing
+ * allocator, and the buffer is grown to the peak usage on the next reset, so
+ * a workload of steady size stops touching the backing allocator after the
+ * first few resets.
+ *
+ * @see reBaseAllocator
+ */
+
+class reLinearAllocator : public reBaseAllocator {
+public:
+  reLinearAllocator(reAllocator& backing, u32 capacity = DEFAULT_CAPACITY);
+  /** Prohibit copying */
+  reLinearAllocator(const reLinearAllocator&) = delete;
+  ~reLinearAllocator();
+
+  void* alloc(u32 size, u8 alignment) override;
+  void dealloc(void* p) override;
+  void reset();
+
+  /** Prohibit copying */
+  reLinearAllocator& operator=(const reLinearAllocator&) = delete;
+
+  u32 used() const override;
+  u32 numAllocs() const override;
+  u32 size() const override;
+  void* ptr() const override;
+
+  /** The initial size of the buffer */
+  static const u32 DEFAULT_CAPACITY = 16 * 1024;
+
+private:
+  struct Page {
+    /** The next overflow page */
+    Page* next;
+  };
+
+  void* allocOverflow(u32 size, u8 alignment);
+
+  reAllocator& _backing;
+  /** The start of the buffer */
+  u8* _start;
+  /** The next free byte in the current buffer or page */
+  u8* _current;
+  /** The end of the current buffer or page */
+  u8* _end;
+  /** The overflow pages obtained since the last reset */
+  Page* _pages;
+  u32 _used;
+  u32 _numAllocs;
+  /** The size of the buffer */
+  u32 _size;
+};
+
+inline u32 reLinearAllocator::used() const {
+  return _used;
+}
+
+/**
+ * Returns the number of allocations made since the last reset
+ *
+ * @return The number of allocations made
+ */
+
+inline u32 reLinearAllocator::numAllocs() const {
+  return _numAllocs;
+}
+
+/**
+ * Returns the size of the buffer, excluding any overflow pages
+ *
+ * @return The size of the buffer in bytes
+ */
+
+inline u32 reLinearAllocator::size() const {
+  return _size;
+}
+
+inline void* reLinearAllocator::ptr() const {
+  return _start;
+}
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file
+ * Contains the definition of the rePoolAllocator class
+ */
+#ifndef RE_POOLALLOCATOR_H
+#define RE_POOLALLOCATOR_H
+
+#include "react/Memory/reBaseAllocator.h"
+
+/**
+ * @ingroup memory
+ * Implements a segregated size class allocator. Small allocations are rounded
+ * up to one of a fixed set of block sizes, and each size class keeps its own
+ * free list of equally sized blocks, so allocating and freeing are both
+ * constant time. Blocks are carved from large chunks obtained from the
+ * system as needed. Chunks are aligned to their size, so the size class of
+ * any block can be found from its address alone. Allocations too large for
+ * any size class are given a chunk of their own.
+ *
+ * Memory is only returned to the system when the allocator is destroyed.
+ *
+ * @see reBaseAllocator
+ */
+
+class rePoolAllocator : public reBaseAllocator {
+public:
+  rePoolAllocator();
+  /** Prohibit copying */
+  rePoolAllocator(const rePoolAllocator&) = delete;
+  ~rePoolAllocator();
+
+  void* alloc(u32 size, u8 alignment) override;
+  void dealloc(void* p) override;
+
+  /** Prohibit copying */
+  rePoolAllocator& operator=(const rePoolAllocator&) = delete;
+
+  u32 used() const override;
+  u32 numAllocs() const override;
+  u32 size() const override;
+  void* ptr() const override;
+
+  static rePoolAllocator& ownerOf(const void* p);
+
+  /** The size and alignment of each chunk of blocks */
+  static const u32 CHUNK_SIZE = 64 * 1024;
+  /** The alignment of every block */
+  static const u32 BLOCK_ALIGNMENT = 16;
+  /** The number of size classes */
+  static const u32 NUM_CLASSES = 14;
+  /** The largest allocation served from a size class */
+  static const u32 MAX_CLASS_SIZE = 2048;
+  /** The block size of each size class */
+  static const u32 CLASS_SIZES[NUM_CLASSES];
+
+private:
+  struct Chunk {
+    /** The next chunk in the list of all chunks */
+    Chunk* next;
+    /** The allocator which obtained the chunk */
+    rePoolAllocator* owner;
+    /** The size class of the blocks, or NUM_CLASSES for a single large block */
+    u32 sizeClass;
+    /** The number of bytes in use by the chunk's block, for large chunks */
+    u32 blockSize;
+  };
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct SizeClass {
+    /** The blocks freed since they were carved */
+    FreeBlock* freeBlocks;
+    /** The next uncarved block in the newest chunk */
+    u8* next;
+    /** The end of the newest chunk */
+    u8* end;
+  };
+
+  void* allocLarge(u32 size, u8 alignment);
+  void refill(u32 sizeClass);
+  Chunk* newChunk(u32 bytes, u32 sizeClass);
+
+  u32 _used;
+  u32 _numAllocs;
+  u32 _size;
+  /** All chunks obtained from the system */
+  Chunk* _chunks;
+  SizeClass _classes[NUM_CLASSES];
+};
+
+inline u32 rePoolAllocator::used() const {
+  return _used;
+}
+
+inline u32 rePoolAllocator::numAllocs() const {
+  return _numAllocs;
+}
+
+/**
+ * Returns the total number of bytes obtained from the system
+ *
+ * @return The number of bytes reserved by the allocator
+ */
+
+inline u32 rePoolAllocator::size() const {
+  return _size;
+}
+
+/**
+ * The memory is spread over many chunks, so there is no single pointer to it
+ *
+ * @return Always returns a null pointer
+ */
+
+inline void* rePoolAllocator::ptr() const {
+  return nullptr;
+}
+
+#endif
@@ -6,17 +6,23 @@
 #define RE_PROXYALLOCATOR_H
 
 #include "react/Memory/reBaseAllocator.h"
+#include "react/Memory/MemoryStats.h"
 
+#include <atomic>
 #include <cstdio>
 
 /**
  * @ingroup memory
  * Implements a proxy allocator which forwards calls to a reBaseAllocator. The
  * proxy allocator will harvest information about each allocation, useful for
- * debugging.
+ * debugging. Each allocation is accounted to a re::MemoryTag, which is kept
+ * in a small header in front of the allocation. The counters are updated
+ * atomically, so the proxy may be used from several threads if the
+ * allocator behind it allows it.
  * 
  * @see reBaseAllocator
  * @see reAllocator
+ * @see reTaggedAllocator
  */
 
 class reProxyAllocator : public reAllocator {
@@ -25,17 +31,49 @@ public:
   ~reProxyAllocator();
   
   void* alloc(u32 size, u8 alignment) override;
+  void* alloc(u32 size, u8 alignment, re::MemoryTag tag);
   void dealloc(void* ptr) override;
   
   void show();
+  re::MemoryStats stats() const;
   reBaseAllocator* allocator();
   
 private:
+  struct Header {
+    /** The number of bytes requested */
+    u32 size;
+    /** The re::MemoryTag of the allocation */
+    uint16_t tag;
+    /** The distance from the start of the underlying block */
+    uint16_t offset;
+  };
+
+  struct Counters {
+    std::atomic<u32> used;
+    std::atomic<u32> peak;
+    std::atomic<u32> numAllocs;
+    std::atomic<uint64_t> totalAllocs;
+    std::atomic<uint64_t> totalFrees;
+  };
+
   reBaseAllocator* _allocator;
+  Counters _counters[re::NUM_MEMORY_TAGS];
 };
 
 inline reBaseAllocator* reProxyAllocator::allocator() {
   return _allocator;
 }
 
+/**
+ * Allocates memory accounted to the general tag
+ * 
+ * @param size The size of the memory to allocate
+ * @param alignment The required alignment
+ * @return A pointer to the allocated address
+ */
+
+inline void* reProxyAllocator::alloc(u32 size, u8 alignment) {
+  return alloc(size, alignment, re::MEMORY_GENERAL);
+}
+
 #endif
@@ -0,0 +1,54 @@
+/**
+ * @file
+ * Contains the definition of the reTaggedAllocator class
+ */
+#ifndef RE_TAGGEDALLOCATOR_H
+#define RE_TAGGEDALLOCATOR_H
+
+#include "react/Memory/reProxyAllocator.h"
+
+/**
+ * @ingroup memory
+ * A view of a reProxyAllocator which accounts every allocation made through
+ * it to a single re::MemoryTag. Memory may be released through any view of
+ * the same proxy, as the tag is kept with each allocation.
+ *
+ * @see reProxyAllocator
+ */
+
+class reTaggedAllocator : public reAllocator {
+public:
+  reTaggedAllocator(reProxyAllocator& proxy, re::MemoryTag tag);
+  /** Prohibit copying */
+  reTaggedAllocator(const reTaggedAllocator&) = delete;
+
+  void* alloc(u32 size, u8 alignment) override;
+  void dealloc(void* p) override;
+
+  /** Prohibit copying */
+  reTaggedAllocator& operator=(const reTaggedAllocator&) = delete;
+
+  re::MemoryTag tag() const;
+
+private:
+  reProxyAllocator& _proxy;
+  const re::MemoryTag _tag;
+};
+
+inline reTaggedAllocator::reTaggedAllocator(reProxyAllocator& proxy, re::MemoryTag tag) : reAllocator(), _proxy(proxy), _tag(tag) {
+  // do nothing
+}
+
+inline void* reTaggedAllocator::alloc(u32 size, u8 alignment) {
+  return _proxy.alloc(size, alignment, _tag);
+}
+
+inline void reTaggedAllocator::dealloc(void* p) {
+  _proxy.dealloc(p);
+}
+
+inline re::MemoryTag reTaggedAllocator::tag() const {
+  return _tag;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * Contains the definition of the reThreadCacheAllocator class
+ */
+#ifndef RE_THREADCACHEALLOCATOR_H
+#define RE_THREADCACHEALLOCATOR_H
+
+#include "react/Memory/rePoolAllocator.h"
+
+#include <atomic>
+#include <mutex>
+
+/**
+ * @ingroup memory
+ * Implements an allocator which may be used from several threads at once
+ * without locking. Each thread is given a cache with a rePoolAllocator of its
+ * own, which serves all of that thread's allocations. A block freed by the
+ * thread which allocated it goes straight back to its pool. Blocks freed by
+ * other threads are gathered into batches, one for each owning thread, and
+ * each full batch is handed over with a single atomic exchange. The owner
+ * collects the blocks handed to it the next time it allocates.
+ *
+ * Threads beyond the number of caches share a single pool behind a lock.
+ * The memory statistics read every cache, so they are only exact while no
+ * other thread is allocating.
+ *
+ * @see rePoolAllocator
+ */
+
+class reThreadCacheAllocator : public reBaseAllocator {
+public:
+  reThreadCacheAllocator();
+  /** Prohibit copying */
+  reThreadCacheAllocator(const reThreadCacheAllocator&) = delete;
+  ~reThreadCacheAllocator();
+
+  void* alloc(u32 size, u8 alignment) override;
+  void dealloc(void* p) override;
+  void flush();
+  void collect();
+
+  /** Prohibit copying */
+  reThreadCacheAllocator& operator=(const reThreadCacheAllocator&) = delete;
+
+  u32 used() const override;
+  u32 numAllocs() const override;
+  u32 size() const override;
+  void* ptr() const override;
+
+  /** The number of threads which can be given a cache */
+  static const u32 MAX_THREADS = 64;
+  /** The number of blocks gathered before they are handed to their owner */
+  static const u32 BATCH_SIZE = 32;
+
+private:
+  struct Block {
+    Block* next;
+  };
+
+  struct Batch {
+    Block* head;
+    Block* tail;
+    u32 size;
+  };
+
+  struct Cache : public rePoolAllocator {
+    explicit Cache(u32 index);
+
+    /** The index of the cache, MAX_THREADS for the shared cache */
+    const u32 index;
+    /** The blocks freed by other threads, waiting to be collected */
+    std::atomic<Block*> inbox;
+    /** The blocks freed by this thread, gathered for each owning cache */
+    Batch batches[MAX_THREADS + 1];
+  };
+
+  Cache& local();
+  Cache& cache(u32 index);
+  void hand(Cache& owner, Block* head, Block* tail);
+  void drain(Cache& cache);
+
+  /** The cache of each thread, created on first use */
+  std::atomic<Cache*> _caches[MAX_THREADS];
+  /** The cache shared by threads without a cache of their own */
+  Cache _shared;
+  /** Guards the shared cache */
+  std::mutex _sharedLock;
+};
+
+/**
+ * The memory is spread over many pools, so there is no single pointer to it
+ *
+ * @return Always returns a null pointer
+ */
+
+inline void* reThreadCacheAllocator::ptr() const {
+  return nullptr;
+}
+
+#endif
@@ -5,6 +5,8 @@
 #ifndef RE_BUILDER_H
 #define RE_BUILDER_H
 
+#include "react/math.h"
+
 class reWorld;
 class reShape;
 class reGravAction;
@@ -12,9 +14,29 @@ class reGravAction;
 namespace re {
   class Entity;
   class Rigid;
-  class Transform;
   class Static;
 
+  /**
+   * @ingroup utilities
+   * Describes a single entity for building many entities at once
+   * 
+   * @see Builder::Entities
+   */
+
+  struct EntityDesc {
+    EntityDesc(const reShape& shape, const re::vec3& pos = re::vec3(0.0, 0.0, 0.0), bool isStatic = false);
+    EntityDesc(const reShape& shape, const re::Transform& transform, const re::vec3& pos = re::vec3(0.0, 0.0, 0.0), bool isStatic = false);
+
+    /** The shape of the entity, which is shared as with single entities */
+    const reShape* shape;
+    /** The transform applied to the shape */
+    re::Transform transform;
+    /** The position of the entity */
+    re::vec3 pos;
+    /** True to build a re::Static rather than a re::Rigid */
+    bool isStatic;
+  };
+
   /**
    * @ingroup utilities
    * Defines a builder class which provides factory methods for 
@@ -29,6 +51,7 @@ namespace re {
     re::Rigid& Rigid(const reShape& shape, const re::Transform& transform);
     re::Static& Static(const reShape& shape);
     re::Static& Static(const reShape& shape, const re::Transform& transform);
+    reUInt Entities(const EntityDesc* descs, reUInt n, re::Entity** results = nullptr);
     
     // factory methods for interactions
     reGravAction& GravAction(Entity& A, Entity& B);
@@ -39,6 +62,14 @@ namespace re {
     reWorld& _world;
   };
 
+  inline EntityDesc::EntityDesc(const reShape& shape, const re::vec3& pos, bool isStatic) : shape(&shape), transform(), pos(pos), isStatic(isStatic) {
+    // do nothing
+  }
+
+  inline EntityDesc::EntityDesc(const reShape& shape, const re::Transform& transform, const re::vec3& pos, bool isStatic) : shape(&shape), transform(transform), pos(pos), isStatic(isStatic) {
+    // do nothing
+  }
+
   inline Builder::Builder(reWorld& world) : _world(world) {
     // do nothing
   }
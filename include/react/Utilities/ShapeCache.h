@@ -0,0 +1,78 @@
+/**
+ * @file
+ * Contains the definition of the re::ShapeCache class
+ */
+#ifndef RE_SHAPE_CACHE_H
+#define RE_SHAPE_CACHE_H
+
+#include "react/common.h"
+#include "react/Memory/reAllocator.h"
+#include "react/Utilities/reLinkedList.h"
+
+class reShape;
+
+namespace re {
+  struct Transform;
+
+  /**
+   * @ingroup utilities
+   * Maintains a set of reference counted shapes, deduplicated by value, which
+   * can be shared between any number of entities. The cache holds a reference
+   * to each shape it contains, so shapes remain available for instancing
+   * until the cache is purged or cleared.
+   */
+
+  class ShapeCache {
+  public:
+    ShapeCache(reAllocator& allocator);
+    /** Prohibit copying */
+    ShapeCache(const ShapeCache&) = delete;
+    ~ShapeCache();
+
+    /** Prohibit copying */
+    ShapeCache& operator=(const ShapeCache&) = delete;
+
+    const reShape& instance(const reShape& shape);
+    const reShape& instance(const reShape& shape, const re::Transform& transform);
+    reShape* copyOf(const reShape& shape);
+
+    void release(const reShape& shape);
+    void purge();
+    void clear();
+
+    reUInt size() const;
+
+    static void release(reAllocator& allocator, const reShape& shape);
+
+  private:
+    static const reUInt NUM_BUCKETS = 64;
+
+    reLinkedList<reShape*>& bucketFor(const reShape& shape);
+
+    reAllocator& _allocator;
+    reLinkedList<reShape*>* _buckets[NUM_BUCKETS];
+    reUInt _size;
+  };
+
+  /**
+   * Returns the number of unique shapes held by the cache, including proxies
+   *
+   * @return The number of cached shapes
+   */
+
+  inline reUInt ShapeCache::size() const {
+    return _size;
+  }
+
+  /**
+   * Releases a reference to the shape, destroying it if no other owners remain
+   *
+   * @param shape The shape to release
+   */
+
+  inline void ShapeCache::release(const reShape& shape) {
+    ShapeCache::release(_allocator, shape);
+  }
+}
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file
+ * Contains the definition of the records which make up a reWorld snapshot
+ */
+#ifndef RE_SNAPSHOT_H
+#define RE_SNAPSHOT_H
+
+#include "react/common.h"
+
+class reWorld;
+
+namespace re {
+
+  /**
+   * @ingroup utilities
+   * Starts every snapshot. The header is followed by the shape, entity,
+   * interaction and broad phase records, in that order. Every record has a
+   * fixed size and contains only plain numbers, so a snapshot mapped into
+   * memory can be read in place without being parsed or copied first.
+   *
+   * Snapshots are stored in the byte order and float precision of the
+   * machine which wrote them, and are rejected by builds which differ.
+   */
+
+  struct SnapshotHeader {
+    /** Identifies the data as a snapshot */
+    char magic[4];
+    /** The version of the snapshot format */
+    reUInt version;
+    /** The size of the floating point numbers in the snapshot */
+    reUInt floatSize;
+    /** The total size of the snapshot in bytes */
+    reUInt size;
+    /** The number of shape records */
+    reUInt numShapes;
+    /** The number of entity records */
+    reUInt numEntities;
+    /** The number of interaction records */
+    reUInt numInteractions;
+    /** The number of broad phase layout records */
+    reUInt numSplits;
+  };
+
+  /**
+   * @ingroup utilities
+   * A single shape shared by any number of entities in a snapshot
+   */
+
+  struct ShapeRecord {
+    /** The type of the shape @see reShape::Type */
+    reUInt type;
+    /** The index of the wrapped shape for re::ShapeProxy shapes */
+    reUInt base;
+    /**
+     * The parameters of the shape. Spheres store their radius, planes their
+     * normal and offset, triangles their vertices and proxies their
+     * transform, with the matrix stored row by row before the translation.
+     */
+    reFloat data[12];
+  };
+
+  /**
+   * @ingroup utilities
+   * The state and material properties of a single entity in a snapshot
+   */
+
+  struct EntityRecord {
+    /** The type of the entity @see re::Entity::Type */
+    reUInt type;
+    /** The index of the entity's shape */
+    reUInt shape;
+    /** One if the entity uses continuous collision detection */
+    reUInt continuous;
+    /** Keeps the floats aligned */
+    reUInt padding;
+    reFloat pos[3];
+    reFloat orient[4];
+    reFloat vel[3];
+    reFloat angVel[3];
+    reFloat massInv;
+    reFloat restitution;
+    reFloat friction;
+    reFloat resistance;
+    /** The translation of the shape relative to the entity */
+    reFloat offsetPos[3];
+    /** The rotation of the shape relative to the entity */
+    reFloat offsetOrient[4];
+  };
+
+  /**
+   * @ingroup utilities
+   * A built in interaction between two entities in a snapshot
+   */
+
+  struct InteractionRecord {
+    /** The type of the interaction @see reInteraction::Type */
+    reUInt type;
+    /** The index of the first entity */
+    reUInt A;
+    /** The index of the second entity */
+    reUInt B;
+    /** Keeps the size a multiple of the float size */
+    reUInt padding;
+  };
+
+  /** The current version of the snapshot format */
+  const reUInt SNAPSHOT_VERSION = 2;
+
+  reUInt writeSnapshot(const reWorld& world, void* buffer, reUInt capacity);
+  bool readSnapshot(reWorld& world, const void* data, reUInt size);
+  bool saveSnapshot(const reWorld& world, const char* path);
+  bool loadSnapshot(reWorld& world, const char* path);
+}
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file
+ * Contains the definition of the re::ThreadPool class
+ */
+#ifndef RE_THREAD_POOL_H
+#define RE_THREAD_POOL_H
+
+#include "react/common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace re {
+
+  /**
+   * @ingroup utilities
+   * A fixed set of worker threads which execute data parallel tasks. The
+   * calling thread takes part in every task, so a pool of size n only starts
+   * n - 1 threads, and a pool of size 1 simply runs tasks on the caller.
+   */
+
+  class ThreadPool {
+  public:
+    ThreadPool(reUInt size);
+    ThreadPool(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    reUInt size() const;
+    void run(reUInt count, const std::function<void(reUInt)>& task);
+
+  private:
+    void work();
+    void drain();
+
+    /** The worker threads, excluding the calling thread */
+    std::vector<std::thread> _threads;
+    /** Guards the task state shared with the workers */
+    std::mutex _lock;
+    /** Signals the workers that a task is available */
+    std::condition_variable _wake;
+    /** Signals the caller that all workers have finished the task */
+    std::condition_variable _done;
+    /** The current task */
+    const std::function<void(reUInt)>* _task;
+    /** The number of items in the current task */
+    reUInt _count;
+    /** The next item in the current task to be claimed */
+    std::atomic<reUInt> _next;
+    /** The number of workers still busy with the current task */
+    reUInt _busy;
+    /** Incremented for every new task, so workers never run a task twice */
+    reUInt _generation;
+    /** Set when the pool is destroyed */
+    bool _stopping;
+  };
+
+  /**
+   * Returns the number of threads which take part in each task, including the
+   * calling thread
+   *
+   * @return The number of threads in the pool
+   */
+
+  inline reUInt ThreadPool::size() const {
+    return _threads.size() + 1;
+  }
+}
+
+#endif
@@ -0,0 +1,325 @@
+/**
+ * @file
+ * Contains the definition of the reDenseArray class
+ */
+#ifndef RE_DENSEARRAY_H
+#define RE_DENSEARRAY_H
+
+#include "react/common.h"
+#include "react/Memory/reAllocator.h"
+
+#include <new>
+
+/**
+ * @ingroup utilities
+ * A growable array which keeps its elements packed together in memory.
+ * Elements are removed by moving the last element into the gap, so removal
+ * from a known index is constant time, but the order of the elements is not
+ * preserved. Owners which need to find their elements quickly can keep track
+ * of the index of each element, updating it when an element is moved.
+ */
+
+template <class T>
+class reDenseArray {
+public:
+  reDenseArray(reAllocator& allocator);
+  reDenseArray(const reDenseArray& array);
+  reDenseArray(reDenseArray&& array);
+  ~reDenseArray();
+  
+  reDenseArray& operator=(const reDenseArray& array);
+  reDenseArray& operator=(reDenseArray&& array);
+  
+  T& operator[](reUInt index);
+  const T& operator[](reUInt index) const;
+  
+  reUInt add(const T& value);
+  void removeAt(reUInt index);
+  bool remove(const T& value);
+  bool contains(const T& value) const;
+  reUInt indexOf(const T& value) const;
+  void append(const reDenseArray<T>& array);
+  void reserve(reUInt capacity);
+  void shrink();
+  void clear();
+  bool empty() const;
+  reUInt size() const;
+  reUInt capacity() const;
+  
+  T* begin();
+  T* end();
+  const T* begin() const;
+  const T* end() const;
+  
+private:
+  reAllocator& _allocator;
+  T* _data;
+  reUInt _size;
+  reUInt _capacity;
+};
+
+template <class T>
+reDenseArray<T>::reDenseArray(reAllocator& allocator) : _allocator(allocator), _data(nullptr), _size(0), _capacity(0) {
+  // do nothing
+}
+
+template <class T>
+reDenseArray<T>::reDenseArray(const reDenseArray<T>& array) : reDenseArray(array._allocator) {
+  append(array);
+}
+
+/**
+ * Takes over the memory of the array without allocating, leaving the array
+ * empty
+ * 
+ * @param array The array to move from
+ */
+
+template <class T>
+reDenseArray<T>::reDenseArray(reDenseArray<T>&& array) : _allocator(array._allocator), _data(array._data), _size(array._size), _capacity(array._capacity) {
+  array._data = nullptr;
+  array._size = 0;
+  array._capacity = 0;
+}
+
+template <class T>
+reDenseArray<T>::~reDenseArray() {
+  clear();
+  if (_data != nullptr) {
+    _allocator.dealloc(_data);
+  }
+}
+
+template <class T>
+reDenseArray<T>& reDenseArray<T>::operator=(const reDenseArray<T>& array) {
+  if (&array != this) {
+    clear();
+    append(array);
+  }
+  return *this;
+}
+
+/**
+ * Takes over the memory of the array if both arrays share an allocator,
+ * otherwise the elements are copied
+ * 
+ * @param array The array to move from
+ * @return The array moved into
+ */
+
+template <class T>
+reDenseArray<T>& reDenseArray<T>::operator=(reDenseArray<T>&& array) {
+  if (&array == this) {
+    return *this;
+  }
+  
+  clear();
+  if (&array._allocator != &_allocator) {
+    append(array);
+    array.clear();
+    return *this;
+  }
+  
+  if (_data != nullptr) {
+    _allocator.dealloc(_data);
+  }
+  _data = array._data;
+  _size = array._size;
+  _capacity = array._capacity;
+  array._data = nullptr;
+  array._size = 0;
+  array._capacity = 0;
+  return *this;
+}
+
+template <class T>
+inline T& reDenseArray<T>::operator[](reUInt index) {
+  RE_ASSERT(index < _size)
+  return _data[index];
+}
+
+template <class T>
+inline const T& reDenseArray<T>::operator[](reUInt index) const {
+  RE_ASSERT(index < _size)
+  return _data[index];
+}
+
+/**
+ * Adds the element to the end of the array
+ * 
+ * @param value The element to add
+ * @return The index of the new element
+ */
+
+template <class T>
+reUInt reDenseArray<T>::add(const T& value) {
+  if (_size == _capacity) {
+    reserve(_capacity == 0 ? 4 : 2 * _capacity);
+  }
+  new (&_data[_size]) T(value);
+  return _size++;
+}
+
+/**
+ * Removes the element at the index by moving the last element into its place
+ * 
+ * @param index The index of the element to remove
+ */
+
+template <class T>
+void reDenseArray<T>::removeAt(reUInt index) {
+  RE_ASSERT(index < _size)
+  
+  _size--;
+  if (index != _size) {
+    _data[index] = _data[_size];
+  }
+  _data[_size].~T();
+}
+
+/**
+ * Finds the element and removes it by moving the last element into its place
+ * 
+ * @param value The element to remove
+ * @return True if the element was found
+ */
+
+template <class T>
+bool reDenseArray<T>::remove(const T& value) {
+  const reUInt index = indexOf(value);
+  if (index == _size) {
+    return false;
+  }
+  
+  removeAt(index);
+  return true;
+}
+
+template <class T>
+inline bool reDenseArray<T>::contains(const T& value) const {
+  return indexOf(value) != _size;
+}
+
+/**
+ * Finds the index of the element
+ * 
+ * @param value The element to find
+ * @return The index of the element, or the size of the array if not found
+ */
+
+template <class T>
+reUInt reDenseArray<T>::indexOf(const T& value) const {
+  for (reUInt i = 0; i < _size; i++) {
+    if (_data[i] == value) {
+      return i;
+    }
+  }
+  return _size;
+}
+
+template <class T>
+void reDenseArray<T>::append(const reDenseArray<T>& array) {
+  reserve(_size + array._size);
+  for (reUInt i = 0; i < array._size; i++) {
+    add(array._data[i]);
+  }
+}
+
+/**
+ * Makes room for at least the given number of elements, so that adding
+ * elements up to that number does not allocate
+ * 
+ * @param capacity The number of elements to make room for
+ */
+
+template <class T>
+void reDenseArray<T>::reserve(reUInt capacity) {
+  if (capacity <= _capacity) {
+    return;
+  }
+  
+  T* data = (T*)_allocator.alloc(capacity * sizeof(T), __alignof(T));
+  for (reUInt i = 0; i < _size; i++) {
+    new (&data[i]) T(_data[i]);
+    _data[i].~T();
+  }
+  if (_data != nullptr) {
+    _allocator.dealloc(_data);
+  }
+  
+  _data = data;
+  _capacity = capacity;
+}
+
+/**
+ * Returns any memory not needed by the current elements to the allocator
+ */
+
+template <class T>
+void reDenseArray<T>::shrink() {
+  if (_size == _capacity) {
+    return;
+  }
+  
+  T* data = nullptr;
+  if (_size != 0) {
+    data = (T*)_allocator.alloc(_size * sizeof(T), __alignof(T));
+    for (reUInt i = 0; i < _size; i++) {
+      new (&data[i]) T(_data[i]);
+      _data[i].~T();
+    }
+  }
+  _allocator.dealloc(_data);
+  
+  _data = data;
+  _capacity = _size;
+}
+
+/**
+ * Removes all elements, keeping the memory for reuse
+ */
+
+template <class T>
+void reDenseArray<T>::clear() {
+  for (reUInt i = 0; i < _size; i++) {
+    _data[i].~T();
+  }
+  _size = 0;
+}
+
+template <class T>
+inline bool reDenseArray<T>::empty() const {
+  return _size == 0;
+}
+
+template <class T>
+inline reUInt reDenseArray<T>::size() const {
+  return _size;
+}
+
+template <class T>
+inline reUInt reDenseArray<T>::capacity() const {
+  return _capacity;
+}
+
+template <class T>
+inline T* reDenseArray<T>::begin() {
+  return _data;
+}
+
+template <class T>
+inline T* reDenseArray<T>::end() {
+  return _data + _size;
+}
+
+template <class T>
+inline const T* reDenseArray<T>::begin() const {
+  return _data;
+}
+
+template <class T>
+inline const T* reDenseArray<T>::end() const {
+  return _data + _size;
+}
+
+#endif
@@ -18,9 +18,11 @@ class reLinkedList {
 public:
   reLinkedList(reAllocator& allocator);
   reLinkedList(const reLinkedList& list);
+  reLinkedList(reLinkedList&& list);
   ~reLinkedList();
   
   reLinkedList& operator=(const reLinkedList& list);
+  reLinkedList& operator=(reLinkedList&& list);
   
   struct Node {
     Node(const T& v) : value(v), next(nullptr) { }
@@ -64,6 +66,19 @@ reLinkedList<T>::reLinkedList(const reLinkedList<T>& list) : reLinkedList(list._
   append(list);
 }
 
+/**
+ * Takes over the nodes of the list without allocating, leaving the list
+ * empty
+ * 
+ * @param list The list to move from
+ */
+
+template <class T>
+reLinkedList<T>::reLinkedList(reLinkedList<T>&& list) : _allocator(list._allocator), _first(list._first), _last(list._last), _size(list._size) {
+  list._first = list._last = nullptr;
+  list._size = 0;
+}
+
 template <class T>
 reLinkedList<T>::~reLinkedList() {
   clear();
@@ -84,8 +99,40 @@ void reLinkedList<T>::add(T t) {
 
 template <class T>
 reLinkedList<T>& reLinkedList<T>::operator=(const reLinkedList<T>& list) {
+  if (&list != this) {
+    clear();
+    append(list);
+  }
+  return *this;
+}
+
+/**
+ * Takes over the nodes of the list if both lists share an allocator,
+ * otherwise the elements are copied
+ * 
+ * @param list The list to move from
+ * @return The list moved into
+ */
+
+template <class T>
+reLinkedList<T>& reLinkedList<T>::operator=(reLinkedList<T>&& list) {
+  if (&list == this) {
+    return *this;
+  }
+  
   clear();
-  append(list);
+  if (&list._allocator != &_allocator) {
+    append(list);
+    list.clear();
+    return *this;
+  }
+  
+  _first = list._first;
+  _last = list._last;
+  _size = list._size;
+  list._first = list._last = nullptr;
+  list._size = 0;
+  return *this;
 }
 
 template <class T>
@@ -0,0 +1,285 @@
+/**
+ * @file
+ * Contains the definition of the reSmallVector class
+ */
+#ifndef RE_SMALLVECTOR_H
+#define RE_SMALLVECTOR_H
+
+#include "react/common.h"
+#include "react/Memory/reAllocator.h"
+
+#include <new>
+#include <utility>
+
+/**
+ * @ingroup utilities
+ * A growable array which stores up to N elements within the object itself,
+ * and only obtains memory from the allocator once it grows past that. The
+ * elements are kept in the order they were added.
+ */
+
+template <class T, reUInt N>
+class reSmallVector {
+  static_assert(N > 0, "Use reDenseArray for vectors without inline storage");
+  
+public:
+  reSmallVector(reAllocator& allocator);
+  reSmallVector(const reSmallVector& vector);
+  reSmallVector(reSmallVector&& vector);
+  ~reSmallVector();
+  
+  reSmallVector& operator=(const reSmallVector& vector);
+  reSmallVector& operator=(reSmallVector&& vector);
+  
+  T& operator[](reUInt index);
+  const T& operator[](reUInt index) const;
+  
+  void add(const T& value);
+  void removeAt(reUInt index);
+  bool remove(const T& value);
+  bool contains(const T& value) const;
+  void append(const reSmallVector& vector);
+  void reserve(reUInt capacity);
+  void clear();
+  bool empty() const;
+  reUInt size() const;
+  reUInt capacity() const;
+  
+  T* begin();
+  T* end();
+  const T* begin() const;
+  const T* end() const;
+  
+private:
+  bool isInline() const;
+  
+  reAllocator& _allocator;
+  T* _data;
+  reUInt _size;
+  reUInt _capacity;
+  /** The storage used until the vector grows past N elements */
+  alignas(T) unsigned char _inline[N * sizeof(T)];
+};
+
+template <class T, reUInt N>
+reSmallVector<T, N>::reSmallVector(reAllocator& allocator) : _allocator(allocator), _data((T*)_inline), _size(0), _capacity(N) {
+  // do nothing
+}
+
+template <class T, reUInt N>
+reSmallVector<T, N>::reSmallVector(const reSmallVector<T, N>& vector) : reSmallVector(vector._allocator) {
+  append(vector);
+}
+
+/**
+ * Takes over the memory of the vector if it has grown past the inline
+ * storage, otherwise the elements are copied. The vector is left empty.
+ * 
+ * @param vector The vector to move from
+ */
+
+template <class T, reUInt N>
+reSmallVector<T, N>::reSmallVector(reSmallVector<T, N>&& vector) : reSmallVector(vector._allocator) {
+  *this = std::move(vector);
+}
+
+template <class T, reUInt N>
+reSmallVector<T, N>::~reSmallVector() {
+  clear();
+  if (!isInline()) {
+    _allocator.dealloc(_data);
+  }
+}
+
+template <class T, reUInt N>
+reSmallVector<T, N>& reSmallVector<T, N>::operator=(const reSmallVector<T, N>& vector) {
+  if (&vector != this) {
+    clear();
+    append(vector);
+  }
+  return *this;
+}
+
+/**
+ * Takes over the memory of the vector if it has grown past the inline
+ * storage and both vectors share an allocator, otherwise the elements are
+ * copied. The vector moved from is left empty.
+ * 
+ * @param vector The vector to move from
+ * @return The vector moved into
+ */
+
+template <class T, reUInt N>
+reSmallVector<T, N>& reSmallVector<T, N>::operator=(reSmallVector<T, N>&& vector) {
+  if (&vector == this) {
+    return *this;
+  }
+  
+  clear();
+  if (vector.isInline() || &vector._allocator != &_allocator) {
+    append(vector);
+    vector.clear();
+    return *this;
+  }
+  
+  if (!isInline()) {
+    _allocator.dealloc(_data);
+  }
+  _data = vector._data;
+  _size = vector._size;
+  _capacity = vector._capacity;
+  vector._data = (T*)vector._inline;
+  vector._size = 0;
+  vector._capacity = N;
+  return *this;
+}
+
+template <class T, reUInt N>
+inline T& reSmallVector<T, N>::operator[](reUInt index) {
+  RE_ASSERT(index < _size)
+  return _data[index];
+}
+
+template <class T, reUInt N>
+inline const T& reSmallVector<T, N>::operator[](reUInt index) const {
+  RE_ASSERT(index < _size)
+  return _data[index];
+}
+
+template <class T, reUInt N>
+void reSmallVector<T, N>::add(const T& value) {
+  if (_size == _capacity) {
+    reserve(2 * _capacity);
+  }
+  new (&_data[_size++]) T(value);
+}
+
+/**
+ * Removes the element at the index, shifting the following elements down
+ * to keep them in order
+ * 
+ * @param index The index of the element to remove
+ */
+
+template <class T, reUInt N>
+void reSmallVector<T, N>::removeAt(reUInt index) {
+  RE_ASSERT(index < _size)
+  
+  _size--;
+  for (reUInt i = index; i < _size; i++) {
+    _data[i] = _data[i + 1];
+  }
+  _data[_size].~T();
+}
+
+template <class T, reUInt N>
+bool reSmallVector<T, N>::remove(const T& value) {
+  for (reUInt i = 0; i < _size; i++) {
+    if (_data[i] == value) {
+      removeAt(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class T, reUInt N>
+bool reSmallVector<T, N>::contains(const T& value) const {
+  for (reUInt i = 0; i < _size; i++) {
+    if (_data[i] == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class T, reUInt N>
+void reSmallVector<T, N>::append(const reSmallVector<T, N>& vector) {
+  reserve(_size + vector._size);
+  for (reUInt i = 0; i < vector._size; i++) {
+    add(vector._data[i]);
+  }
+}
+
+/**
+ * Makes room for at least the given number of elements, moving them out of
+ * the inline storage if needed
+ * 
+ * @param capacity The number of elements to make room for
+ */
+
+template <class T, reUInt N>
+void reSmallVector<T, N>::reserve(reUInt capacity) {
+  if (capacity <= _capacity) {
+    return;
+  }
+  if (capacity < 4) {
+    capacity = 4;
+  }
+  
+  T* data = (T*)_allocator.alloc(capacity * sizeof(T), __alignof(T));
+  for (reUInt i = 0; i < _size; i++) {
+    new (&data[i]) T(_data[i]);
+    _data[i].~T();
+  }
+  if (!isInline()) {
+    _allocator.dealloc(_data);
+  }
+  
+  _data = data;
+  _capacity = capacity;
+}
+
+/**
+ * Removes all elements, keeping the memory for reuse
+ */
+
+template <class T, reUInt N>
+void reSmallVector<T, N>::clear() {
+  for (reUInt i = 0; i < _size; i++) {
+    _data[i].~T();
+  }
+  _size = 0;
+}
+
+template <class T, reUInt N>
+inline bool reSmallVector<T, N>::empty() const {
+  return _size == 0;
+}
+
+template <class T, reUInt N>
+inline reUInt reSmallVector<T, N>::size() const {
+  return _size;
+}
+
+template <class T, reUInt N>
+inline reUInt reSmallVector<T, N>::capacity() const {
+  return _capacity;
+}
+
+template <class T, reUInt N>
+inline T* reSmallVector<T, N>::begin() {
+  return _data;
+}
+
+template <class T, reUInt N>
+inline T* reSmallVector<T, N>::end() {
+  return _data + _size;
+}
+
+template <class T, reUInt N>
+inline const T* reSmallVector<T, N>::begin() const {
+  return _data;
+}
+
+template <class T, reUInt N>
+inline const T* reSmallVector<T, N>::end() const {
+  return _data + _size;
+}
+
+template <class T, reUInt N>
+inline bool reSmallVector<T, N>::isInline() const {
+  return _data == (const T*)_inline;
+}
+
+#endif
@@ -6,8 +6,15 @@
 #ifndef RE_COMMON_H
 #define RE_COMMON_H
 
-/** a customizable base floating point type */
+/**
+ * a customizable base floating point type, which can be switched to double
+ * precision by defining RE_DOUBLE_PRECISION
+ */
+#ifdef RE_DOUBLE_PRECISION
+typedef double reFloat;
+#else
 typedef float reFloat;
+#endif
 
 typedef int reInt;
 
@@ -34,7 +41,9 @@ namespace re {
     BACK
   };
 
-  extern reUInt queriesMade;
+  reUInt queriesMade();
+  void resetQueriesMade();
+  void countQueries(reUInt n);
 
   typedef unsigned int ID;
 }
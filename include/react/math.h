@@ -12,5 +12,6 @@
 #include "react/Math/Transform.h"
 #include "react/Math/quat.h"
 #include "react/Math/math_ops.h"
+#include "react/Math/RigidTransform.h"
 
 #endif
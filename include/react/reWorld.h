@@ -8,16 +8,26 @@
 #include "react/common.h"
 #include "react/math.h"
 #include "react/Memory/reAllocator.h"
+#include "react/Memory/MemoryStats.h"
 #include "react/Utilities/Builder.h"
 #include "react/Collision/reSpatialQueries.h"
-#include "react/Utilities/reLinkedList.h"
+#include "react/Utilities/reDenseArray.h"
+#include "react/Entities/EntityHandle.h"
 
 class reBroadPhase;
+class reLinearAllocator;
+class reTaggedAllocator;
 class reShape;
+class reAABB;
 
 namespace re {
   class Entity;
+  class EntityRegistry;
   class Integrator;
+  class Ray;
+  class Frustum;
+  struct Segment;
+  class ShapeCache;
 }
 
 /**
@@ -35,28 +45,63 @@ public:
   reWorld& operator=(const reWorld&) = delete;
   
   void clear();
-  void add(re::Entity& entity);
+  re::EntityHandle add(re::Entity& entity);
+  reUInt add(re::Entity* const* entities, reUInt n);
   void remove(re::Entity& entity);
   void destroy(re::Entity& entity);
+  bool destroy(re::EntityHandle handle);
   void advance(reFloat dt);
   
+  // snapshots
+  reUInt snapshot(void* buffer, reUInt capacity) const;
+  bool restore(const void* data, reUInt size);
+  bool save(const char* path) const;
+  bool load(const char* path);
+  
   // getters
-  const reLinkedList<re::Entity*>& entities() const;
+  const reDenseArray<re::Entity*>& entities() const;
+  re::Entity* entity(re::EntityHandle handle) const;
+  re::EntityRegistry& registry() const;
   reAllocator& allocator() const;
+  reAllocator& allocator(re::MemoryTag tag) const;
+  re::MemoryStats memoryStats() const;
+  reLinearAllocator& frameAllocator() const;
   reBroadPhase& broadPhase() const;
   re::Integrator& integrator() const;
+  re::ShapeCache& shapes() const;
   re::Builder build();
   
   // spatial queries
   re::Entity* queryWithRay(const re::vec3& from, const re::vec3& direction, re::vec3* intersect = nullptr, re::vec3* normal = nullptr);
+  void queryWithRays(const re::Ray* rays, re::RayQuery* results, reUInt n);
+  bool queryOcclusion(const re::vec3& from, const re::vec3& direction, reFloat maxDist = RE_INFINITY);
+  reUInt queryWithAABB(const reAABB& aabb, const re::vec3& center, re::Entity** results, reUInt capacity);
+  reUInt queryWithSphere(const re::vec3& center, reFloat radius, re::Entity** results, reUInt capacity);
+  reUInt queryWithShape(const reShape& shape, const re::Transform& transform, re::Entity** results, reUInt capacity);
+  reUInt queryWithFrustum(const re::Frustum& frustum, re::Entity** results, reUInt capacity);
+  reUInt queryNearest(const re::vec3& point, re::SingleResult* results, reUInt k);
+  reUInt queryWithinRadius(const re::vec3& point, reFloat radius, re::SingleResult* results, reUInt capacity);
+  bool querySweep(const reShape& shape, const re::Segment& path, re::SweepQuery& result, const re::quat& orientation = re::quat());
 
 private:
   /** The reBroadPhase used in this reWorld */
   reBroadPhase* _broadPhase;
+  /** Issues handles for the entities in this reWorld */
+  re::EntityRegistry* _registry;
   /** The general purpose reAllocator used in this reWorld */
   reAllocator* _allocator;
+  /** The views of the general purpose allocator for each re::MemoryTag */
+  reTaggedAllocator* _taggedAllocators[re::NUM_MEMORY_TAGS];
+  /** The allocator for temporary data, reset at the start of each step */
+  reLinearAllocator* _frameAllocator;
   /** The integrator used to integrate the time step for all dynamic objects */
   re::Integrator* _integrator;
+  /** The shapes shared between entities in this reWorld */
+  re::ShapeCache* _shapes;
+  /** The number of allocations made in the most recent time step */
+  u32 _stepAllocs;
+  /** The number of deallocations made in the most recent time step */
+  u32 _stepFrees;
 };
 
 /**
@@ -70,6 +115,17 @@ inline reAllocator& reWorld::allocator() const {
   return *_allocator;
 }
 
+/**
+ * Returns the allocator used for temporary data within a time step. Its
+ * memory is released at the start of each step.
+ * 
+ * @return The reLinearAllocator used in each time step
+ */
+
+inline reLinearAllocator& reWorld::frameAllocator() const {
+  return *_frameAllocator;
+}
+
 /**
  * Returns the broad phase collision detection object
  * 
@@ -80,10 +136,30 @@ inline reBroadPhase& reWorld::broadPhase() const {
   return *_broadPhase;
 }
 
+/**
+ * Returns the registry which issues handles for the entities in the reWorld
+ * 
+ * @return The re::EntityRegistry used in the reWorld
+ */
+
+inline re::EntityRegistry& reWorld::registry() const {
+  return *_registry;
+}
+
 inline re::Integrator& reWorld::integrator() const {
   return *_integrator;
 }
 
+/**
+ * Returns the cache of shapes shared between entities in the reWorld
+ * 
+ * @return The re::ShapeCache used in the reWorld
+ */
+
+inline re::ShapeCache& reWorld::shapes() const {
+  return *_shapes;
+}
+
 inline re::Builder reWorld::build() {
   return re::Builder(*this);
 }
@@ -0,0 +1,75 @@
+#include "react/Collision/Frustum.h"
+
+using namespace re;
+
+/**
+ * Creates a frustum from its bounding planes, which should face outwards
+ *
+ * @param left The left plane
+ * @param right The right plane
+ * @param bottom The bottom plane
+ * @param top The top plane
+ * @param nearPlane The near plane
+ * @param farPlane The far plane
+ */
+
+Frustum::Frustum(const re::Plane& left, const re::Plane& right, const re::Plane& bottom, const re::Plane& top, const re::Plane& nearPlane, const re::Plane& farPlane) : _normals(), _offsets(), _corners() {
+  const re::Plane* planes[NUM_PLANES] = { &left, &right, &bottom, &top, &nearPlane, &farPlane };
+  for (reUInt i = 0; i < NUM_PLANES; i++) {
+    _normals[i] = planes[i]->normal();
+    _offsets[i] = planes[i]->offset();
+  }
+  computeCorners();
+}
+
+/**
+ * Creates the frustum visible to a perspective camera
+ *
+ * @param eye The position of the camera
+ * @param forward The viewing direction
+ * @param up The up direction of the camera
+ * @param fovy The vertical field of view in radians
+ * @param aspect The ratio of the width to the height of the view
+ * @param nearDist The distance to the near plane
+ * @param farDist The distance to the far plane
+ */
+
+Frustum::Frustum(const re::vec3& eye, const re::vec3& forward, const re::vec3& up, reFloat fovy, reFloat aspect, reFloat nearDist, reFloat farDist) : _normals(), _offsets(), _corners() {
+  const re::vec3 f = re::normalize(forward);
+  const re::vec3 r = re::normalize(re::cross(f, up));
+  const re::vec3 u = re::cross(r, f);
+  const reFloat h = nearDist * re::tan(fovy / 2.0);
+  const reFloat w = h * aspect;
+
+  // each side plane passes through the eye and an edge of the near plane
+  _normals[LEFT] = re::normalize(re::cross(u, f * nearDist - r * w));
+  _normals[RIGHT] = re::normalize(re::cross(f * nearDist + r * w, u));
+  _normals[BOTTOM] = re::normalize(re::cross(f * nearDist - u * h, r));
+  _normals[TOP] = re::normalize(re::cross(r, f * nearDist + u * h));
+  for (reUInt i = LEFT; i <= TOP; i++) {
+    _offsets[i] = re::dot(_normals[i], eye);
+  }
+
+  _normals[NEAR_SIDE] = -f;
+  _offsets[NEAR_SIDE] = -re::dot(f, eye + f * nearDist);
+  _normals[FAR_SIDE] = f;
+  _offsets[FAR_SIDE] = re::dot(f, eye + f * farDist);
+
+  computeCorners();
+}
+
+/**
+ * Computes each corner as the intersection of the three planes meeting there
+ */
+
+void Frustum::computeCorners() {
+  for (reUInt i = 0; i < NUM_CORNERS; i++) {
+    const reUInt a = (i & 1) ? RIGHT : LEFT;
+    const reUInt b = (i & 2) ? TOP : BOTTOM;
+    const reUInt c = (i & 4) ? FAR_SIDE : NEAR_SIDE;
+    const re::vec3 bc = re::cross(_normals[b], _normals[c]);
+    const re::vec3 ca = re::cross(_normals[c], _normals[a]);
+    const re::vec3 ab = re::cross(_normals[a], _normals[b]);
+    _corners[i] = (bc * _offsets[a] + ca * _offsets[b] + ab * _offsets[c]) / re::dot(_normals[a], bc);
+  }
+}
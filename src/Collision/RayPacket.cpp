@@ -0,0 +1,281 @@
+#include "react/Collision/RayPacket.h"
+
+#include "react/Entities/Entity.h"
+#include "react/Collision/Shapes/shapes.h"
+
+using namespace re;
+
+namespace {
+  /**
+   * The rays of a packet transformed into the local space of a shape. As the
+   * transform is affine, the ray parameter of any point is unchanged, so
+   * distances found in local space are also distances in world space.
+   */
+
+  struct LocalRays {
+    alignas(16) reFloat ox[RayPacket::WIDTH];
+    alignas(16) reFloat oy[RayPacket::WIDTH];
+    alignas(16) reFloat oz[RayPacket::WIDTH];
+    alignas(16) reFloat dx[RayPacket::WIDTH];
+    alignas(16) reFloat dy[RayPacket::WIDTH];
+    alignas(16) reFloat dz[RayPacket::WIDTH];
+  };
+
+#ifdef RE_SIMD
+  inline __m128 dot(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+  }
+
+  inline __m128 transformRow(const re::Transform& tm, int row, __m128 x, __m128 y, __m128 z, bool point) {
+    __m128 result = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(tm.m[row][0]), x), _mm_mul_ps(_mm_set1_ps(tm.m[row][1]), y)),
+      _mm_mul_ps(_mm_set1_ps(tm.m[row][2]), z)
+    );
+    return point ? _mm_add_ps(result, _mm_set1_ps(tm.v[row])) : result;
+  }
+
+  void toLocal(const re::Transform& inverse, const RayPacket& packet, LocalRays& local) {
+    const __m128 ox = _mm_load_ps(packet.ox);
+    const __m128 oy = _mm_load_ps(packet.oy);
+    const __m128 oz = _mm_load_ps(packet.oz);
+    const __m128 dx = _mm_load_ps(packet.dx);
+    const __m128 dy = _mm_load_ps(packet.dy);
+    const __m128 dz = _mm_load_ps(packet.dz);
+    _mm_store_ps(local.ox, transformRow(inverse, 0, ox, oy, oz, true));
+    _mm_store_ps(local.oy, transformRow(inverse, 1, ox, oy, oz, true));
+    _mm_store_ps(local.oz, transformRow(inverse, 2, ox, oy, oz, true));
+    _mm_store_ps(local.dx, transformRow(inverse, 0, dx, dy, dz, false));
+    _mm_store_ps(local.dy, transformRow(inverse, 1, dx, dy, dz, false));
+    _mm_store_ps(local.dz, transformRow(inverse, 2, dx, dy, dz, false));
+  }
+
+  reUInt sphereKernel(const re::Sphere& sphere, const LocalRays& rays, reFloat* t) {
+    const __m128 ox = _mm_load_ps(rays.ox);
+    const __m128 oy = _mm_load_ps(rays.oy);
+    const __m128 oz = _mm_load_ps(rays.oz);
+    const __m128 dx = _mm_load_ps(rays.dx);
+    const __m128 dy = _mm_load_ps(rays.dy);
+    const __m128 dz = _mm_load_ps(rays.dz);
+    const __m128 tol = _mm_set1_ps(RE_FP_TOLERANCE);
+
+    const __m128 a = dot(dx, dy, dz, dx, dy, dz);
+    const __m128 b = _mm_mul_ps(_mm_set1_ps(2.0f), dot(ox, oy, oz, dx, dy, dz));
+    const __m128 c = _mm_sub_ps(dot(ox, oy, oz, ox, oy, oz), _mm_set1_ps(re::sq(sphere.radius())));
+    const __m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(_mm_set1_ps(4.0f), _mm_mul_ps(a, c)));
+    const __m128 valid = _mm_cmpge_ps(discriminant, tol);
+
+    // consider only the smaller of the two solutions
+    const __m128 root = _mm_sqrt_ps(_mm_max_ps(discriminant, _mm_setzero_ps()));
+    const __m128 sol = _mm_div_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(b, root)), _mm_add_ps(a, a));
+    _mm_storeu_ps(t, sol);
+
+    return _mm_movemask_ps(_mm_and_ps(valid, _mm_cmpge_ps(sol, tol)));
+  }
+
+  reUInt triangleKernel(const reTriangle& triangle, const LocalRays& rays, reFloat* t) {
+    const re::vec3 v0 = triangle.vert(0);
+    const re::vec3 e1 = triangle.vert(1) - v0;
+    const re::vec3 e2 = triangle.vert(2) - v0;
+    const __m128 e1x = _mm_set1_ps(e1.x), e1y = _mm_set1_ps(e1.y), e1z = _mm_set1_ps(e1.z);
+    const __m128 e2x = _mm_set1_ps(e2.x), e2y = _mm_set1_ps(e2.y), e2z = _mm_set1_ps(e2.z);
+    const __m128 dx = _mm_load_ps(rays.dx);
+    const __m128 dy = _mm_load_ps(rays.dy);
+    const __m128 dz = _mm_load_ps(rays.dz);
+    const __m128 tol = _mm_set1_ps(RE_FP_TOLERANCE);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    // p = d x e2
+    const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    const __m128 det = dot(e1x, e1y, e1z, px, py, pz);
+    __m128 valid = _mm_cmpgt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), det), _mm_set1_ps(1e-12f));
+    const __m128 detInv = _mm_div_ps(one, det);
+
+    // s = o - v0
+    const __m128 sx = _mm_sub_ps(_mm_load_ps(rays.ox), _mm_set1_ps(v0.x));
+    const __m128 sy = _mm_sub_ps(_mm_load_ps(rays.oy), _mm_set1_ps(v0.y));
+    const __m128 sz = _mm_sub_ps(_mm_load_ps(rays.oz), _mm_set1_ps(v0.z));
+    const __m128 u = _mm_mul_ps(dot(sx, sy, sz, px, py, pz), detInv);
+    valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+    // q = s x e1
+    const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+    const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+    const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+    const __m128 v = _mm_mul_ps(dot(dx, dy, dz, qx, qy, qz), detInv);
+    valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+    const __m128 sol = _mm_mul_ps(dot(e2x, e2y, e2z, qx, qy, qz), detInv);
+    _mm_storeu_ps(t, sol);
+
+    return _mm_movemask_ps(_mm_and_ps(valid, _mm_cmpge_ps(sol, tol)));
+  }
+#else
+  void toLocal(const re::Transform& inverse, const RayPacket& packet, LocalRays& local) {
+    for (reUInt i = 0; i < RayPacket::WIDTH; i++) {
+      const re::vec3 o = inverse.applyToPoint(re::vec3(packet.ox[i], packet.oy[i], packet.oz[i]));
+      const re::vec3 d = inverse.applyToDir(re::vec3(packet.dx[i], packet.dy[i], packet.dz[i]));
+      local.ox[i] = o.x;
+      local.oy[i] = o.y;
+      local.oz[i] = o.z;
+      local.dx[i] = d.x;
+      local.dy[i] = d.y;
+      local.dz[i] = d.z;
+    }
+  }
+
+  reUInt sphereKernel(const re::Sphere& sphere, const LocalRays& rays, reFloat* t) {
+    const reFloat r2 = re::sq(sphere.radius());
+    reUInt hits = 0;
+
+    for (reUInt i = 0; i < RayPacket::WIDTH; i++) {
+      const reFloat a = rays.dx[i]*rays.dx[i] + rays.dy[i]*rays.dy[i] + rays.dz[i]*rays.dz[i];
+      const reFloat b = 2 * (rays.ox[i]*rays.dx[i] + rays.oy[i]*rays.dy[i] + rays.oz[i]*rays.dz[i]);
+      const reFloat c = rays.ox[i]*rays.ox[i] + rays.oy[i]*rays.oy[i] + rays.oz[i]*rays.oz[i] - r2;
+      const reFloat discriminant = b*b - 4*a*c;
+
+      if (discriminant >= RE_FP_TOLERANCE) {
+        // consider only the smaller of the two solutions
+        t[i] = (-b - re::sqrt(discriminant)) / (2 * a);
+        if (t[i] >= RE_FP_TOLERANCE) {
+          hits |= 1 << i;
+        }
+      }
+    }
+
+    return hits;
+  }
+
+  reUInt triangleKernel(const reTriangle& triangle, const LocalRays& rays, reFloat* t) {
+    const re::vec3 v0 = triangle.vert(0);
+    const re::vec3 e1 = triangle.vert(1) - v0;
+    const re::vec3 e2 = triangle.vert(2) - v0;
+    reUInt hits = 0;
+
+    for (reUInt i = 0; i < RayPacket::WIDTH; i++) {
+      const re::vec3 d(rays.dx[i], rays.dy[i], rays.dz[i]);
+      const re::vec3 p = re::cross(d, e2);
+      const reFloat det = re::dot(e1, p);
+      if (re::abs(det) <= 1e-12) {
+        continue;
+      }
+
+      const reFloat detInv = 1.0 / det;
+      const re::vec3 s = re::vec3(rays.ox[i], rays.oy[i], rays.oz[i]) - v0;
+      const reFloat u = re::dot(s, p) * detInv;
+      if (u < 0.0 || u > 1.0) {
+        continue;
+      }
+
+      const re::vec3 q = re::cross(s, e1);
+      const reFloat v = re::dot(d, q) * detInv;
+      if (v < 0.0 || u + v > 1.0) {
+        continue;
+      }
+
+      t[i] = re::dot(e2, q) * detInv;
+      if (t[i] >= RE_FP_TOLERANCE) {
+        hits |= 1 << i;
+      }
+    }
+
+    return hits;
+  }
+#endif
+}
+
+/**
+ * Packs the rays into a structure of arrays layout. Unused lanes are filled
+ * with copies of the first ray so that they never produce invalid values.
+ *
+ * @param rays The rays to pack
+ * @param results The results for each ray
+ * @param n The number of rays, which must be between 1 and RayPacket::WIDTH
+ */
+
+RayPacket::RayPacket(const re::Ray* rays, re::RayQuery* results, reUInt n) : size(n), lanes((1 << n) - 1), rays(rays), results(results) {
+  RE_ASSERT(n > 0 && n <= WIDTH)
+
+  for (reUInt i = 0; i < WIDTH; i++) {
+    const re::Ray& ray = rays[(i < n) ? i : 0];
+    ox[i] = ray.origin().x;
+    oy[i] = ray.origin().y;
+    oz[i] = ray.origin().z;
+    dx[i] = ray.dir().x;
+    dy[i] = ray.dir().y;
+    dz[i] = ray.dir().z;
+  }
+}
+
+/**
+ * Records an intersection for the ray in the given lane, if it lies within the
+ * ray's interval and is closer than the current result for the ray
+ *
+ * @param lane The lane of the ray
+ * @param t The distance along the ray to the intersection
+ * @param entity The entity intersected
+ */
+
+void RayPacket::record(reUInt lane, reFloat t, re::Entity& entity) {
+  re::RayQuery& result = results[lane];
+  if (t >= result.depth || t < rays[lane].tMin() || t > rays[lane].tMax()) {
+    return;
+  }
+
+  const re::vec3 dir(dx[lane], dy[lane], dz[lane]);
+  result.depth = t;
+  result.point = re::vec3(ox[lane], oy[lane], oz[lane]) + dir * t;
+  result.entity = &entity;
+
+  const re::Transform& transform = entity.shapeTransform();
+  switch (entity.baseShape().type()) {
+    case reShape::SPHERE:
+      result.normal = re::normalize(transform.applyToDir(entity.shapeTransformInv().applyToPoint(result.point)));
+      break;
+
+    case reShape::TRIANGLE:
+      result.normal = re::normalize(transform.applyToDir(((const reTriangle&)entity.baseShape()).faceNorm()));
+      if (re::dot(result.normal, dir) > 0.0) {
+        result.normal = -result.normal;
+      }
+      break;
+
+    default:
+      RE_IMPOSSIBLE
+  }
+}
+
+bool re::hasPacketKernel(const reShape& shape) {
+  return shape.type() == reShape::SPHERE || shape.type() == reShape::TRIANGLE;
+}
+
+/**
+ * Tests the rays in the packet against a shape. The shape must not be a proxy,
+ * instead any proxies should be flattened into the inverse transform.
+ *
+ * @param shape The shape to test, which must have a packet kernel
+ * @param inverse The transform from world space to the shape's space
+ * @param packet The rays to test
+ * @param mask The lanes to test
+ * @param t The distance to the intersection for each lane that hit
+ * @return The mask of lanes which intersect the shape
+ */
+
+reUInt re::intersects(const reShape& shape, const re::Transform& inverse, const re::RayPacket& packet, reUInt mask, reFloat* t) {
+  LocalRays local;
+  toLocal(inverse, packet, local);
+
+  switch (shape.type()) {
+    case reShape::SPHERE:
+      return sphereKernel((const re::Sphere&)shape, local, t) & mask;
+
+    case reShape::TRIANGLE:
+      return triangleKernel((const reTriangle&)shape, local, t) & mask;
+
+    default:
+      RE_IMPOSSIBLE
+      return 0;
+  }
+}
@@ -4,11 +4,11 @@
 
 using namespace re;
 
-ShapeProxy::ShapeProxy(reShape* shape) : _transform(), _shape(shape) {
+ShapeProxy::ShapeProxy(const reShape* shape) : _transform(), _transformInv(), _shape(shape) {
   // do nothing
 }
 
-ShapeProxy::ShapeProxy(reShape* shape, const re::Transform& transform) : _transform(transform), _shape(shape) {
+ShapeProxy::ShapeProxy(const reShape* shape, const re::Transform& transform) : _transform(transform), _transformInv(re::inverse(transform)), _shape(shape) {
   // do nothing
 }
 
@@ -18,7 +18,7 @@ ShapeProxy::~ShapeProxy() {
 
 bool ShapeProxy::containsPoint(const re::vec3& point) const {
   if (_shape != nullptr) {
-    return _shape->containsPoint(re::inverse(_transform), point);
+    return _shape->containsPoint(_transformInv, point);
   }
   return false;
 }
@@ -10,6 +10,11 @@ Sphere::Sphere(const Sphere& sphere) : reShape() {
   _shell = sphere.radius();
 }
 
+Sphere& Sphere::operator=(const Sphere& sphere) {
+  reShape::operator=(sphere);
+  return *this;
+}
+
 Sphere::~Sphere() {
   // do nothing
 }
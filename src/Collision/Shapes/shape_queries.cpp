@@ -2,10 +2,17 @@
 
 #include "react/Collision/reSpatialQueries.h"
 
-bool sphereRayIntersect(const re::Sphere& sphere, const re::Ray& ray, re::Intersect& intersect) {
-  const reFloat a = re::lengthSq(ray.dir());
-  const reFloat b = 2 * re::dot(ray.origin(), ray.dir());
-  const reFloat c = re::lengthSq(ray.origin()) - re::sq(sphere.radius());
+/**
+ * Computes the ray parameter at which the ray enters the sphere, returning
+ * false if there is no such point in front of the ray origin. The direction
+ * need not be normalized, in which case the parameter is in units of its
+ * length.
+ */
+
+bool sphereRayDistance(const re::Sphere& sphere, const re::vec3& origin, const re::vec3& dir, reFloat& t) {
+  const reFloat a = re::lengthSq(dir);
+  const reFloat b = 2 * re::dot(origin, dir);
+  const reFloat c = re::lengthSq(origin) - re::sq(sphere.radius());
   const reFloat discriminant = b*b - 4*a*c;
 
   if (discriminant < RE_FP_TOLERANCE) {
@@ -13,20 +20,81 @@ bool sphereRayIntersect(const re::Sphere& sphere, const re::Ray& ray, re::Inters
   }
   
   // consider only the smaller of the two solutions
-  const reFloat solA = (-b - re::sqrt(discriminant)) / (2.0 * a);
+  t = (-b - re::sqrt(discriminant)) / (2.0 * a);
   
   // invalid solutions
-  if (solA < RE_FP_TOLERANCE) {
+  return t >= RE_FP_TOLERANCE;
+}
+
+bool sphereRayIntersect(const re::Sphere& sphere, const re::Ray& ray, re::Intersect& intersect) {
+  reFloat t;
+  if (!sphereRayDistance(sphere, ray.origin(), ray.dir(), t)) {
     return false;
   }
   
-  intersect.point = ray.origin() + ray.dir() * solA;
-  intersect.normal = re::normalize(ray.origin() + ray.dir() * solA);
+  intersect.point = ray.origin() + ray.dir() * t;
+  intersect.normal = re::normalize(intersect.point);
   intersect.depth = re::length(intersect.point - ray.origin());
   
   return true;
 }
 
+/**
+ * Computes the ray parameter at which the ray crosses the triangle using the
+ * Moller-Trumbore algorithm, returning false if the ray misses. The direction
+ * need not be normalized.
+ */
+
+bool triangleRayDistance(const reTriangle& triangle, const re::vec3& origin, const re::vec3& dir, reFloat& t) {
+  const re::vec3 v0 = triangle.vert(0);
+  const re::vec3 e1 = triangle.vert(1) - v0;
+  const re::vec3 e2 = triangle.vert(2) - v0;
+  const re::vec3 p = re::cross(dir, e2);
+  const reFloat det = re::dot(e1, p);
+
+  // the ray is parallel to the triangle
+  if (re::abs(det) <= 1e-12) {
+    return false;
+  }
+
+  const reFloat detInv = 1.0 / det;
+  const re::vec3 s = origin - v0;
+  const reFloat u = re::dot(s, p) * detInv;
+  if (u < 0.0 || u > 1.0) {
+    return false;
+  }
+
+  const re::vec3 q = re::cross(s, e1);
+  const reFloat v = re::dot(dir, q) * detInv;
+  if (v < 0.0 || u + v > 1.0) {
+    return false;
+  }
+
+  t = re::dot(e2, q) * detInv;
+  return t >= RE_FP_TOLERANCE;
+}
+
+/**
+ * Computes the intersection between a triangle and a ray. The normal is chosen
+ * to face the ray.
+ */
+
+bool triangleRayIntersect(const reTriangle& triangle, const re::Ray& ray, re::Intersect& intersect) {
+  reFloat t;
+  if (!triangleRayDistance(triangle, ray.origin(), ray.dir(), t)) {
+    return false;
+  }
+
+  intersect.point = ray.origin() + ray.dir() * t;
+  intersect.normal = triangle.faceNorm();
+  if (re::dot(intersect.normal, ray.dir()) > 0.0) {
+    intersect.normal = -intersect.normal;
+  }
+  intersect.depth = t;
+
+  return true;
+}
+
 /**
  * Computes the intersection data between a transformed shape and a
  * ray object
@@ -38,21 +106,100 @@ bool sphereRayIntersect(const re::Sphere& sphere, const re::Ray& ray, re::Inters
  */
 
 bool re::intersects(const reShape& shape, const re::Transform& transform, const re::Ray& ray, re::Intersect& intersect) {
+  if (shape.type() == reShape::PROXY) {
+    const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+    return re::intersects(*proxy.shape(), transform * proxy.transform(), ray, intersect);
+  }
+
+  return re::intersects(shape, transform, re::inverse(transform), ray, intersect);
+}
+
+/**
+ * Computes the intersection data between a transformed shape and a
+ * ray object, using a precomputed inverse of the transform
+ *
+ * @param shape The shape to test
+ * @param transform The transform of the shape
+ * @param inverse The inverse of the shape transform
+ * @param ray The ray to test with
+ * @param intersect A struct containing data on the intersection
+ */
+
+bool re::intersects(const reShape& shape, const re::Transform& transform, const re::Transform& inverse, const re::Ray& ray, re::Intersect& intersect) {
   // TODO convert back to virtual methods, faster than switch
   switch (shape.type()) {
     case reShape::SPHERE:
-      if (sphereRayIntersect((const re::Sphere&)shape, re::Ray(ray, re::inverse(transform)), intersect)) {
+      if (sphereRayIntersect((const re::Sphere&)shape, re::Ray(ray, inverse), intersect)) {
+        intersect.point = transform.applyToPoint(intersect.point);
+        intersect.normal = re::normalize(transform.applyToDir(intersect.normal));
+        intersect.depth = re::length(ray.origin() - intersect.point);
+        return intersect.depth >= ray.tMin() && intersect.depth <= ray.tMax();
+      }
+      return false;
+
+    case reShape::TRIANGLE:
+      if (triangleRayIntersect((const reTriangle&)shape, re::Ray(ray, inverse), intersect)) {
         intersect.point = transform.applyToPoint(intersect.point);
         intersect.normal = re::normalize(transform.applyToDir(intersect.normal));
         intersect.depth = re::length(ray.origin() - intersect.point);
-        return true;
+        return intersect.depth >= ray.tMin() && intersect.depth <= ray.tMax();
       }
       return false;
 
     case reShape::PROXY:
       {
         const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
-        return (re::intersects(*proxy.shape(), transform * proxy.transform(), ray, intersect)); 
+        return re::intersects(*proxy.shape(), transform * proxy.transform(), proxy.transformInv() * inverse, ray, intersect);
+      }
+
+    default:
+      RE_IMPOSSIBLE
+      throw 0;
+  }
+}
+
+/**
+ * Computes the intersection data between a shape and a ray object, where the
+ * shape is placed by a rigid transform. The inverse is the transpose of the
+ * rotation, avoiding a general matrix inversion.
+ *
+ * @param shape The shape to test
+ * @param transform The rigid transform of the shape
+ * @param ray The ray to test with
+ * @param intersect A struct containing data on the intersection
+ */
+
+bool re::intersects(const reShape& shape, const re::RigidTransform& transform, const re::Ray& ray, re::Intersect& intersect) {
+  const re::Transform tm = re::toTransform(transform);
+  return re::intersects(shape, tm, re::rigidInverse(tm), ray, intersect);
+}
+
+/**
+ * Returns true if the transformed shape blocks the ray within its interval
+ * and before the maximum distance. Unlike re::intersects, no intersection point or normal is
+ * computed. The ray is moved into the shape's local space without
+ * normalizing its direction, so distances remain in world units.
+ *
+ * @param shape The shape to test
+ * @param inverse The inverse of the shape transform
+ * @param ray The ray to test with
+ * @param maxDist The distance along the ray beyond which shapes are ignored
+ * @return True if the shape blocks the ray
+ */
+
+bool re::occludes(const reShape& shape, const re::Transform& inverse, const re::Ray& ray, reFloat maxDist) {
+  reFloat t;
+  switch (shape.type()) {
+    case reShape::SPHERE:
+      return sphereRayDistance((const re::Sphere&)shape, inverse.applyToPoint(ray.origin()), inverse.applyToDir(ray.dir()), t) && t >= ray.tMin() && t <= maxDist && t <= ray.tMax();
+
+    case reShape::TRIANGLE:
+      return triangleRayDistance((const reTriangle&)shape, inverse.applyToPoint(ray.origin()), inverse.applyToDir(ray.dir()), t) && t >= ray.tMin() && t <= maxDist && t <= ray.tMax();
+
+    case reShape::PROXY:
+      {
+        const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+        return re::occludes(*proxy.shape(), proxy.transformInv() * inverse, ray, maxDist);
       }
 
     default:
@@ -109,15 +256,52 @@ re::Location re::relativeToPlane(const reShape& shape, const re::Plane& plane) {
  */
 
 re::Location re::relativeToPlane(const reShape& shape, const re::Transform& transform, const re::Plane& plane) {
+  if (shape.type() == reShape::PROXY) {
+    const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+    return re::relativeToPlane(*proxy.shape(), transform * proxy.transform(), plane);
+  }
+
+  return re::relativeToPlane(shape, transform, re::inverse(transform), plane);
+}
+
+/**
+ * Returns an enum describing the relative location of the shape in the
+ * given plane, using a precomputed inverse of the transform
+ *
+ * @param shape The shape object
+ * @param transform The transform of the shape
+ * @param inverse The inverse of the shape transform
+ * @param plane The plane object
+ */
+
+re::Location re::relativeToPlane(const reShape& shape, const re::Transform& transform, const re::Transform& inverse, const re::Plane& plane) {
   switch (shape.type()) {
     case reShape::SPHERE:
-      return re::relativeToPlane(shape, re::Plane(plane, re::inverse(transform)));
+    case reShape::TRIANGLE:
+      return re::relativeToPlane(shape, re::Plane(plane, inverse));
       break;
 
+    case reShape::PLANE:
+      {
+        // planes which are not parallel always cross
+        const re::Plane surface((const re::Plane&)shape, transform);
+        if (re::lengthSq(re::cross(surface.normal(), plane.normal())) > 1e-12) {
+          return re::INTERSECT;
+        }
+
+        const reFloat dist = re::dot(plane.normal(), surface.normal() * surface.offset()) - plane.offset();
+        if (dist - shape.shell() > RE_FP_TOLERANCE) {
+          return re::FRONT;
+        } else if (dist + shape.shell() < RE_FP_TOLERANCE) {
+          return re::BACK;
+        }
+        return re::INTERSECT;
+      }
+
     case reShape::PROXY:
       {
         const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
-        return re::relativeToPlane(*proxy.shape(), transform * proxy.transform(), plane);
+        return re::relativeToPlane(*proxy.shape(), transform * proxy.transform(), proxy.transformInv() * inverse, plane);
       }
       break;
 
@@ -127,13 +311,102 @@ re::Location re::relativeToPlane(const reShape& shape, const re::Transform& tran
   }
 }
 
+/**
+ * Returns an enum describing the relative location of the shape in the
+ * given plane, where the shape is placed by a rigid transform
+ *
+ * @param shape The shape object
+ * @param transform The rigid transform of the shape
+ * @param plane The plane object
+ */
+
+re::Location re::relativeToPlane(const reShape& shape, const re::RigidTransform& transform, const re::Plane& plane) {
+  const re::Transform tm = re::toTransform(transform);
+  return re::relativeToPlane(shape, tm, re::rigidInverse(tm), plane);
+}
+
+/**
+ * Returns the largest factor by which the transform stretches any direction.
+ * The result is exact for rotations combined with axis aligned scalings.
+ */
+
+reFloat scaleOf(const re::Transform& transform) {
+  const re::mat3& m = transform.m;
+  reFloat scaleSq = 0.0;
+  for (reUInt i = 0; i < 3; i++) {
+    scaleSq = re::max(scaleSq, re::lengthSq(re::vec3(m[0][i], m[1][i], m[2][i])));
+    scaleSq = re::max(scaleSq, re::lengthSq(re::vec3(m[i][0], m[i][1], m[i][2])));
+  }
+  return re::sqrt(scaleSq);
+}
+
+/**
+ * Places the vertices of the triangle with the transform in a single batch
+ */
+
+void placeVerts(const reTriangle& triangle, const re::Transform& transform, re::vec3* verts) {
+  for (reUInt i = 0; i < 3; i++) {
+    verts[i] = triangle.vert(i);
+  }
+  transform.applyToPoints(verts, verts, 3);
+}
+
+/**
+ * Computes the point on the triangle with the given vertices which is closest
+ * to the point
+ */
+
+const re::vec3 closestPointOnTriangle(const re::vec3& a, const re::vec3& b, const re::vec3& c, const re::vec3& p) {
+  const re::vec3 ab = b - a;
+  const re::vec3 ac = c - a;
+  const re::vec3 ap = p - a;
+  const reFloat d1 = re::dot(ab, ap);
+  const reFloat d2 = re::dot(ac, ap);
+  if (d1 <= 0.0 && d2 <= 0.0) {
+    return a;
+  }
+
+  const re::vec3 bp = p - b;
+  const reFloat d3 = re::dot(ab, bp);
+  const reFloat d4 = re::dot(ac, bp);
+  if (d3 >= 0.0 && d4 <= d3) {
+    return b;
+  }
+
+  const reFloat vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+    return a + ab * (d1 / (d1 - d3));
+  }
+
+  const re::vec3 cp = p - c;
+  const reFloat d5 = re::dot(ab, cp);
+  const reFloat d6 = re::dot(ac, cp);
+  if (d6 >= 0.0 && d5 <= d6) {
+    return c;
+  }
+
+  const reFloat vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+    return a + ac * (d2 / (d2 - d6));
+  }
+
+  const reFloat va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+    return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+  }
+
+  const reFloat denom = 1.0 / (va + vb + vc);
+  return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
 bool intersects3(const re::Sphere& A, const re::Transform& tA, const re::Sphere& B, const re::Transform& tB, re::Intersect& intersect) {
-  const reFloat minDist = A.radius() + B.radius();
+  const reFloat radiusA = A.radius() * scaleOf(tA);
+  const reFloat minDist = radiusA + B.radius() * scaleOf(tB);
   bool contact = (re::lengthSq(tA.v - tB.v) < re::sq(minDist));
   if (contact) {
     intersect.point = (tA.v + tB.v) / 2.0;
     intersect.normal = re::normalize(tA.v - tB.v);
-    intersect.depth = A.radius() - re::length(tA.v - intersect.point);
+    intersect.depth = radiusA - re::length(tA.v - intersect.point);
   }
   
   return contact;
@@ -142,10 +415,11 @@ bool intersects3(const re::Sphere& A, const re::Transform& tA, const re::Sphere&
 bool intersects3(const re::Plane& A, const re::Transform& tA, const re::Sphere& B, const re::Transform& tB, re::Intersect& intersect) {
   const re::vec3 norm = tA.applyToDir(A.normal());
   const reFloat dist = re::dot(norm, tB.v) - re::dot(norm, tA.v) - A.offset();
-  if (re::abs(dist) < B.shell() + A.shell()) {
-    intersect.normal = re::sign(re::dot(norm, tB.v - tA.v)) * norm;
-    intersect.depth = B.shell() + A.shell() - re::abs(dist);
-    intersect.point = intersect.normal * (B.shell() - intersect.depth) + tB.v;
+  const reFloat radius = B.shell() * scaleOf(tB);
+  if (re::abs(dist) < radius + A.shell()) {
+    intersect.normal = -re::sign(dist) * norm;
+    intersect.depth = radius + A.shell() - re::abs(dist);
+    intersect.point = intersect.normal * (radius - intersect.depth) + tB.v;
 
     return true;
   }
@@ -161,8 +435,122 @@ bool intersects3(const re::Sphere& A, const re::Transform& tA, const re::Plane&
   return contact;
 }
 
-/// TODO how to handle plane-plane collisions?
-bool intersects3(const re::Plane&, const re::Transform&, const re::Plane&, const re::Transform&, re::Intersect&) {
+/**
+ * Planes which are not parallel always cross. Parallel planes overlap if
+ * their shells do.
+ */
+
+bool intersects3(const re::Plane& A, const re::Transform& tA, const re::Plane& B, const re::Transform& tB, re::Intersect& intersect) {
+  const re::Plane planeA(A, tA);
+  const re::Plane planeB(B, tB);
+  const re::vec3 dir = re::cross(planeA.normal(), planeB.normal());
+  const reFloat dirSq = re::lengthSq(dir);
+
+  if (dirSq > 1e-12) {
+    // a point on the line where the planes cross
+    intersect.point = (re::cross(planeB.normal(), dir) * planeA.offset() + re::cross(dir, planeA.normal()) * planeB.offset()) / dirSq;
+    intersect.normal = planeB.normal();
+    intersect.depth = A.shell() + B.shell();
+    return true;
+  }
+
+  const re::vec3 pointB = planeB.normal() * planeB.offset();
+  const reFloat dist = re::dot(planeA.normal(), pointB) - planeA.offset();
+  if (re::abs(dist) < A.shell() + B.shell()) {
+    intersect.normal = -re::sign(dist) * planeA.normal();
+    intersect.depth = A.shell() + B.shell() - re::abs(dist);
+    intersect.point = pointB + intersect.normal * (B.shell() - intersect.depth);
+    return true;
+  }
+
+  return false;
+}
+
+bool intersects3(const re::Sphere& A, const re::Transform& tA, const reTriangle& B, const re::Transform& tB, re::Intersect& intersect) {
+  re::vec3 verts[3];
+  placeVerts(B, tB, &verts[0]);
+  const re::vec3 closest = closestPointOnTriangle(verts[0], verts[1], verts[2], tA.v);
+  const re::vec3 offset = tA.v - closest;
+  const reFloat reach = A.radius() * scaleOf(tA) + B.shell();
+  const reFloat distSq = re::lengthSq(offset);
+
+  if (distSq >= re::sq(reach)) {
+    return false;
+  }
+
+  const reFloat dist = re::sqrt(distSq);
+  if (dist > 0.0) {
+    intersect.normal = offset / dist;
+  } else {
+    // the sphere center lies on the triangle
+    intersect.normal = re::normalize(tB.applyToDir(B.faceNorm()));
+  }
+  intersect.point = closest;
+  intersect.depth = reach - dist;
+  return true;
+}
+
+bool intersects3(const reTriangle& A, const re::Transform& tA, const re::Sphere& B, const re::Transform& tB, re::Intersect& intersect) {
+  const bool contact = intersects3(B, tB, A, tA, intersect);
+  if (contact) {
+    intersect.normal *= -1;
+  }
+  return contact;
+}
+
+/**
+ * The triangle overlaps the plane if its vertices are not all further than
+ * the combined shells on the same side of the plane
+ */
+
+bool intersects3(const re::Plane& A, const re::Transform& tA, const reTriangle& B, const re::Transform& tB, re::Intersect& intersect) {
+  const re::Plane plane(A, tA);
+  const reFloat shells = A.shell() + B.shell();
+  reFloat minV = RE_INFINITY;
+  reFloat maxV = RE_NEGATIVE_INFINITY;
+  re::vec3 minVert, maxVert;
+  re::vec3 verts[3];
+  placeVerts(B, tB, &verts[0]);
+  for (reUInt i = 0; i < 3; i++) {
+    const re::vec3& vert = verts[i];
+    const reFloat dist = re::dot(plane.normal(), vert) - plane.offset();
+    if (dist < minV) {
+      minV = dist;
+      minVert = vert;
+    }
+    if (dist > maxV) {
+      maxV = dist;
+      maxVert = vert;
+    }
+  }
+
+  if (minV >= shells || maxV <= -shells) {
+    return false;
+  }
+
+  // the triangle is pushed back to the side holding most of it
+  if (minV + maxV >= 0.0) {
+    intersect.normal = -plane.normal();
+    intersect.depth = shells - minV;
+    intersect.point = minVert;
+  } else {
+    intersect.normal = plane.normal();
+    intersect.depth = shells + maxV;
+    intersect.point = maxVert;
+  }
+  return true;
+}
+
+bool intersects3(const reTriangle& A, const re::Transform& tA, const re::Plane& B, const re::Transform& tB, re::Intersect& intersect) {
+  const bool contact = intersects3(B, tB, A, tA, intersect);
+  if (contact) {
+    intersect.normal *= -1;
+  }
+  return contact;
+}
+
+/// TODO how to handle triangle-triangle collisions?
+bool intersects3(const reTriangle&, const re::Transform&, const reTriangle&, const re::Transform&, re::Intersect&) {
   RE_NOT_IMPLEMENTED
   return false;
 }
@@ -178,12 +566,29 @@ bool intersects2(const S& A, const re::Transform& tA, const reShape& B, const re
       return intersects3(A, tA, (const re::Plane&)B, tB, intersect);
       break;
 
+    case reShape::TRIANGLE:
+      return intersects3(A, tA, (const reTriangle&)B, tB, intersect);
+      break;
+
     default:
       RE_NOT_IMPLEMENTED
       throw 0;
   }
 }
 
+/**
+ * Returns true if the two shapes overlap, and fills the intersect with the
+ * contact point, penetration depth and contact normal. The normal always
+ * points from shape B towards shape A, so swapping the shapes reverses it.
+ *
+ * @param A The first shape
+ * @param tA The transform of the first shape
+ * @param B The second shape
+ * @param tB The transform of the second shape
+ * @param intersect The intersect result struct
+ * @return True if the shapes overlap
+ */
+
 bool re::intersects(const reShape& A, const re::Transform& tA, const reShape& B, const re::Transform& tB, re::Intersect& intersect) {
   switch (A.type()) {
     case reShape::SPHERE:
@@ -194,9 +599,371 @@ bool re::intersects(const reShape& A, const re::Transform& tA, const reShape& B,
       return intersects2((const re::Plane&)A, tA, B, tB, intersect);
       break;
 
+    case reShape::TRIANGLE:
+      return intersects2((const reTriangle&)A, tA, B, tB, intersect);
+      break;
+
     default:
       RE_NOT_IMPLEMENTED
       throw 0;
   }
 }
 
+
+/**
+ * Computes a sphere enclosing the transformed shape. The shell is grown by
+ * the largest stretch of the transform, so scaled spheres remain enclosed.
+ *
+ * @param shape The shape to enclose
+ * @param transform The transform of the shape
+ * @param center The center of the bounding sphere
+ * @param radius The radius of the bounding sphere
+ */
+
+void re::boundingSphere(const reShape& shape, const re::Transform& transform, re::vec3& center, reFloat& radius) {
+  if (shape.type() == reShape::PROXY) {
+    const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+    re::boundingSphere(*proxy.shape(), transform * proxy.transform(), center, radius);
+    return;
+  }
+
+  center = transform.applyToPoint(shape.center());
+  radius = 0.0;
+  for (reUInt i = 0; i < shape.numVerts(); i++) {
+    radius = re::max(radius, re::length(transform.applyToPoint(shape.vert(i)) - center));
+  }
+  radius += shape.shell() * scaleOf(transform);
+}
+
+/**
+ * Computes the first time at which a sphere moving with the given motion
+ * touches a stationary sphere. Spheres which overlap initially touch at time 0.
+ */
+
+bool sweepSphereSphere(const re::vec3& center, reFloat radius, const re::vec3& motion, const re::vec3& targetCenter, reFloat targetRadius, reFloat maxTime, reFloat& time, re::Intersect& intersect) {
+  const re::vec3 s = center - targetCenter;
+  const reFloat sumRadii = radius + targetRadius;
+  const reFloat c = re::lengthSq(s) - sumRadii * sumRadii;
+
+  if (c <= 0.0) {
+    time = 0.0;
+  } else {
+    const reFloat a = re::lengthSq(motion);
+    const reFloat b = re::dot(s, motion);
+    // not moving, or moving away from the target
+    if (a == 0.0 || b >= 0.0) {
+      return false;
+    }
+
+    const reFloat discriminant = b*b - a*c;
+    if (discriminant < 0.0) {
+      return false;
+    }
+
+    time = (-b - re::sqrt(discriminant)) / a;
+    if (time > maxTime) {
+      return false;
+    }
+  }
+
+  const re::vec3 offset = center + motion * time - targetCenter;
+  intersect.normal = re::lengthSq(offset) > 0.0 ? re::normalize(offset) : -re::normalize(motion);
+  intersect.point = targetCenter + intersect.normal * targetRadius;
+  intersect.depth = re::length(motion) * time;
+  return true;
+}
+
+/**
+ * Computes the first time at which a sphere moving with the given motion
+ * touches the shell of a stationary plane
+ */
+
+bool sweepSpherePlane(const re::vec3& center, reFloat radius, const re::vec3& motion, const re::Plane& plane, reFloat shell, reFloat maxTime, reFloat& time, re::Intersect& intersect) {
+  const reFloat dist = re::dot(plane.normal(), center) - plane.offset();
+  const reFloat side = dist >= 0.0 ? 1.0 : -1.0;
+  const reFloat gap = re::abs(dist) - radius - shell;
+
+  if (gap <= 0.0) {
+    time = 0.0;
+  } else {
+    const reFloat approach = -side * re::dot(plane.normal(), motion);
+    if (approach <= 0.0) {
+      return false;
+    }
+
+    time = gap / approach;
+    if (time > maxTime) {
+      return false;
+    }
+  }
+
+  intersect.normal = plane.normal() * side;
+  intersect.point = center + motion * time - intersect.normal * radius;
+  intersect.depth = re::length(motion) * time;
+  return true;
+}
+
+/**
+ * Computes the first time at which a sphere moving with the given motion
+ * touches the shell of a stationary triangle. The sphere may first touch the
+ * face of the triangle, one of its edges or one of its vertices, so each is
+ * tried in turn and the earliest impact is kept.
+ */
+
+bool sweepSphereTriangle(const re::vec3& center, reFloat radius, const re::vec3& motion, const re::vec3* verts, reFloat shell, reFloat maxTime, reFloat& time, re::Intersect& intersect) {
+  const reFloat reach = radius + shell;
+  const re::vec3 closest = closestPointOnTriangle(verts[0], verts[1], verts[2], center);
+  if (re::lengthSq(center - closest) <= reach * reach) {
+    time = 0.0;
+    const re::vec3 offset = center - closest;
+    intersect.normal = re::lengthSq(offset) > 0.0 ? re::normalize(offset) : -re::normalize(motion);
+    intersect.point = closest + intersect.normal * shell;
+    intersect.depth = 0.0;
+    return true;
+  }
+
+  bool hit = false;
+  time = maxTime;
+
+  // the face, which is only touched if the center lands inside the triangle
+  const re::vec3 norm = re::normalize(re::cross(verts[1] - verts[0], verts[2] - verts[0]));
+  const reFloat dist = re::dot(norm, center - verts[0]);
+  const reFloat side = dist >= 0.0 ? 1.0 : -1.0;
+  const reFloat approach = -side * re::dot(norm, motion);
+  if (approach > 0.0) {
+    const reFloat t = (re::abs(dist) - reach) / approach;
+    // the point below the center on the plane of the triangle at the impact
+    const re::vec3 landing = center + motion * t - norm * (side * reach);
+    if (t >= 0.0 && t <= time && re::lengthSq(closestPointOnTriangle(verts[0], verts[1], verts[2], landing) - landing) <= RE_FP_TOLERANCE * RE_FP_TOLERANCE) {
+      hit = true;
+      time = t;
+      intersect.normal = norm * side;
+      intersect.point = landing + intersect.normal * shell;
+    }
+  }
+
+  // the edges, treated as cylinders around each segment
+  const reFloat mm = re::dot(motion, motion);
+  for (reUInt i = 0; i < 3; i++) {
+    const re::vec3& a = verts[i];
+    const re::vec3 d = verts[(i + 1) % 3] - a;
+    const re::vec3 p = center - a;
+    const reFloat dd = re::dot(d, d);
+    const reFloat md = re::dot(motion, d);
+    const reFloat nd = re::dot(p, d);
+    const reFloat qa = dd * mm - md * md;
+    const reFloat qb = dd * re::dot(p, motion) - nd * md;
+    const reFloat qc = dd * (re::dot(p, p) - reach * reach) - nd * nd;
+    const reFloat discriminant = qb * qb - qa * qc;
+
+    // moving parallel to the edge, so the vertices are touched first
+    if (qa <= 1e-12 * dd * mm || discriminant < 0.0) {
+      continue;
+    }
+
+    const reFloat t = (-qb - re::sqrt(discriminant)) / qa;
+    const reFloat u = (nd + md * t) / dd;
+    if (t >= 0.0 && t <= time && u >= 0.0 && u <= 1.0) {
+      hit = true;
+      time = t;
+      const re::vec3 onEdge = a + d * u;
+      intersect.normal = re::normalize(center + motion * t - onEdge);
+      intersect.point = onEdge + intersect.normal * shell;
+    }
+  }
+
+  // the vertices
+  for (reUInt i = 0; i < 3; i++) {
+    reFloat t;
+    re::Intersect vertIntersect;
+    if (sweepSphereSphere(center, radius, motion, verts[i], shell, time, t, vertIntersect) && t <= time) {
+      hit = true;
+      time = t;
+      intersect = vertIntersect;
+    }
+  }
+
+  if (hit) {
+    intersect.depth = re::length(motion) * time;
+  }
+  return hit;
+}
+
+/**
+ * Computes the first time at which a triangle moving with the given motion
+ * touches the shell of a stationary plane. A triangle crossing the plane
+ * touches it at time 0.
+ */
+
+bool sweepTrianglePlane(const re::vec3* verts, reFloat shell, const re::vec3& motion, const re::Plane& plane, reFloat planeShell, reFloat maxTime, reFloat& time, re::Intersect& intersect) {
+  reFloat minV = RE_INFINITY;
+  reFloat maxV = RE_NEGATIVE_INFINITY;
+  for (reUInt i = 0; i < 3; i++) {
+    const reFloat dist = re::dot(plane.normal(), verts[i]) - plane.offset();
+    minV = re::min(minV, dist);
+    maxV = re::max(maxV, dist);
+  }
+
+  if (minV < shell + planeShell && maxV > -shell - planeShell) {
+    time = 0.0;
+    intersect.normal = (minV + maxV >= 0.0) ? plane.normal() : -plane.normal();
+    intersect.point = verts[0] - intersect.normal * shell;
+    intersect.depth = 0.0;
+    return true;
+  }
+
+  // every vertex is on the same side, so the nearest touches first
+  bool hit = false;
+  time = maxTime;
+  for (reUInt i = 0; i < 3; i++) {
+    reFloat t;
+    re::Intersect vertIntersect;
+    if (sweepSpherePlane(verts[i], shell, motion, plane, planeShell, time, t, vertIntersect) && t <= time) {
+      hit = true;
+      time = t;
+      intersect = vertIntersect;
+    }
+  }
+  return hit;
+}
+
+/**
+ * Returns true if the transform scales every direction equally, so that
+ * spheres remain spheres
+ */
+
+bool isUniform(const re::Transform& transform) {
+  const re::mat3& m = transform.m;
+  reFloat minSq = RE_INFINITY;
+  reFloat maxSq = 0.0;
+  for (reUInt i = 0; i < 3; i++) {
+    const reFloat lengthSq = re::lengthSq(re::vec3(m[0][i], m[1][i], m[2][i]));
+    minSq = re::min(minSq, lengthSq);
+    maxSq = re::max(maxSq, lengthSq);
+  }
+  return maxSq - minSq <= RE_FP_TOLERANCE * maxSq;
+}
+
+/**
+ * Sweeps the target backwards against the shape, which gives the same time
+ * of impact, then moves the result back into the frame of the moving shape
+ */
+
+bool sweepReversed(const reShape& shape, const re::Transform& transform, const re::vec3& motion, const reShape& target, const re::Transform& targetTransform, reFloat maxTime, reFloat& time, re::Intersect& intersect) {
+  if (!re::sweep(target, targetTransform, -motion, shape, transform, maxTime, time, intersect)) {
+    return false;
+  }
+
+  intersect.point += motion * time;
+  intersect.normal = -intersect.normal;
+  return true;
+}
+
+/**
+ * Computes the first time of impact between a shape moving in a straight line
+ * and a stationary target shape. The moving shape is positioned by the
+ * transform at time 0, and its translation grows by the motion over each unit
+ * of time. The intersection normal faces from the target towards the moving
+ * shape, and the depth holds the distance travelled before the impact.
+ *
+ * Spheres, triangles and planes are swept exactly against each other, except
+ * for pairs of triangles. Unsupported pairs, including spheres which are
+ * scaled unevenly, never report an impact.
+ *
+ * @param shape The moving shape
+ * @param transform The transform of the moving shape at time 0
+ * @param motion The translation of the moving shape over a unit of time
+ * @param target The stationary shape
+ * @param targetTransform The transform of the stationary shape
+ * @param maxTime The latest time of impact of interest
+ * @param time The time of impact
+ * @param intersect A struct containing data on the impact
+ * @return True if the shapes touch no later than the maximum time
+ */
+
+bool re::sweep(const reShape& shape, const re::Transform& transform, const re::vec3& motion, const reShape& target, const re::Transform& targetTransform, reFloat maxTime, reFloat& time, re::Intersect& intersect) {
+  if (shape.type() == reShape::PROXY) {
+    const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+    return re::sweep(*proxy.shape(), transform * proxy.transform(), motion, target, targetTransform, maxTime, time, intersect);
+  }
+
+  if (target.type() == reShape::PROXY) {
+    const re::ShapeProxy& proxy = (const re::ShapeProxy&)target;
+    return re::sweep(shape, transform, motion, *proxy.shape(), targetTransform * proxy.transform(), maxTime, time, intersect);
+  }
+
+  switch (shape.type()) {
+    case reShape::SPHERE:
+      {
+        if (!isUniform(transform)) {
+          return false;
+        }
+        const reFloat radius = ((const re::Sphere&)shape).radius() * scaleOf(transform);
+
+        switch (target.type()) {
+          case reShape::SPHERE:
+            if (!isUniform(targetTransform)) {
+              return false;
+            }
+            return sweepSphereSphere(transform.v, radius, motion, targetTransform.v, ((const re::Sphere&)target).radius() * scaleOf(targetTransform), maxTime, time, intersect);
+
+          case reShape::PLANE:
+            return sweepSpherePlane(transform.v, radius, motion, re::Plane((const re::Plane&)target, targetTransform), target.shell(), maxTime, time, intersect);
+
+          case reShape::TRIANGLE:
+            {
+              re::vec3 verts[3];
+              placeVerts((const reTriangle&)target, targetTransform, &verts[0]);
+              return sweepSphereTriangle(transform.v, radius, motion, &verts[0], target.shell(), maxTime, time, intersect);
+            }
+
+          default:
+            return false;
+        }
+      }
+
+    case reShape::TRIANGLE:
+      switch (target.type()) {
+        case reShape::SPHERE:
+          return sweepReversed(shape, transform, motion, target, targetTransform, maxTime, time, intersect);
+
+        case reShape::PLANE:
+          {
+            re::vec3 verts[3];
+            placeVerts((const reTriangle&)shape, transform, &verts[0]);
+            return sweepTrianglePlane(&verts[0], shape.shell(), motion, re::Plane((const re::Plane&)target, targetTransform), target.shell(), maxTime, time, intersect);
+          }
+
+        default:
+          return false;
+      }
+
+    case reShape::PLANE:
+      switch (target.type()) {
+        case reShape::SPHERE:
+        case reShape::TRIANGLE:
+          return sweepReversed(shape, transform, motion, target, targetTransform, maxTime, time, intersect);
+
+        case reShape::PLANE:
+          {
+            const re::Plane plane((const re::Plane&)shape, transform);
+            const re::Plane targetPlane((const re::Plane&)target, targetTransform);
+            re::Intersect overlap;
+            if (intersects3(plane, re::Transform(), targetPlane, re::Transform(), overlap)) {
+              time = 0.0;
+              intersect = overlap;
+              intersect.depth = 0.0;
+              return true;
+            }
+            // parallel planes, which behave like a point on the moving plane
+            return sweepSpherePlane(plane.normal() * plane.offset(), shape.shell(), motion, targetPlane, target.shell(), maxTime, time, intersect);
+          }
+
+        default:
+          return false;
+      }
+
+    default:
+      return false;
+  }
+}
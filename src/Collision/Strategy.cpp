@@ -35,9 +35,10 @@ bool Strategy::shouldSplit(const reBSPNode& node) {
  * 
  * @param parentDir The parent split direction
  * @param sample A sample of the entities contained in the parent
+ * @param n The number of entities in the sample
  */
 
-Plane Strategy::computeSplitPlane(const re::vec3& axis, const reLinkedList<Entity*>& sample) {
+Plane Strategy::computeSplitPlane(const re::vec3& axis, Entity* const* sample, reUInt n) {
   re::vec3 split(0.0, 0.0, 0.0);
 
   const re::vec3 guess[3] = {
@@ -51,14 +52,14 @@ Plane Strategy::computeSplitPlane(const re::vec3& axis, const reLinkedList<Entit
   reFloat score[NUM_GUESSES] = { 0.0 };
   reUInt index = 0;
 
-  for (const Entity* entity : sample) {
-    split += entity->center();
+  for (reUInt j = 0; j < n; j++) {
+    split += sample[j]->center();
   }
-  split /= sample.size();
+  split /= n;
   
-  for (const Entity* entity : sample) {
+  for (reUInt j = 0; j < n; j++) {
     for (reUInt i = 0; i < NUM_GUESSES; i++) {
-      score[i] += re::dot(guess[i], - split + entity->center());
+      score[i] += re::dot(guess[i], - split + sample[j]->center());
     }
   }
   
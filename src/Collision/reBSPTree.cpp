@@ -3,8 +3,216 @@
 #include "react/math.h"
 #include "react/Entities/Entity.h"
 #include "react/Memory/reAllocator.h"
-#include "react/Utilities/util_funcs.h"
 #include "react/Collision/Shapes/ShapeProxy.h"
+#include "react/Utilities/ShapeCache.h"
+#include "react/Collision/Frustum.h"
+#include "react/Collision/Shapes/shapes.h"
+
+namespace {
+  /** The most impacts resolved for a continuous entity in a single step */
+  const reUInt MAX_IMPACTS = 4;
+
+  /**
+   * Describes how a segment of a ray is divided by a split plane. The near
+   * child is the one on the same side as the ray origin.
+   */
+
+  struct SegmentSplit {
+    reUInt near;
+    bool visitNear;
+    bool visitFar;
+    reFloat nearEnd;
+    reFloat farStart;
+  };
+
+  SegmentSplit splitSegment(const re::Plane& plane, const re::Ray& ray, reFloat tNear, reFloat tFar) {
+    const reFloat a = re::dot(ray.dir(), plane.normal());
+    const reFloat b = re::dot(plane.normal(), ray.origin()) - plane.offset();
+    SegmentSplit split = { b > 0.0 ? 0u : 1u, true, true, tFar, tNear };
+
+    if (a == 0.0) {
+      // parallel rays only reach the far side if they lie on the plane
+      split.visitFar = re::abs(b) <= RE_FP_TOLERANCE;
+      return split;
+    }
+
+    // entities may overlap the split plane by the tolerance, so the crossing
+    // point is widened by the distance the ray takes to cover it
+    const reFloat tSplit = -b / a;
+    const reFloat margin = RE_FP_TOLERANCE / re::abs(a);
+
+    if (tSplit + margin < 0.0 || tSplit - margin > tFar) {
+      // heading away from the plane, or crossing it beyond the segment
+      split.visitFar = false;
+    } else if (tSplit + margin < tNear) {
+      // crossed the plane before the segment started
+      split.visitNear = false;
+    } else {
+      split.nearEnd = re::min(tSplit + margin, tFar);
+      split.farStart = re::max(tSplit - margin, tNear);
+    }
+
+    return split;
+  }
+
+  /**
+   * Returns the location of an interval of signed distances from a plane,
+   * using the same tolerances as entity placement in the tree
+   */
+
+  re::Location locate(reFloat minV, reFloat maxV) {
+    if (minV > RE_FP_TOLERANCE) {
+      return re::FRONT;
+    } else if (maxV < RE_FP_TOLERANCE) {
+      return re::BACK;
+    }
+    return re::INTERSECT;
+  }
+
+  /**
+   * Returns a lower bound on the squared distance from the point to any
+   * entity behind the plane, given the signed distance of the point from it.
+   * Entities may overlap the plane by the tolerance.
+   */
+
+  reFloat boundBehind(reFloat dist) {
+    const reFloat gap = dist - RE_FP_TOLERANCE;
+    return gap > 0.0 ? gap * gap : 0.0;
+  }
+
+  /**
+   * Moves the last element of the max-heap of results up to its place
+   */
+
+  void siftUp(re::SingleResult* heap, reUInt i) {
+    while (i > 0) {
+      const reUInt parent = (i - 1) / 2;
+      if (heap[parent].distSq >= heap[i].distSq) {
+        return;
+      }
+      re::SingleResult tmp = heap[parent];
+      heap[parent] = heap[i];
+      heap[i] = tmp;
+      i = parent;
+    }
+  }
+
+  /**
+   * Moves the first element of the max-heap of results down to its place
+   */
+
+  void siftDown(re::SingleResult* heap, reUInt size, reUInt i) {
+    for (;;) {
+      reUInt largest = i;
+      for (reUInt child = 2 * i + 1; child <= 2 * i + 2 && child < size; child++) {
+        if (heap[child].distSq > heap[largest].distSq) {
+          largest = child;
+        }
+      }
+      if (largest == i) {
+        return;
+      }
+      re::SingleResult tmp = heap[largest];
+      heap[largest] = heap[i];
+      heap[i] = tmp;
+      i = largest;
+    }
+  }
+
+  /**
+   * Returns true if the transformed shape overlaps the entity. The narrow
+   * phase can not test pairs of triangles, so their bounding spheres are
+   * compared instead, which may find entities which are only close by.
+   */
+
+  bool overlapsEntity(const reShape& shape, const re::Transform& transform, const re::Entity& entity) {
+    if (shape.type() == reShape::PROXY) {
+      const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+      return overlapsEntity(*proxy.shape(), transform * proxy.transform(), entity);
+    }
+
+    if (shape.type() == reShape::TRIANGLE && entity.baseShape().type() == reShape::TRIANGLE) {
+      re::vec3 center, entityCenter;
+      reFloat radius, entityRadius;
+      re::boundingSphere(shape, transform, center, radius);
+      re::boundingSphere(entity.baseShape(), entity.shapeTransform(), entityCenter, entityRadius);
+      return re::lengthSq(center - entityCenter) < re::sq(radius + entityRadius);
+    }
+
+    re::Intersect intersect;
+    return re::intersects(shape, transform, entity.baseShape(), entity.shapeTransform(), intersect);
+  }
+
+  /**
+   * A convex region bounded by outward facing planes, such as a box or a
+   * frustum. Entities are rejected only if they lie entirely outside one of
+   * the planes.
+   */
+
+  struct ConvexRegion {
+    const re::Plane* planes;
+    reUInt numPlanes;
+    const re::vec3* corners;
+    reUInt numCorners;
+
+    re::Location relativeToPlane(const re::Plane& plane) const {
+      reFloat minV = RE_INFINITY;
+      reFloat maxV = RE_NEGATIVE_INFINITY;
+      for (reUInt i = 0; i < numCorners; i++) {
+        const reFloat dist = re::dot(plane.normal(), corners[i]) - plane.offset();
+        minV = re::min(minV, dist);
+        maxV = re::max(maxV, dist);
+      }
+      return locate(minV, maxV);
+    }
+
+    bool overlaps(re::Entity& entity) const {
+      for (reUInt i = 0; i < numPlanes; i++) {
+        if (entity.relativeToPlane(planes[i]) == re::FRONT) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  /**
+   * A region occupied by a transformed shape, tested against entities with
+   * the narrow phase queries where possible
+   */
+
+  struct ShapeRegion {
+    const reShape& shape;
+    const re::Transform& transform;
+    const re::Transform inverse;
+
+    re::Location relativeToPlane(const re::Plane& plane) const {
+      return re::relativeToPlane(shape, transform, inverse, plane);
+    }
+
+    bool overlaps(re::Entity& entity) const {
+      return overlapsEntity(shape, transform, entity);
+    }
+  };
+
+  /**
+   * A spherical region, which is classified against planes directly
+   */
+
+  struct SphereRegion {
+    const re::Sphere& sphere;
+    const re::Transform& transform;
+
+    re::Location relativeToPlane(const re::Plane& plane) const {
+      const reFloat dist = re::dot(plane.normal(), transform.v) - plane.offset();
+      return locate(dist - sphere.radius(), dist + sphere.radius());
+    }
+
+    bool overlaps(re::Entity& entity) const {
+      return overlapsEntity(sphere, transform, entity);
+    }
+  };
+}
 
 reBSPNode::reBSPNode(reAllocator& allocator, reUInt depth) : _allocator(allocator), _markers(allocator), _children{nullptr}, _splitPlane(re::vec3(1.0, 0.0, 0.0), 0.0), _depth(depth) {
   // do nothing
@@ -24,10 +232,20 @@ void reBSPNode::clear() {
     }
   }
   _markers.clear();
+  _markers.shrink();
 }
 
 bool reBSPNode::remove(Marker& marker) {
-  return _markers.remove(&marker);
+  if (marker.node != this) {
+    return false;
+  }
+  
+  const reUInt index = marker.nodeIndex;
+  _markers.removeAt(index);
+  if (index < _markers.size()) {
+    _markers[index]->nodeIndex = index;
+  }
+  return true;
 }
 
 /**
@@ -102,10 +320,40 @@ bool reBSPNode::execute(reBSPTreeCallback callback) {
 
 #include "react/debug.h"
 
+/**
+ * Performs a ray query on this node and its children, keeping the closest
+ * intersection found within the ray's interval in the result. Any hit already
+ * present in the result is treated as the closest found so far.
+ * 
+ * @param ray The ray to test with
+ * @param result The closest intersection found so far
+ */
+
 void reBSPNode::queryWithRay(const re::Ray& ray, re::RayQuery& result) const {
+  queryWithRay(ray, ray.tMin(), ray.tMax(), result);
+}
+
+/**
+ * Performs a ray query on the segment [tNear, tFar] of the ray within this
+ * node. Children are visited front to back, with the segment clipped against
+ * the split plane, and are skipped entirely once the closest hit lies before
+ * them.
+ * 
+ * @param ray The ray to test with
+ * @param tNear The distance along the ray at which it enters this node
+ * @param tFar The distance along the ray at which it leaves this node
+ * @param result The closest intersection found so far
+ */
+
+void reBSPNode::queryWithRay(const re::Ray& ray, reFloat tNear, reFloat tFar, re::RayQuery& result) const {
+  // entities in this subtree cannot be hit before the ray enters the node
+  if (result.depth < tNear) {
+    return;
+  }
+
+  re::countQueries(_markers.size());
   re::RayQuery res;
   for (Marker* marker : _markers) {
-    re::queriesMade++;
     if (marker->entity.intersects(ray, res)) {
       if (res.depth < result.depth) {
         result.point = res.point;
@@ -117,15 +365,129 @@ void reBSPNode::queryWithRay(const re::Ray& ray, re::RayQuery& result) const {
   }
 
   if (hasChildren()) {
-    const reFloat a = re::dot(ray.dir(), _splitPlane.normal());
-    const reFloat b = re::dot(_splitPlane.normal(), ray.origin()) - _splitPlane.offset();
-    if (a > RE_FP_TOLERANCE && b > RE_FP_TOLERANCE) {
-      _children[0]->queryWithRay(ray, result);
-    } else if (a < RE_FP_TOLERANCE && b < RE_FP_TOLERANCE) {
-      _children[1]->queryWithRay(ray, result);
+    const SegmentSplit split = splitSegment(_splitPlane, ray, tNear, tFar);
+    const reUInt near = split.near;
+    if (split.visitNear) {
+      _children[near]->queryWithRay(ray, tNear, split.nearEnd, result);
+    }
+    if (split.visitFar) {
+      _children[1 - near]->queryWithRay(ray, split.farStart, tFar, result);
+    }
+  }
+}
+
+/**
+ * Returns true if any entity in this node or its children blocks the ray
+ * within its interval and before the maximum distance, returning as soon as
+ * one is found.
+ * 
+ * @param ray The ray to test with
+ * @param maxDist The distance along the ray beyond which entities are ignored
+ * @return True if the ray is blocked
+ */
+
+bool reBSPNode::queryOcclusion(const re::Ray& ray, reFloat maxDist) const {
+  re::Ray segment(ray);
+  segment.setInterval(ray.tMin(), re::min(maxDist, ray.tMax()));
+  return queryOcclusion(segment, segment.tMin(), segment.tMax());
+}
+
+/**
+ * Returns true if any entity blocks the segment [tNear, tFar] of the ray
+ * within this node. Children are visited front to back, so that blockers
+ * close to the ray origin are found first.
+ * 
+ * @param ray The ray to test with
+ * @param tNear The distance along the ray at which it enters this node
+ * @param tFar The distance along the ray at which it leaves this node
+ * @return True if the ray is blocked
+ */
+
+bool reBSPNode::queryOcclusion(const re::Ray& ray, reFloat tNear, reFloat tFar) const {
+  reUInt tests = 0;
+  for (Marker* marker : _markers) {
+    tests++;
+    if (marker->entity.occludes(ray, ray.tMax())) {
+      re::countQueries(tests);
+      return true;
+    }
+  }
+  re::countQueries(tests);
+
+  if (hasChildren()) {
+    const SegmentSplit split = splitSegment(_splitPlane, ray, tNear, tFar);
+    const reUInt near = split.near;
+    return (split.visitNear && _children[near]->queryOcclusion(ray, tNear, split.nearEnd)) ||
+           (split.visitFar && _children[1 - near]->queryOcclusion(ray, split.farStart, tFar));
+  }
+
+  return false;
+}
+
+/**
+ * Performs a ray query for a packet of rays. The lanes which continue into each
+ * child are tracked separately, so the packet splits as the rays diverge. Once
+ * a single ray remains, it continues with the regular ray query.
+ * 
+ * @param packet The packet of rays, which also holds the results
+ * @param mask The lanes of the packet to test at this node
+ */
+
+void reBSPNode::queryWithPacket(re::RayPacket& packet, reUInt mask) const {
+  if (re::countLanes(mask) == 1) {
+    const reUInt lane = __builtin_ctz(mask);
+    queryWithRay(packet.rays[lane], packet.results[lane]);
+    return;
+  }
+
+  re::countQueries(_markers.size() * re::countLanes(mask));
+  alignas(16) reFloat t[re::RayPacket::WIDTH];
+  for (Marker* marker : _markers) {
+    re::Entity& entity = marker->entity;
+
+    if (re::hasPacketKernel(entity.baseShape())) {
+      reUInt hits = re::intersects(entity.baseShape(), entity.shapeTransformInv(), packet, mask, &t[0]);
+      while (hits != 0) {
+        const reUInt lane = __builtin_ctz(hits);
+        hits &= hits - 1;
+        packet.record(lane, t[lane], entity);
+      }
     } else {
-      _children[0]->queryWithRay(ray, result);
-      _children[1]->queryWithRay(ray, result);
+      re::RayQuery res;
+      for (reUInt lane = 0; lane < packet.size; lane++) {
+        if ((mask & (1 << lane)) != 0 && entity.intersects(packet.rays[lane], res) && res.depth < packet.results[lane].depth) {
+          packet.results[lane].point = res.point;
+          packet.results[lane].normal = res.normal;
+          packet.results[lane].depth = res.depth;
+          packet.results[lane].entity = &entity;
+        }
+      }
+    }
+  }
+
+  if (hasChildren()) {
+    // classifies each lane by the whole interval of its ray
+    reUInt front = 0;
+    reUInt back = 0;
+    for (reUInt lane = 0; lane < packet.size; lane++) {
+      if ((mask & (1 << lane)) == 0) {
+        continue;
+      }
+      const re::Ray& ray = packet.rays[lane];
+      const SegmentSplit split = splitSegment(_splitPlane, ray, ray.tMin(), ray.tMax());
+      if (split.near == 0 ? split.visitNear : split.visitFar) {
+        front |= 1 << lane;
+      }
+      if (split.near == 1 ? split.visitNear : split.visitFar) {
+        back |= 1 << lane;
+      }
+    }
+
+    if (front != 0) {
+      _children[0]->queryWithPacket(packet, front);
+    }
+    if (back != 0) {
+      _children[1]->queryWithPacket(packet, back);
     }
   }
 }
@@ -136,7 +498,9 @@ void reBSPNode::queryWithRay(const re::Ray& ray, re::RayQuery& result) const {
 
 void reBSPNode::split(re::Strategy& strategy) {
   // use parent split normal to determine optimal split plane
-  _splitPlane = strategy.computeSplitPlane(_splitPlane.normal(), sample(8));
+  re::Entity* samples[8];
+  const reUInt n = sample(samples, 8);
+  _splitPlane = strategy.computeSplitPlane(_splitPlane.normal(), samples, n);
   
   // setup each _child node
   for (reUInt i = 0; i < 2; i++) {
@@ -145,11 +509,9 @@ void reBSPNode::split(re::Strategy& strategy) {
     _children[i]->_splitPlane = _splitPlane;
   }
   
-  auto end = _markers.end();
-  for (auto it = _markers.begin(); it != end;) {
-    Marker* marker = *it;
-    ++it;
-    place(*marker);
+  // walk backwards, so markers moved into a gap have already been placed
+  for (reUInt i = _markers.size(); i-- > 0;) {
+    place(*_markers[i]);
   }
   
   _children[0]->rebalanceNode(strategy);
@@ -162,44 +524,101 @@ void reBSPNode::split(re::Strategy& strategy) {
 
 void reBSPNode::merge() {
   for (reUInt i = 0; i < 2; i++) {
-    _markers.append(_children[i]->_markers);
+    for (Marker* marker : _children[i]->_markers) {
+      marker->node = this;
+      marker->nodeIndex = _markers.add(marker);
+    }
     _allocator.alloc_delete(_children[i]);
     _children[i] = nullptr;
   }
+}
+
+/**
+ * Picks a uniformly random sample of the entities contained in the node,
+ * without allocating. Selection sampling is used, so the entities appear in
+ * the same order as they do in the node.
+ * 
+ * @param results The buffer to write the sampled entities into
+ * @param num The maximum number of entities to sample
+ * @return The number of entities written to the buffer
+ */
+
+reUInt reBSPNode::sample(re::Entity** results, reUInt num) const {
+  const reUInt size = _markers.size();
+  reUInt found = 0;
+  for (reUInt i = 0; i < size && found < num; i++) {
+    if ((reUInt)re::randi() % (size - i) < num - found) {
+      results[found++] = &_markers[i]->entity;
+    }
+  }
   
-  // change node reference
-  for (Marker* marker : _markers) {
-    marker->node = this;
+  return found;
+}
+
+/**
+ * Writes the node and all of its descendents in depth first order
+ * 
+ * @param splits The buffer the nodes are written to
+ * @param capacity The number of nodes the buffer can hold
+ * @param count The number of nodes written before this node
+ * @return The number of nodes written including this node's subtree
+ */
+
+reUInt reBSPNode::writeLayout(reBPSplit* splits, reUInt capacity, reUInt count) const {
+  if (count < capacity) {
+    reBPSplit& split = splits[count];
+    for (reUInt i = 0; i < 3; i++) {
+      split.normal[i] = _splitPlane.normal()[i];
+    }
+    split.offset = _splitPlane.offset();
+    split.children = hasChildren() ? 1 : 0;
+    split.padding = 0;
   }
+  count++;
+  
+  if (hasChildren()) {
+    count = _children[0]->writeLayout(splits, capacity, count);
+    count = _children[1]->writeLayout(splits, capacity, count);
+  }
+  
+  return count;
 }
 
-const reLinkedList<re::Entity*> reBSPNode::sample(reUInt num) const {
-  reLinkedList<re::Entity*> list(allocator());
+/**
+ * Rebuilds the node and its descendents from nodes written by
+ * reBSPNode::writeLayout. The node must not have any children. Layouts
+ * deeper than reBPSplit::MAX_DEPTH are rejected, which bounds the recursion.
+ * 
+ * @param split The node to read
+ * @param end The end of the nodes
+ * @return The node following this node's subtree, or a null pointer if the
+ * nodes ended early or were too deep
+ */
+
+const reBPSplit* reBSPNode::readLayout(const reBPSplit* split, const reBPSplit* end) {
+  if (split == end) {
+    return nullptr;
+  }
   
-  if (num < _markers.size()) {
-    reUInt* indices = new reUInt[num];
-    re::generateSortedUInts(indices, num, _markers.size());
+  _splitPlane = re::Plane(re::vec3(split->normal[0], split->normal[1], split->normal[2]), split->offset);
+  split++;
+  
+  if (split[-1].children != 0) {
+    if (_depth >= reBPSplit::MAX_DEPTH) {
+      return nullptr;
+    }
     
-    reUInt index = 0;
-    reUInt counter = 0;
-    for (Marker* marker : _markers) {
-      if (counter++ == indices[index]) {
-        list.add(&marker->entity);
-        index++;
-      }
-      if (index == num) {
-        break;
-      }
+    for (reUInt i = 0; i < 2; i++) {
+      _children[i] = _allocator.alloc_new<reBSPNode>(_allocator, _depth + 1);
     }
     
-    delete[] indices;
-  } else {
-    for (Marker* marker : _markers) {
-      list.add(&marker->entity);
+    split = _children[0]->readLayout(split, end);
+    if (split != nullptr) {
+      split = _children[1]->readLayout(split, end);
     }
   }
   
-  return list;
+  return split;
 }
 
 reBSPNode* reBSPNode::place(Marker& marker) {
@@ -224,7 +643,7 @@ reBSPNode* reBSPNode::place(Marker& marker) {
       marker.node->remove(marker);
     }
     marker.node = this;
-    _markers.add(&marker);
+    marker.nodeIndex = _markers.add(&marker);
   }
   
   return this;
@@ -250,7 +669,19 @@ void reBSPNode::measureRecursive(reBPMeasure& m) const {
   m.references += _markers.size();
 }
 
-reBSPTree::reBSPTree(reAllocator& allocator) : reBroadPhase(), reBSPNode(allocator, 0), _contacts(allocator), _strategy(), _allMarkers(allocator), _masterEntityList(allocator) {
+reBSPTree::reBSPTree(reAllocator& allocator) : reBSPTree(allocator, allocator) {
+  // do nothing
+}
+
+/**
+ * Creates an empty tree which keeps its contacts in a separate allocator, so
+ * that their memory can be accounted for separately
+ * 
+ * @param allocator The allocator used for the tree structure
+ * @param contacts The allocator used for the contact graph
+ */
+
+reBSPTree::reBSPTree(reAllocator& allocator, reAllocator& contacts) : reBroadPhase(), reBSPNode(allocator, 0), _contacts(contacts), _strategy(), _allMarkers(allocator), _masterEntityList(allocator) {
   // do nothing
 }
 
@@ -259,31 +690,31 @@ reBSPTree::~reBSPTree() {
 }
 
 void reBSPTree::clear() {
+  // contacts refer to the entities, so they must go first
+  _contacts.clear();
+  
   // clear all entities
   for (Marker* marker : _allMarkers) {
     RE_EXPECT(marker->entity.userdata == nullptr)
-    if (marker->entity.shape().type() == reShape::PROXY) {
-      allocator().alloc_delete(
-        ((re::ShapeProxy&)marker->entity.shape()).shape()
-      );
-    }
-    allocator().alloc_delete(&marker->entity.shape());
+    re::ShapeCache::release(allocator(), marker->entity.shape());
     allocator().alloc_delete(&marker->entity);
     allocator().alloc_delete(marker);
   }
   
   // clear all broken references
   _allMarkers.clear();
+  _allMarkers.shrink();
   _masterEntityList.clear();
+  _masterEntityList.shrink();
   
   reBSPNode::clear();
 }
 
 bool reBSPTree::add(re::Entity& ent) {
-  if (!_masterEntityList.contains(&ent)) {
+  if (!contains(ent)) {
     Marker* marker = allocator().alloc_new<Marker>(ent);
-    _allMarkers.add(marker);
-    _masterEntityList.add(&ent);
+    marker->index = _allMarkers.add(marker);
+    ent._treeIndex = _masterEntityList.add(&ent);
     place(*marker);
     return true;
   }
@@ -291,26 +722,424 @@ bool reBSPTree::add(re::Entity& ent) {
   return false;
 }
 
-bool reBSPTree::remove(re::Entity& ent) {
-  for (Marker* marker : _allMarkers) {
-    if (marker->entity.id() == ent.id()) {
-      if (marker->node != nullptr) {
-        marker->node->remove(*marker);
+/**
+ * Performs a ray query for each ray in the array, grouping them into packets
+ * of coherent rays. Each result is reset before the query.
+ * 
+ * @param rays The array of rays
+ * @param results The array of results, with one element for each ray
+ * @param n The number of rays
+ */
+
+void reBSPTree::queryWithRays(const re::Ray* rays, re::RayQuery* results, reUInt n) const {
+  for (reUInt i = 0; i < n; i += re::RayPacket::WIDTH) {
+    const reUInt size = (n - i < re::RayPacket::WIDTH) ? n - i : re::RayPacket::WIDTH;
+    for (reUInt j = 0; j < size; j++) {
+      results[i + j] = re::RayQuery();
+    }
+    
+    re::RayPacket packet(&rays[i], &results[i], size);
+    reBSPNode::queryWithPacket(packet, packet.lanes);
+  }
+}
+
+/**
+ * Collects the entities in this node and its children which overlap the
+ * region. Children lying entirely outside the region are skipped.
+ * 
+ * @param region The region to test with
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @param found The number of entities found so far
+ * @return The number of entities found, including those found previously
+ */
+
+template <class Region>
+reUInt reBSPNode::queryRegion(const Region& region, re::Entity** results, reUInt capacity, reUInt found) const {
+  re::countQueries(_markers.size());
+  for (Marker* marker : _markers) {
+    if (region.overlaps(marker->entity)) {
+      if (found < capacity) {
+        results[found] = &marker->entity;
       }
-      
-      _allMarkers.remove(marker);
-      _masterEntityList.remove(&ent);
-      allocator().alloc_delete(marker);
-      return true;
+      found++;
+    }
+  }
+
+  if (hasChildren()) {
+    switch (region.relativeToPlane(_splitPlane)) {
+      case re::FRONT:
+        return _children[0]->queryRegion(region, results, capacity, found);
+
+      case re::BACK:
+        return _children[1]->queryRegion(region, results, capacity, found);
+
+      case re::INTERSECT:
+        found = _children[0]->queryRegion(region, results, capacity, found);
+        return _children[1]->queryRegion(region, results, capacity, found);
+
+      default:
+        RE_IMPOSSIBLE
+    }
+  }
+
+  return found;
+}
+
+/**
+ * Finds all entities overlapping the axis aligned box, as described in
+ * reBroadPhase::queryWithAABB
+ */
+
+reUInt reBSPTree::queryWithAABB(const reAABB& aabb, const re::vec3& center, re::Entity** results, reUInt capacity) const {
+  const re::vec3& d = aabb.dimens();
+  const re::Plane planes[6] = {
+    re::Plane(re::vec3( 1.0, 0.0, 0.0),  center.x + d.x),
+    re::Plane(re::vec3(-1.0, 0.0, 0.0), -center.x + d.x),
+    re::Plane(re::vec3(0.0,  1.0, 0.0),  center.y + d.y),
+    re::Plane(re::vec3(0.0, -1.0, 0.0), -center.y + d.y),
+    re::Plane(re::vec3(0.0, 0.0,  1.0),  center.z + d.z),
+    re::Plane(re::vec3(0.0, 0.0, -1.0), -center.z + d.z)
+  };
+  re::vec3 corners[8];
+  for (reUInt i = 0; i < 8; i++) {
+    corners[i] = center + re::vec3((i & 1) ? d.x : -d.x, (i & 2) ? d.y : -d.y, (i & 4) ? d.z : -d.z);
+  }
+
+  const ConvexRegion region = { &planes[0], 6, &corners[0], 8 };
+  return queryRegion(region, results, capacity, 0);
+}
+
+/**
+ * Finds all entities overlapping the sphere, as described in
+ * reBroadPhase::queryWithSphere
+ */
+
+reUInt reBSPTree::queryWithSphere(const re::vec3& center, reFloat radius, re::Entity** results, reUInt capacity) const {
+  const re::Sphere sphere(radius);
+  const re::Transform transform(re::mat3(1.0), center);
+  const SphereRegion region = { sphere, transform };
+  return queryRegion(region, results, capacity, 0);
+}
+
+/**
+ * Finds all entities overlapping the transformed shape, as described in
+ * reBroadPhase::queryWithShape
+ */
+
+reUInt reBSPTree::queryWithShape(const reShape& shape, const re::Transform& transform, re::Entity** results, reUInt capacity) const {
+  const ShapeRegion region = { shape, transform, re::inverse(transform) };
+  return queryRegion(region, results, capacity, 0);
+}
+
+/**
+ * Finds all entities which may be visible within the frustum, as described in
+ * reBroadPhase::queryWithFrustum
+ */
+
+reUInt reBSPTree::queryWithFrustum(const re::Frustum& frustum, re::Entity** results, reUInt capacity) const {
+  re::Plane planes[re::Frustum::NUM_PLANES] = {
+    frustum.plane(0), frustum.plane(1), frustum.plane(2),
+    frustum.plane(3), frustum.plane(4), frustum.plane(5)
+  };
+  const ConvexRegion region = { &planes[0], re::Frustum::NUM_PLANES, &frustum.corner(0), re::Frustum::NUM_CORNERS };
+  return queryRegion(region, results, capacity, 0);
+}
+
+/**
+ * Adds the entities in this node and its children which are closer than the
+ * furthest result found so far. The results form a max-heap of at most k
+ * entries keyed on distance, so the furthest result is always at the top.
+ * The child containing the point is visited first, and the other child is
+ * skipped once the split plane lies beyond the furthest result.
+ * 
+ * @param point The point to search around
+ * @param bound A lower bound on the squared distance to entities in this node
+ * @param results The max-heap of results
+ * @param k The maximum number of results
+ * @param found The number of results in the heap
+ */
+
+void reBSPNode::queryNearest(const re::vec3& point, reFloat bound, re::SingleResult* results, reUInt k, reUInt& found) const {
+  if (found == k && bound >= results[0].distSq) {
+    return;
+  }
+
+  re::countQueries(_markers.size());
+  for (Marker* marker : _markers) {
+    const reFloat distSq = re::lengthSq(marker->entity.center() - point);
+    if (found < k) {
+      results[found].distSq = distSq;
+      results[found].entity = &marker->entity;
+      siftUp(results, found++);
+    } else if (distSq < results[0].distSq) {
+      results[0].distSq = distSq;
+      results[0].entity = &marker->entity;
+      siftDown(results, found, 0);
+    }
+  }
+
+  if (hasChildren()) {
+    const reFloat dist = re::dot(_splitPlane.normal(), point) - _splitPlane.offset();
+    const reUInt near = dist > 0.0 ? 0 : 1;
+    _children[near]->queryNearest(point, bound, results, k, found);
+    _children[1 - near]->queryNearest(point, re::max(bound, boundBehind(re::abs(dist))), results, k, found);
+  }
+}
+
+/**
+ * Finds the k entities with centers closest to the point, as described in
+ * reBroadPhase::queryNearest
+ */
+
+reUInt reBSPTree::queryNearest(const re::vec3& point, re::SingleResult* results, reUInt k) const {
+  reUInt found = 0;
+  if (k == 0) {
+    return found;
+  }
+  reBSPNode::queryNearest(point, 0.0, results, k, found);
+
+  // sorts the heap in place by repeatedly moving the furthest to the back
+  for (reUInt size = found; size > 1; size--) {
+    re::SingleResult tmp = results[0];
+    results[0] = results[size - 1];
+    results[size - 1] = tmp;
+    siftDown(results, size - 1, 0);
+  }
+
+  return found;
+}
+
+/**
+ * Collects the entities in this node and its children with centers within
+ * the radius of the point. Children on the far side of the split plane are
+ * skipped if the plane lies beyond the radius.
+ * 
+ * @param point The point to search around
+ * @param radiusSq The squared search radius
+ * @param results The buffer the results are written to
+ * @param capacity The number of results the buffer can hold
+ * @param found The number of entities found so far
+ * @return The number of entities found, including those found previously
+ */
+
+reUInt reBSPNode::queryWithinRadius(const re::vec3& point, reFloat radiusSq, re::SingleResult* results, reUInt capacity, reUInt found) const {
+  re::countQueries(_markers.size());
+  for (Marker* marker : _markers) {
+    const reFloat distSq = re::lengthSq(marker->entity.center() - point);
+    if (distSq <= radiusSq) {
+      if (found < capacity) {
+        results[found].distSq = distSq;
+        results[found].entity = &marker->entity;
+      }
+      found++;
+    }
+  }
+
+  if (hasChildren()) {
+    const reFloat dist = re::dot(_splitPlane.normal(), point) - _splitPlane.offset();
+    const reUInt near = dist > 0.0 ? 0 : 1;
+    found = _children[near]->queryWithinRadius(point, radiusSq, results, capacity, found);
+    if (boundBehind(re::abs(dist)) <= radiusSq) {
+      found = _children[1 - near]->queryWithinRadius(point, radiusSq, results, capacity, found);
+    }
+  }
+
+  return found;
+}
+
+/**
+ * Finds all entities with centers within the radius of the point, as
+ * described in reBroadPhase::queryWithinRadius
+ */
+
+reUInt reBSPTree::queryWithinRadius(const re::vec3& point, reFloat radius, re::SingleResult* results, reUInt capacity) const {
+  return reBSPNode::queryWithinRadius(point, radius * radius, results, capacity, 0);
+}
+
+/**
+ * Sweeps the shape through this node and its children, keeping the earliest
+ * impact in the result. The swept bounding sphere is classified against the
+ * split plane up to the earliest impact found so far, and the child holding
+ * the start of the sweep is visited first.
+ * 
+ * @param shape The shape to sweep
+ * @param transform The transform of the shape at the start of the sweep
+ * @param motion The translation of the shape over the whole sweep
+ * @param center The center of the shape's bounding sphere at the start
+ * @param radius The radius of the shape's bounding sphere
+ * @param ignore An entity excluded from the query, usually the one being swept
+ * @param result The earliest impact found so far
+ */
+
+void reBSPNode::querySweep(const reShape& shape, const re::Transform& transform, const re::vec3& motion, const re::vec3& center, reFloat radius, const re::Entity* ignore, re::SweepQuery& result) const {
+  re::countQueries(_markers.size());
+  reFloat time;
+  re::Intersect intersect;
+  for (Marker* marker : _markers) {
+    re::Entity& entity = marker->entity;
+    if (&entity == ignore) {
+      continue;
+    }
+
+    if (re::sweep(shape, transform, motion, entity.baseShape(), entity.shapeTransform(), result.time, time, intersect) &&
+        (result.entity == nullptr || time < result.time) &&
+        // an initial overlap only blocks motion going deeper into the entity
+        (time > 0.0 || re::dot(intersect.normal, motion) < 0.0)) {
+      result.time = time;
+      result.point = intersect.point;
+      result.normal = intersect.normal;
+      result.depth = intersect.depth;
+      result.entity = &entity;
+    }
+  }
+
+  if (hasChildren()) {
+    const reFloat start = re::dot(_splitPlane.normal(), center) - _splitPlane.offset();
+    const reUInt near = start > 0.0 ? 0 : 1;
+    for (reUInt i = 0; i < 2; i++) {
+      const reUInt child = (i == 0) ? near : 1 - near;
+      const reFloat end = start + re::dot(_splitPlane.normal(), motion) * result.time;
+      const reFloat minV = re::min(start, end) - radius;
+      const reFloat maxV = re::max(start, end) + radius;
+      if (child == 0 ? maxV > RE_FP_TOLERANCE : minV < RE_FP_TOLERANCE) {
+        _children[child]->querySweep(shape, transform, motion, center, radius, ignore, result);
+      }
+    }
+  }
+}
+
+/**
+ * Sweeps the shape along the path, as described in reBroadPhase::querySweep
+ */
+
+bool reBSPTree::querySweep(const reShape& shape, const re::Segment& path, re::SweepQuery& result, const re::quat& orientation) const {
+  const re::Transform transform(re::toMat(orientation), path.start);
+  re::vec3 center;
+  reFloat radius;
+  re::boundingSphere(shape, transform, center, radius);
+
+  re::SweepQuery sweep;
+  reBSPNode::querySweep(shape, transform, path.end - path.start, center, radius, nullptr, sweep);
+  if (sweep.entity == nullptr) {
+    return false;
+  }
+
+  result.time = sweep.time;
+  result.point = sweep.point;
+  result.normal = sweep.normal;
+  result.depth = sweep.depth;
+  result.entity = sweep.entity;
+  return true;
+}
+
+/**
+ * Adds many entities at once. Where the tree has no structure yet, every
+ * entity is placed in the root and the whole structure is then built top
+ * down in a single pass of splits, rather than growing the tree one entity
+ * at a time. Otherwise the entities are placed into the existing structure,
+ * as single entities are, and the tree is not rebuilt. Callers adding many
+ * entities to a tree which already has splits should call rebalance()
+ * afterwards. Entities which are already in the tree, or repeated in the
+ * array, are skipped.
+ * 
+ * @param entities The entities to add
+ * @param n The number of entities
+ * @return The number of entities added
+ */
+
+reUInt reBSPTree::add(re::Entity* const* entities, reUInt n) {
+  _allMarkers.reserve(_allMarkers.size() + n);
+  _masterEntityList.reserve(_masterEntityList.size() + n);
+  
+  const bool build = isLeaf();
+  reUInt count = 0;
+  for (reUInt i = 0; i < n; i++) {
+    // entities are found in constant time, so repeats are caught as they go
+    if (contains(*entities[i])) {
+      continue;
     }
+    
+    Marker* marker = allocator().alloc_new<Marker>(*entities[i]);
+    marker->index = _allMarkers.add(marker);
+    entities[i]->_treeIndex = _masterEntityList.add(entities[i]);
+    place(*marker);
+    count++;
   }
   
-  return false;
+  if (build && count > 0) {
+    reBSPNode::rebalanceNode(_strategy);
+  }
+  return count;
+}
+
+reUInt reBSPTree::layout(reBPSplit* splits, reUInt capacity) const {
+  return writeLayout(splits, capacity, 0);
 }
 
+/**
+ * Replaces the nodes of the tree with the layout given, then places every
+ * contained entity into the new nodes. The tree is not rebalanced, so a
+ * saved layout is reproduced exactly.
+ * 
+ * @param splits The nodes of the layout in depth first order
+ * @param n The number of nodes
+ * @return False if the nodes do not describe a complete tree, in which case
+ * the tree is left as a single node
+ */
+
+bool reBSPTree::setLayout(const reBPSplit* splits, reUInt n) {
+  reBSPNode::clear();
+  for (Marker* marker : _allMarkers) {
+    marker->node = nullptr;
+  }
+  
+  const bool valid = (readLayout(splits, splits + n) == splits + n);
+  if (!valid) {
+    reBSPNode::clear();
+  }
+  
+  for (Marker* marker : _allMarkers) {
+    place(*marker);
+  }
+  
+  return valid;
+}
+
+bool reBSPTree::remove(re::Entity& ent) {
+  if (!contains(ent)) {
+    return false;
+  }
+  
+  const reUInt index = ent._treeIndex;
+  Marker* marker = _allMarkers[index];
+  if (marker->node != nullptr) {
+    marker->node->remove(*marker);
+  }
+  
+  // both lists move their last element into the gap, keeping them aligned
+  _allMarkers.removeAt(index);
+  _masterEntityList.removeAt(index);
+  if (index < _allMarkers.size()) {
+    _allMarkers[index]->index = index;
+    _masterEntityList[index]->_treeIndex = index;
+  }
+  allocator().alloc_delete(marker);
+  return true;
+}
+
+/**
+ * Returns true if the entity is in the tree. Each entity remembers its index
+ * in the tree, which is only trusted if the tree holds the entity there, so
+ * entities from other trees are never mistaken for contained ones.
+ * 
+ * @param ent The entity to look for
+ * @return True if the tree contains the entity
+ */
+
 bool reBSPTree::contains(const re::Entity& ent) const {
-  // TODO very hacky way, must be a better method
-  return _masterEntityList.contains(const_cast<re::Entity*>(&ent));
+  const reUInt index = ent._treeIndex;
+  return index < _masterEntityList.size() && _masterEntityList[index] == &ent;
 }
 
 void reBSPTree::rebalance(re::Strategy* strategy) {
@@ -321,12 +1150,16 @@ void reBSPTree::rebalance(re::Strategy* strategy) {
   reBSPNode::rebalanceNode(*strategy);
 }
 
-void reBSPTree::advance(re::Integrator& integrator, reFloat dt) {
+void reBSPTree::advance(re::Integrator& integrator, reFloat dt, reAllocator& scratch) {
   // advance each entity forward in time and relocates them on the tree
   auto end = _allMarkers.end();
   for (auto it = _allMarkers.begin(); it != end;) {
     Marker* marker = *it;
-    marker->entity.advance(integrator, dt);
+    if (marker->entity.isContinuous()) {
+      advanceContinuous(integrator, marker->entity, dt);
+    } else {
+      marker->entity.advance(integrator, dt);
+    }
     ++it;
     place(*marker);
   }
@@ -337,11 +1170,70 @@ void reBSPTree::advance(re::Integrator& integrator, reFloat dt) {
   }
   
   // solves for the contact forces
-  _contacts.solve();
+  _contacts.solve(dt, scratch);
   // advances the contact collection
   _contacts.advance();
 }
 
+/**
+ * Advances an entity with continuous collision detection enabled. Entities
+ * which travel less than their bounding radius cannot pass through any shape
+ * unnoticed and are advanced normally. Otherwise the entity is swept along
+ * its path and advanced only as far as the first impact, left just inside
+ * the entity it hits so that the contact is picked up by the solver. The
+ * impact is resolved by exchanging a linear impulse along the contact
+ * normal, after which the rest of the time step is integrated in the same
+ * way. Only a limited number of impacts are resolved in a single step, and
+ * any time remaining after the last is dropped.
+ * 
+ * @param integrator The integration scheme
+ * @param entity The entity to advance
+ * @param dt The time step in user-defined units
+ */
+
+void reBSPTree::advanceContinuous(re::Integrator& integrator, re::Entity& entity, reFloat dt) {
+  for (reUInt impacts = 0; impacts < MAX_IMPACTS && dt > 0.0; impacts++) {
+    const re::Transform transform = entity.shapeTransform();
+    const re::vec3 start = entity.pos();
+    const re::quat orient = entity.orient();
+    entity.advance(integrator, dt);
+
+    const re::vec3 motion = entity.pos() - start;
+    re::vec3 center;
+    reFloat radius;
+    re::boundingSphere(entity.baseShape(), transform, center, radius);
+    if (re::lengthSq(motion) <= radius * radius) {
+      return;
+    }
+
+    re::SweepQuery result;
+    reBSPNode::querySweep(entity.baseShape(), transform, motion, center, radius, &entity, result);
+    if (result.entity == nullptr) {
+      return;
+    }
+
+    // integrate again up to the time of impact
+    entity.setPos(start);
+    entity.setOrient(orient);
+    if (result.time > 0.0) {
+      entity.advance(integrator, dt * result.time);
+      entity.setPos(entity.pos() - result.normal * RE_FP_TOLERANCE);
+    }
+    dt -= dt * result.time;
+
+    // the impulse which stops the approach, scaled by the restitution
+    re::Entity& other = *result.entity;
+    const reFloat massInv = entity.massInv() + other.massInv();
+    const reFloat approach = re::dot(entity.vel() - other.vel(), result.normal);
+    if (approach < 0.0 && massInv > 0.0) {
+      const reFloat restitution = re::max(entity.restitution(), other.restitution());
+      const re::vec3 impulse = result.normal * (-(1.0 + restitution) * approach / massInv);
+      entity.setVel(entity.vel() + impulse * entity.massInv());
+      other.setVel(other.vel() - impulse * other.massInv());
+    }
+  }
+}
+
 void reBSPTree::addInteraction(reInteraction& action, re::Entity& A, re::Entity& B) {
   _contacts.addInteraction(action, A, B);
 }
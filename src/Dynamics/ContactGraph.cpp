@@ -1,32 +1,191 @@
 #include "react/Dynamics/ContactGraph.h"
 
 #include "react/Collision/Shapes/shapes.h"
+#include "react/Utilities/ThreadPool.h"
+
+#include <cstring>
 
 using namespace re;
 
 const reUInt LIMIT = 10;
 
+namespace {
+  /** The default number of solver passes in each time step */
+  const reUInt DEFAULT_ITERATIONS = 10;
+  /** The fraction of the penetration corrected in each time step */
+  const reFloat BAUMGARTE = 0.2;
+  /** The penetration allowed before any correction is applied */
+  const reFloat SLOP = 0.01;
+  /** The approach speed below which contacts do not bounce */
+  const reFloat RESTITUTION_THRESHOLD = 0.5;
+  /** The number of colors available to the colored solver */
+  const reUInt MAX_COLORS = 64;
+
+  /** The colors used by a dynamic entity, one bit per color */
+  struct ColorMask {
+    re::ID id;
+    uint64_t mask;
+  };
+
+  /**
+   * Finds the slot of the entity in an open addressed table of color masks.
+   * Slots without colors are empty, so an entity without colors yields an
+   * empty slot which can be claimed for it.
+   */
+
+  ColorMask& findMask(ColorMask* table, reUInt capacity, re::ID id) {
+    reUInt i = (id * 2654435761u) & (capacity - 1);
+    while (table[i].mask != 0 && table[i].id != id) {
+      i = (i + 1) & (capacity - 1);
+    }
+    return table[i];
+  }
+
+  const re::mat3 worldInertiaInv(const Entity& entity) {
+    const re::mat3 rot = entity.rot();
+    return rot * entity.inertiaInv() * re::transpose(rot);
+  }
+
+  const re::vec3 velocityAt(const Entity& entity, const re::vec3& r) {
+    return entity.vel() + re::cross(entity.angVel(), r);
+  }
+
+  void applyImpulse(Entity& entity, const re::mat3& inertiaInv, const re::vec3& r, const re::vec3& impulse) {
+    entity.setVel(entity.vel() + impulse * entity.massInv());
+    entity.setAngVel(entity.angVel() + inertiaInv * re::cross(r, impulse));
+  }
+
+  reFloat effectiveMass(const ContactEdge& edge, const re::vec3& rA, const re::vec3& rB, const re::vec3& dir) {
+    const re::vec3 rAxD = re::cross(rA, dir);
+    const re::vec3 rBxD = re::cross(rB, dir);
+    const reFloat k = edge.A.massInv() + edge.B.massInv() +
+                      re::dot(rAxD, edge.inertiaInvA * rAxD) +
+                      re::dot(rBxD, edge.inertiaInvB * rBxD);
+    return (k > 0.0) ? 1.0 / k : 0.0;
+  }
+}
+
 /// NOT TESTED
-ContactEdge::ContactEdge(reAllocator& allocator, Entity& a, Entity& b) : re::Intersect(), A(a), B(b), contact(false), timeLimit(0), interactions(allocator) {
+ContactEdge::ContactEdge(reAllocator& allocator, Entity& a, Entity& b) : re::Intersect(), A(a), B(b), contact(false), timeLimit(0), interactions(allocator), manifold(), friction(0.0), inertiaInvA(), inertiaInvB() {
   check();
 }
 
-/// NOT TESTED
+/**
+ * Runs the narrow phase on the two entities and updates the contact manifold.
+ * Existing contact points are carried along with the entities, so that their
+ * accumulated impulses can be reused in this time step.
+ */
+
 void ContactEdge::check() {
   if (timeLimit++ == 0) {
     timeLimit = LIMIT;
   }
 
-  contact = re::intersects(A.shape(), A.transform(), B.shape(), B.transform(), *this);
+  contact = re::intersects(A.baseShape(), A.shapeTransform(), B.baseShape(), B.shapeTransform(), *this);
+  if (contact) {
+    manifold.refresh(A, B);
+    manifold.add(A, B, *this);
+  } else {
+    manifold.clear();
+  }
+}
+
+/**
+ * Computes the effective masses and target velocities at each contact point.
+ * The target velocities depend on the approach speed, so every contact must
+ * be prepared before any impulses are applied.
+ * 
+ * @param dt The time step in user-defined units
+ */
+
+void ContactEdge::prepare(reFloat dt) {
+  inertiaInvA = worldInertiaInv(A);
+  inertiaInvB = worldInertiaInv(B);
+  friction = re::sqrt(A.friction() * B.friction());
+  const reFloat restitution = re::max(A.restitution(), B.restitution());
+  const re::vec3& n = manifold.normal;
+
+  for (reUInt i = 0; i < manifold.size; i++) {
+    ContactPoint& cp = manifold.points[i];
+    cp.rA = cp.point - A.center();
+    cp.rB = cp.point - B.center();
+    cp.normalMass = effectiveMass(*this, cp.rA, cp.rB, n);
+    cp.tangentMass[0] = effectiveMass(*this, cp.rA, cp.rB, manifold.tangents[0]);
+    cp.tangentMass[1] = effectiveMass(*this, cp.rA, cp.rB, manifold.tangents[1]);
+
+    const reFloat vn = re::dot(velocityAt(A, cp.rA) - velocityAt(B, cp.rB), n);
+    cp.bias = BAUMGARTE / dt * re::max(cp.depth - SLOP, 0.0);
+    if (vn < -RESTITUTION_THRESHOLD) {
+      cp.bias = re::max(cp.bias, -restitution * vn);
+    }
+  }
+}
+
+/**
+ * Applies the impulses accumulated at each contact point in the previous time
+ * step, so that the solver starts close to the solution of a resting contact
+ */
+
+void ContactEdge::warmStart() {
+  for (reUInt i = 0; i < manifold.size; i++) {
+    const ContactPoint& cp = manifold.points[i];
+    const re::vec3 impulse = manifold.normal * cp.normalImpulse +
+                             manifold.tangents[0] * cp.tangentImpulse[0] +
+                             manifold.tangents[1] * cp.tangentImpulse[1];
+    applyImpulse(A, inertiaInvA, cp.rA, impulse);
+    applyImpulse(B, inertiaInvB, cp.rB, -impulse);
+  }
+}
+
+/**
+ * Makes a single solver pass over the contact points. The impulses are
+ * accumulated over the passes, and it is the accumulated impulse which is
+ * clamped to keep the contact repelling and the friction within its cone.
+ */
+
+void ContactEdge::solve() {
+  const re::vec3& n = manifold.normal;
+
+  for (reUInt i = 0; i < manifold.size; i++) {
+    ContactPoint& cp = manifold.points[i];
+
+    // friction is bounded by the normal impulse from the previous pass
+    const reFloat maxFriction = friction * cp.normalImpulse;
+    for (reUInt j = 0; j < 2; j++) {
+      const re::vec3& t = manifold.tangents[j];
+      const reFloat vt = re::dot(velocityAt(A, cp.rA) - velocityAt(B, cp.rB), t);
+      const reFloat previous = cp.tangentImpulse[j];
+      cp.tangentImpulse[j] = re::max(-maxFriction, re::min(previous - vt * cp.tangentMass[j], maxFriction));
+      const re::vec3 impulse = t * (cp.tangentImpulse[j] - previous);
+      applyImpulse(A, inertiaInvA, cp.rA, impulse);
+      applyImpulse(B, inertiaInvB, cp.rB, -impulse);
+    }
+
+    const reFloat vn = re::dot(velocityAt(A, cp.rA) - velocityAt(B, cp.rB), n);
+    const reFloat previous = cp.normalImpulse;
+    cp.normalImpulse = re::max(previous + (cp.bias - vn) * cp.normalMass, 0.0);
+    const re::vec3 impulse = n * (cp.normalImpulse - previous);
+    applyImpulse(A, inertiaInvA, cp.rA, impulse);
+    applyImpulse(B, inertiaInvB, cp.rB, -impulse);
+  }
 }
 
 /// NOT TESTED
-ContactGraph::ContactGraph(reAllocator& allocator) : _allocator(allocator), _edges(allocator) {
+ContactGraph::ContactGraph(reAllocator& allocator) : _allocator(allocator), _iterations(DEFAULT_ITERATIONS), _threads(0), _pool(nullptr), _lanes(allocator), _colorEnds(allocator), _uncolored(allocator), _edges(allocator) {
   // do nothing
 }
 
 /// NOT TESTED
 ContactGraph::~ContactGraph() {
+  _allocator.alloc_delete(_pool);
+  clear();
+}
+
+/**
+ * Removes all contacts and interactions. The interactions are destroyed.
+ */
+
+void ContactGraph::clear() {
   for (ContactEdge* edge : _edges) {
     for (reInteraction* action : edge->interactions) {
       _allocator.alloc_delete(action);
@@ -34,47 +193,193 @@ ContactGraph::~ContactGraph() {
     _allocator.alloc_delete(edge);
   }
   _edges.clear();
+  _edges.shrink();
+  _lanes.clear();
+  _lanes.shrink();
+  _colorEnds.clear();
+  _colorEnds.shrink();
+  _uncolored.clear();
+  _uncolored.shrink();
 }
 
-/// NOT TESTED
-void ContactGraph::solve() {
-  const reFloat epsilon = 0.9;
-  // TODO TEMPORARY
+/**
+ * Resolves the contacts found in this time step with a sequential impulse
+ * solver. Each contact is warm started with the impulses from the previous
+ * step, then the solver makes a fixed number of passes over all contacts.
+ * 
+ * @param dt The time step in user-defined units
+ * @param scratch The allocator for temporary data used within the time step
+ */
+
+void ContactGraph::solve(reFloat dt, reAllocator& scratch) {
   for (ContactEdge* edge : _edges) {
-    if (edge->contact) {
-      Entity& A = edge->A;
-      Entity& B = edge->B;
-      
-      const re::vec3 dA = edge->point - A.center();
-      const re::vec3 rA = dA - re::dot(dA, edge->normal) * dA;
-      const re::vec3 dB = edge->point - B.center();
-      const re::vec3 rB = dB - re::dot(dB, edge->normal) * dB;
-      const re::vec3 rAxN = re::cross(rA, edge->normal);
-      const re::vec3 rBxN = re::cross(rB, edge->normal);
-      
-      const re::vec3 inerA = A.inertiaInv() * rAxN;
-      const re::vec3 inerB = B.inertiaInv() * rBxN;
-      
-      const reFloat numer = -(1 + epsilon) *
-                            (re::dot(edge->normal, A.vel() - B.vel()) +
-                            (re::dot(A.angVel(), rAxN) - re::dot(B.angVel(), rBxN)));
-      
-      // contact forces must always be repelling
-      if (numer < 0.0) continue;
-      
-      const reFloat f = numer / (A.massInv() + B.massInv() + re::dot(rAxN, inerA) + re::dot(rBxN, inerB));
-      
-      const re::vec3 impulse = f * edge->normal;
-      
-      A.addImpulse(impulse);
-      B.addImpulse(-impulse);
-//      A.applyRotImpulse(impulse * rAxN);
-//      B.applyRotImpulse(impulse * inerB);
-    }
     for (reInteraction* action : edge->interactions) {
       action->solve(edge->A, edge->B);
     }
   }
+
+  for (ContactEdge* edge : _edges) {
+    if (edge->contact) {
+      edge->prepare(dt);
+    }
+  }
+
+  for (ContactEdge* edge : _edges) {
+    if (edge->contact) {
+      edge->warmStart();
+    }
+  }
+
+  if (_pool != nullptr) {
+    color(scratch);
+    for (reUInt i = 0; i < _iterations; i++) {
+      solveColored();
+    }
+    return;
+  }
+
+  for (reUInt i = 0; i < _iterations; i++) {
+    for (ContactEdge* edge : _edges) {
+      if (edge->contact) {
+        edge->solve();
+      }
+    }
+  }
+}
+
+/**
+ * Switches between the serial and the colored solver. The colored solver
+ * groups the contacts into batches in which no two contacts share a dynamic
+ * entity. Each batch is packed into re::ContactLanes, which are solved in
+ * parallel by the given number of threads. Static entities are only read by
+ * the solver, so contacts with the same static entity can share a batch.
+ * 
+ * @param threads The number of threads used by the colored solver, or 0 to
+ * use the serial solver
+ */
+
+void ContactGraph::setThreads(reUInt threads) {
+  _allocator.alloc_delete(_pool);
+  _pool = nullptr;
+  _threads = threads;
+  if (threads > 0) {
+    _pool = _allocator.alloc_new<re::ThreadPool>(threads);
+  }
+}
+
+/**
+ * Greedily assigns each contact the lowest color not yet used by either of
+ * its dynamic entities, then packs the contacts of each color into lanes.
+ * Contacts left without a color are solved serially after the batches.
+ * 
+ * @param scratch The allocator for the temporary tables, released by the
+ * caller at the end of the time step
+ */
+
+void ContactGraph::color(reAllocator& scratch) {
+  _uncolored.clear();
+  reUInt n = 0;
+  for (ContactEdge* edge : _edges) {
+    if (edge->contact) {
+      n++;
+    }
+  }
+
+  // each contact adds at most two entities, keep the table under half full
+  reUInt capacity = 8;
+  while (capacity < 4 * n) {
+    capacity *= 2;
+  }
+  ColorMask* masks = (ColorMask*)scratch.alloc(capacity * sizeof(ColorMask), __alignof(ColorMask));
+  memset(masks, 0, capacity * sizeof(ColorMask));
+  ContactEdge** colored = (ContactEdge**)scratch.alloc((n + 1) * sizeof(ContactEdge*), __alignof(ContactEdge*));
+  ContactEdge** sorted = (ContactEdge**)scratch.alloc((n + 1) * sizeof(ContactEdge*), __alignof(ContactEdge*));
+  u8* colors = (u8*)scratch.alloc(n + 1, 1);
+  reUInt numColored = 0;
+  reUInt counts[MAX_COLORS] = { 0 };
+
+  for (ContactEdge* edge : _edges) {
+    if (!edge->contact) {
+      continue;
+    }
+
+    const bool dynamicA = edge->A.type() != Entity::STATIC;
+    const bool dynamicB = edge->B.type() != Entity::STATIC;
+    const uint64_t used = (dynamicA ? findMask(masks, capacity, edge->A.id()).mask : 0) |
+                          (dynamicB ? findMask(masks, capacity, edge->B.id()).mask : 0);
+    if (~used == 0) {
+      _uncolored.add(edge);
+      continue;
+    }
+
+    const reUInt color = __builtin_ctzll(~used);
+    if (dynamicA) {
+      ColorMask& slot = findMask(masks, capacity, edge->A.id());
+      slot.id = edge->A.id();
+      slot.mask |= (uint64_t)1 << color;
+    }
+    if (dynamicB) {
+      ColorMask& slot = findMask(masks, capacity, edge->B.id());
+      slot.id = edge->B.id();
+      slot.mask |= (uint64_t)1 << color;
+    }
+    colored[numColored] = edge;
+    colors[numColored] = color;
+    numColored++;
+    counts[color]++;
+  }
+
+  // sort the contacts by color, then pack each color into lanes
+  reUInt starts[MAX_COLORS];
+  reUInt numLanes = 0;
+  reUInt total = 0;
+  _colorEnds.clear();
+  for (reUInt c = 0; c < MAX_COLORS && counts[c] > 0; c++) {
+    starts[c] = total;
+    total += counts[c];
+    numLanes += (counts[c] + ContactLanes::WIDTH - 1) / ContactLanes::WIDTH;
+    _colorEnds.add(numLanes);
+  }
+
+  for (reUInt i = 0; i < numColored; i++) {
+    sorted[starts[colors[i]]++] = colored[i];
+  }
+
+  _lanes.clear();
+  _lanes.reserve(numLanes);
+  total = 0;
+  for (reUInt c = 0; c < _colorEnds.size(); c++) {
+    for (reUInt i = 0; i < counts[c]; i += ContactLanes::WIDTH) {
+      const reUInt n = (counts[c] - i < ContactLanes::WIDTH) ? counts[c] - i : ContactLanes::WIDTH;
+      _lanes[_lanes.add(ContactLanes())].pack(&sorted[total + i], n);
+    }
+    total += counts[c];
+  }
+
+  scratch.dealloc(colors);
+  scratch.dealloc(sorted);
+  scratch.dealloc(colored);
+  scratch.dealloc(masks);
+}
+
+/**
+ * Makes a single solver pass over all contacts, one color at a time. The
+ * lanes of a color share no dynamic entities, so they are solved in parallel.
+ */
+
+void ContactGraph::solveColored() {
+  reUInt begin = 0;
+  for (reUInt end : _colorEnds) {
+    re::ContactLanes* lanes = &_lanes[begin];
+    _pool->run(end - begin, [lanes](reUInt i) {
+      lanes[i].solve();
+    });
+    begin = end;
+  }
+
+  for (ContactEdge* edge : _uncolored) {
+    edge->solve();
+  }
 }
 
 /// NOT TESTED
@@ -99,20 +404,18 @@ void ContactGraph::check(Entity& A, Entity& B) {
 
 /// NOT TESTED
 void ContactGraph::advance() {
-  reLinkedList<ContactEdge*> toRemove(_allocator);
-  // checks for rejected edges
-  for (ContactEdge* edge : _edges) {
+  // walk backwards, so edges moved into a gap have already been checked
+  for (reUInt i = _edges.size(); i-- > 0;) {
+    ContactEdge* edge = _edges[i];
+    // contacts must be confirmed by the narrow phase in each time step
+    edge->contact = false;
     if (edge->timeLimit != 0) edge->timeLimit--;
     if (edge->timeLimit == 0 && edge->interactions.empty()) {
-      toRemove.add(edge);
+      // removes the rejected edge
+      _edges.removeAt(i);
+      _allocator.alloc_delete(edge);
     }
   }
-  
-  // removes all rejected edges
-  for (ContactEdge* edge : toRemove) {
-    _edges.remove(edge);
-    _allocator.alloc_delete(edge);
-  }
 }
 
 /// NOT TESTED
@@ -0,0 +1,206 @@
+#include "react/Dynamics/ContactLanes.h"
+
+#include "react/Dynamics/ContactGraph.h"
+
+using namespace re;
+
+namespace {
+  const reUInt WIDTH = ContactLanes::WIDTH;
+
+  /** The velocities of the entities in each lane */
+  struct LaneVelocities {
+    reFloat vax[WIDTH], vay[WIDTH], vaz[WIDTH];
+    reFloat wax[WIDTH], way[WIDTH], waz[WIDTH];
+    reFloat vbx[WIDTH], vby[WIDTH], vbz[WIDTH];
+    reFloat wbx[WIDTH], wby[WIDTH], wbz[WIDTH];
+  };
+
+  void fillRow(LaneRow& row, reUInt lane, const ContactEdge& edge, const ContactPoint& cp, const re::vec3& dir, reFloat mass) {
+    const re::vec3 a = re::cross(cp.rA, dir);
+    const re::vec3 b = re::cross(cp.rB, dir);
+    const re::vec3 ia = edge.inertiaInvA * a;
+    const re::vec3 ib = edge.inertiaInvB * b;
+    row.dx[lane] = dir[0]; row.dy[lane] = dir[1]; row.dz[lane] = dir[2];
+    row.ax[lane] = a[0]; row.ay[lane] = a[1]; row.az[lane] = a[2];
+    row.bx[lane] = b[0]; row.by[lane] = b[1]; row.bz[lane] = b[2];
+    row.iax[lane] = ia[0]; row.iay[lane] = ia[1]; row.iaz[lane] = ia[2];
+    row.ibx[lane] = ib[0]; row.iby[lane] = ib[1]; row.ibz[lane] = ib[2];
+    row.mass[lane] = mass;
+  }
+
+  void clearRow(LaneRow& row, reUInt lane) {
+    row.dx[lane] = row.dy[lane] = row.dz[lane] = 0.0;
+    row.ax[lane] = row.ay[lane] = row.az[lane] = 0.0;
+    row.bx[lane] = row.by[lane] = row.bz[lane] = 0.0;
+    row.iax[lane] = row.iay[lane] = row.iaz[lane] = 0.0;
+    row.ibx[lane] = row.iby[lane] = row.ibz[lane] = 0.0;
+    row.mass[lane] = 0.0;
+  }
+
+#ifdef RE_SIMD
+  inline __m128 dot(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+  }
+
+  inline void accumulate(reFloat* v, __m128 d, __m128 scale) {
+    _mm_storeu_ps(v, _mm_add_ps(_mm_loadu_ps(v), _mm_mul_ps(d, scale)));
+  }
+
+  void solveRow(const LaneRow& row, const ContactLanes& lanes, const reFloat* bias, const reFloat* lo, const reFloat* hi, reFloat* impulse, LaneVelocities& v) {
+    const __m128 dx = _mm_loadu_ps(row.dx), dy = _mm_loadu_ps(row.dy), dz = _mm_loadu_ps(row.dz);
+    const __m128 vrel = _mm_sub_ps(
+      _mm_add_ps(
+        dot(_mm_sub_ps(_mm_loadu_ps(v.vax), _mm_loadu_ps(v.vbx)), _mm_sub_ps(_mm_loadu_ps(v.vay), _mm_loadu_ps(v.vby)), _mm_sub_ps(_mm_loadu_ps(v.vaz), _mm_loadu_ps(v.vbz)), dx, dy, dz),
+        dot(_mm_loadu_ps(v.wax), _mm_loadu_ps(v.way), _mm_loadu_ps(v.waz), _mm_loadu_ps(row.ax), _mm_loadu_ps(row.ay), _mm_loadu_ps(row.az))
+      ),
+      dot(_mm_loadu_ps(v.wbx), _mm_loadu_ps(v.wby), _mm_loadu_ps(v.wbz), _mm_loadu_ps(row.bx), _mm_loadu_ps(row.by), _mm_loadu_ps(row.bz))
+    );
+    const __m128 target = (bias != nullptr) ? _mm_loadu_ps(bias) : _mm_setzero_ps();
+    const __m128 previous = _mm_loadu_ps(impulse);
+    const __m128 lambda = _mm_mul_ps(_mm_loadu_ps(row.mass), _mm_sub_ps(target, vrel));
+    const __m128 clamped = _mm_min_ps(_mm_max_ps(_mm_add_ps(previous, lambda), _mm_loadu_ps(lo)), _mm_loadu_ps(hi));
+    _mm_storeu_ps(impulse, clamped);
+
+    const __m128 delta = _mm_sub_ps(clamped, previous);
+    const __m128 deltaA = _mm_mul_ps(delta, _mm_loadu_ps(lanes.massInvA));
+    const __m128 deltaB = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(delta, _mm_loadu_ps(lanes.massInvB)));
+    const __m128 negDelta = _mm_sub_ps(_mm_setzero_ps(), delta);
+    accumulate(v.vax, dx, deltaA); accumulate(v.vay, dy, deltaA); accumulate(v.vaz, dz, deltaA);
+    accumulate(v.vbx, dx, deltaB); accumulate(v.vby, dy, deltaB); accumulate(v.vbz, dz, deltaB);
+    accumulate(v.wax, _mm_loadu_ps(row.iax), delta); accumulate(v.way, _mm_loadu_ps(row.iay), delta); accumulate(v.waz, _mm_loadu_ps(row.iaz), delta);
+    accumulate(v.wbx, _mm_loadu_ps(row.ibx), negDelta); accumulate(v.wby, _mm_loadu_ps(row.iby), negDelta); accumulate(v.wbz, _mm_loadu_ps(row.ibz), negDelta);
+  }
+#else
+  void solveRow(const LaneRow& row, const ContactLanes& lanes, const reFloat* bias, const reFloat* lo, const reFloat* hi, reFloat* impulse, LaneVelocities& v) {
+    for (reUInt i = 0; i < WIDTH; i++) {
+      const reFloat vrel = (v.vax[i] - v.vbx[i]) * row.dx[i] + (v.vay[i] - v.vby[i]) * row.dy[i] + (v.vaz[i] - v.vbz[i]) * row.dz[i] +
+                           v.wax[i] * row.ax[i] + v.way[i] * row.ay[i] + v.waz[i] * row.az[i] -
+                           v.wbx[i] * row.bx[i] - v.wby[i] * row.by[i] - v.wbz[i] * row.bz[i];
+      const reFloat target = (bias != nullptr) ? bias[i] : 0.0;
+      const reFloat previous = impulse[i];
+      impulse[i] = re::min(re::max(previous + row.mass[i] * (target - vrel), lo[i]), hi[i]);
+
+      const reFloat delta = impulse[i] - previous;
+      const reFloat deltaA = delta * lanes.massInvA[i];
+      const reFloat deltaB = delta * lanes.massInvB[i];
+      v.vax[i] += row.dx[i] * deltaA; v.vay[i] += row.dy[i] * deltaA; v.vaz[i] += row.dz[i] * deltaA;
+      v.vbx[i] -= row.dx[i] * deltaB; v.vby[i] -= row.dy[i] * deltaB; v.vbz[i] -= row.dz[i] * deltaB;
+      v.wax[i] += row.iax[i] * delta; v.way[i] += row.iay[i] * delta; v.waz[i] += row.iaz[i] * delta;
+      v.wbx[i] -= row.ibx[i] * delta; v.wby[i] -= row.iby[i] * delta; v.wbz[i] -= row.ibz[i] * delta;
+    }
+  }
+#endif
+
+  void gather(const Entity& entity, reUInt lane, reFloat* vx, reFloat* vy, reFloat* vz, reFloat* wx, reFloat* wy, reFloat* wz) {
+    const re::vec3& v = entity.vel();
+    const re::vec3& w = entity.angVel();
+    vx[lane] = v[0]; vy[lane] = v[1]; vz[lane] = v[2];
+    wx[lane] = w[0]; wy[lane] = w[1]; wz[lane] = w[2];
+  }
+
+  void scatter(Entity& entity, reUInt lane, const reFloat* vx, const reFloat* vy, const reFloat* vz, const reFloat* wx, const reFloat* wy, const reFloat* wz) {
+    // static entities may be shared between lanes solved on other threads
+    if (entity.type() != Entity::STATIC) {
+      entity.setVel(re::vec3(vx[lane], vy[lane], vz[lane]));
+      entity.setAngVel(re::vec3(wx[lane], wy[lane], wz[lane]));
+    }
+  }
+}
+
+/**
+ * Packs the prepared contact points of the edges into the lanes. Lanes past
+ * the number of edges, and points past the size of an edge's manifold, are
+ * given zero mass so that they never produce an impulse.
+ *
+ * @param edges The edges to pack, which have been prepared for solving
+ * @param n The number of edges, which must be between 1 and ContactLanes::WIDTH
+ */
+
+void ContactLanes::pack(ContactEdge* const* edges, reUInt n) {
+  RE_ASSERT(n > 0 && n <= WIDTH)
+
+  size = n;
+  points = 0;
+  for (reUInt i = 0; i < WIDTH; i++) {
+    ContactEdge* edge = (i < n) ? edges[i] : nullptr;
+    this->edges[i] = edge;
+    massInvA[i] = (edge != nullptr) ? edge->A.massInv() : 0.0;
+    massInvB[i] = (edge != nullptr) ? edge->B.massInv() : 0.0;
+    friction[i] = (edge != nullptr) ? edge->friction : 0.0;
+    if (edge != nullptr && edge->manifold.size > points) {
+      points = edge->manifold.size;
+    }
+  }
+
+  for (reUInt k = 0; k < points; k++) {
+    for (reUInt i = 0; i < WIDTH; i++) {
+      const ContactEdge* edge = this->edges[i];
+      if (edge == nullptr || k >= edge->manifold.size) {
+        for (reUInt r = 0; r < 3; r++) {
+          clearRow(rows[k][r], i);
+          impulses[k][r][i] = 0.0;
+        }
+        bias[k][i] = 0.0;
+        continue;
+      }
+
+      const ContactManifold& manifold = edge->manifold;
+      const ContactPoint& cp = manifold.points[k];
+      fillRow(rows[k][0], i, *edge, cp, manifold.tangents[0], cp.tangentMass[0]);
+      fillRow(rows[k][1], i, *edge, cp, manifold.tangents[1], cp.tangentMass[1]);
+      fillRow(rows[k][2], i, *edge, cp, manifold.normal, cp.normalMass);
+      impulses[k][0][i] = cp.tangentImpulse[0];
+      impulses[k][1][i] = cp.tangentImpulse[1];
+      impulses[k][2][i] = cp.normalImpulse;
+      bias[k][i] = cp.bias;
+    }
+  }
+}
+
+/**
+ * Makes a single solver pass over every contact point in the lanes, in the
+ * same order as ContactEdge::solve, then writes the new velocities and
+ * accumulated impulses back
+ */
+
+void ContactLanes::solve() {
+  LaneVelocities v;
+  for (reUInt i = 0; i < WIDTH; i++) {
+    if (i < size) {
+      gather(edges[i]->A, i, v.vax, v.vay, v.vaz, v.wax, v.way, v.waz);
+      gather(edges[i]->B, i, v.vbx, v.vby, v.vbz, v.wbx, v.wby, v.wbz);
+    } else {
+      v.vax[i] = v.vay[i] = v.vaz[i] = v.wax[i] = v.way[i] = v.waz[i] = 0.0;
+      v.vbx[i] = v.vby[i] = v.vbz[i] = v.wbx[i] = v.wby[i] = v.wbz[i] = 0.0;
+    }
+  }
+
+  reFloat lo[WIDTH], hi[WIDTH];
+  for (reUInt k = 0; k < points; k++) {
+    // friction is bounded by the normal impulse from the previous pass
+    for (reUInt i = 0; i < WIDTH; i++) {
+      hi[i] = friction[i] * impulses[k][2][i];
+      lo[i] = -hi[i];
+    }
+    solveRow(rows[k][0], *this, nullptr, lo, hi, impulses[k][0], v);
+    solveRow(rows[k][1], *this, nullptr, lo, hi, impulses[k][1], v);
+
+    for (reUInt i = 0; i < WIDTH; i++) {
+      lo[i] = 0.0;
+      hi[i] = RE_INFINITY;
+    }
+    solveRow(rows[k][2], *this, bias[k], lo, hi, impulses[k][2], v);
+  }
+
+  for (reUInt i = 0; i < size; i++) {
+    ContactEdge& edge = *edges[i];
+    scatter(edge.A, i, v.vax, v.vay, v.vaz, v.wax, v.way, v.waz);
+    scatter(edge.B, i, v.vbx, v.vby, v.vbz, v.wbx, v.wby, v.wbz);
+    for (reUInt k = 0; k < edge.manifold.size; k++) {
+      ContactPoint& cp = edge.manifold.points[k];
+      cp.tangentImpulse[0] = impulses[k][0][i];
+      cp.tangentImpulse[1] = impulses[k][1][i];
+      cp.normalImpulse = impulses[k][2][i];
+    }
+  }
+}
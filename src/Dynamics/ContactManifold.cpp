@@ -0,0 +1,103 @@
+#include "react/Dynamics/ContactManifold.h"
+
+using namespace re;
+
+namespace {
+  /** The drift beyond which a contact point is considered broken */
+  const reFloat BREAKING_DISTANCE = 0.05;
+  /** The cosine of the angle beyond which the contact normal is replaced */
+  const reFloat NORMAL_COHERENCE = 0.95;
+
+  void computeTangents(const re::vec3& n, re::vec3& t1, re::vec3& t2) {
+    if (re::abs(n[0]) > 0.57) {
+      t1 = re::normalize(re::vec3(n[1], -n[0], 0.0));
+    } else {
+      t1 = re::normalize(re::vec3(0.0, n[2], -n[1]));
+    }
+    t2 = re::cross(n, t1);
+  }
+}
+
+/**
+ * Moves the contact points along with the entities, updating the penetration
+ * depth of each point. Points which have separated or drifted apart are
+ * removed from the manifold.
+ *
+ * @param A The first entity in contact
+ * @param B The second entity in contact
+ */
+
+void ContactManifold::refresh(const re::Entity& A, const re::Entity& B) {
+  const re::RigidTransform tA = A.rigidTransform();
+  const re::RigidTransform tB = B.rigidTransform();
+
+  reUInt kept = 0;
+  for (reUInt i = 0; i < size; i++) {
+    ContactPoint& cp = points[i];
+    const re::vec3 pA = tA.applyToPoint(cp.localA);
+    const re::vec3 pB = tB.applyToPoint(cp.localB);
+    const re::vec3 d = pB - pA;
+    const reFloat depth = re::dot(d, normal);
+    const re::vec3 drift = d - normal * depth;
+
+    if (depth < -BREAKING_DISTANCE || re::lengthSq(drift) > BREAKING_DISTANCE * BREAKING_DISTANCE) {
+      continue;
+    }
+
+    cp.point = (pA + pB) * 0.5;
+    cp.depth = depth;
+    points[kept++] = cp;
+  }
+  size = kept;
+}
+
+/**
+ * Merges a contact reported by the narrow phase into the manifold. A point
+ * close to an existing point replaces it but keeps its accumulated impulses.
+ * When the manifold is full, the shallowest point is discarded to make room.
+ *
+ * @param A The first entity in contact
+ * @param B The second entity in contact
+ * @param intersect The contact, with the normal pointing from B towards A
+ */
+
+void ContactManifold::add(const re::Entity& A, const re::Entity& B, const re::Intersect& intersect) {
+  // impulses along a different normal are no longer meaningful
+  if (size > 0 && re::dot(normal, intersect.normal) < NORMAL_COHERENCE) {
+    clear();
+  }
+  normal = intersect.normal;
+  computeTangents(normal, tangents[0], tangents[1]);
+
+  ContactPoint cp;
+  cp.point = intersect.point;
+  cp.depth = intersect.depth;
+  // the anchors are placed so that their separation along the normal is the
+  // penetration depth, allowing the depth to be tracked in ContactManifold::refresh
+  cp.localA = re::inverse(A.rigidTransform()).applyToPoint(intersect.point - normal * (intersect.depth * 0.5));
+  cp.localB = re::inverse(B.rigidTransform()).applyToPoint(intersect.point + normal * (intersect.depth * 0.5));
+
+  reUInt slot = size;
+  for (reUInt i = 0; i < size; i++) {
+    if (re::lengthSq(points[i].point - cp.point) < BREAKING_DISTANCE * BREAKING_DISTANCE) {
+      slot = i;
+      cp.normalImpulse = points[i].normalImpulse;
+      cp.tangentImpulse[0] = points[i].tangentImpulse[0];
+      cp.tangentImpulse[1] = points[i].tangentImpulse[1];
+      break;
+    }
+  }
+
+  if (slot == MAX_POINTS) {
+    slot = 0;
+    for (reUInt i = 1; i < size; i++) {
+      if (points[i].depth < points[slot].depth) {
+        slot = i;
+      }
+    }
+  } else if (slot == size) {
+    size++;
+  }
+
+  points[slot] = cp;
+}
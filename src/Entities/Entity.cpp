@@ -14,9 +14,42 @@ re::ID Entity::globalEntID = 1;
  */
 
 bool Entity::intersects(const re::Ray& ray, re::Intersect& intersect) const {
-  return re::intersects(_shape, transform(), ray, intersect);
+  return re::intersects(*_base, _shapeTransform, _shapeTransformInv, ray, intersect);
+}
+
+/**
+ * Returns true if the Entity blocks the ray before the maximum distance,
+ * without computing the point of intersection
+ * 
+ * @param ray The ray object
+ * @param maxDist The distance along the ray beyond which hits are ignored
+ */
+
+bool Entity::occludes(const re::Ray& ray, reFloat maxDist) const {
+  return re::occludes(*_base, _shapeTransformInv, ray, maxDist);
 }
 
 re::Location Entity::relativeToPlane(const re::Plane& plane) {
-  return re::relativeToPlane(_shape, transform(), plane);
+  return re::relativeToPlane(*_base, _shapeTransform, _shapeTransformInv, plane);
+}
+
+/**
+ * Updates the cached shape transforms, flattening the shape offset and any
+ * proxy transforms into a single transform and its inverse. The inverse is built from the transpose
+ * of the placed rotation and the inverses cached by each proxy, so no
+ * general matrix inversion is needed.
+ * 
+ * @param transform The current rigid transform of the entity
+ */
+
+void Entity::updateTransform(const re::RigidTransform& transform) {
+  const re::RigidTransform placed = transform * _shapeOffset;
+  _shapeTransform = re::toTransform(placed);
+  _shapeTransformInv = re::rigidInverse(_shapeTransform);
+  for (const reShape* shape = &_shape; shape != _base;) {
+    const re::ShapeProxy* proxy = (const re::ShapeProxy*)shape;
+    _shapeTransform *= proxy->transform();
+    _shapeTransformInv = proxy->transformInv() * _shapeTransformInv;
+    shape = proxy->shape();
+  }
 }
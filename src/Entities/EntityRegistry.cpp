@@ -0,0 +1,115 @@
+#include "react/Entities/EntityRegistry.h"
+
+#include "react/Entities/Entity.h"
+
+using namespace re;
+
+namespace {
+  const reUInt NO_SLOT = 0xFFFFFFFF;
+}
+
+const reUInt EntityRegistry::MAX_ENTITIES;
+
+EntityRegistry::EntityRegistry(reAllocator& allocator) : _slots(allocator), _entities(allocator), _owners(allocator), _free(NO_SLOT) {
+  // do nothing
+}
+
+EntityRegistry::~EntityRegistry() {
+  clear();
+}
+
+/**
+ * Registers the entity and issues a handle for it. Freed slots are reused
+ * before new ones are created.
+ *
+ * @param entity The entity to register, which must not be registered already
+ * @return The handle referring to the entity
+ */
+
+EntityHandle EntityRegistry::add(Entity& entity) {
+  RE_ASSERT(entity.handle().isNull())
+
+  reUInt index;
+  if (_free != NO_SLOT) {
+    index = _free;
+    _free = _slots[index].next;
+  } else {
+    RE_ASSERT_MSG(_slots.size() < MAX_ENTITIES, "Too many entities registered!")
+    // generations start from one so that no handle has a value of zero
+    index = _slots.add({ 1, 0 });
+  }
+
+  Slot& slot = _slots[index];
+  slot.next = _entities.add(&entity);
+  _owners.add(index);
+
+  const EntityHandle handle(index, slot.generation);
+  entity._handle = handle;
+  return handle;
+}
+
+/**
+ * Unregisters the entity referred to by the handle. The slot's generation is
+ * advanced, so all outstanding handles to the entity become invalid.
+ *
+ * @param handle The handle of the entity to unregister
+ * @return True if the handle was valid
+ */
+
+bool EntityRegistry::remove(EntityHandle handle) {
+  if (!contains(handle)) {
+    return false;
+  }
+
+  const reUInt index = handle.index();
+  Slot& slot = _slots[index];
+  const reUInt dense = slot.next;
+  _entities[dense]->_handle = EntityHandle();
+
+  // the last entity moves into the gap, so its slot must follow it
+  _entities.removeAt(dense);
+  _owners.removeAt(dense);
+  if (dense < _owners.size()) {
+    _slots[_owners[dense]].next = dense;
+  }
+
+  // skips zero on wrapping around, so that no handle has a value of zero
+  slot.generation = (slot.generation == EntityHandle::GENERATION_MASK) ? 1 : slot.generation + 1;
+  slot.next = _free;
+  _free = index;
+  return true;
+}
+
+/**
+ * Unregisters the entity, which must be registered with this registry
+ *
+ * @param entity The entity to unregister
+ */
+
+void EntityRegistry::remove(Entity& entity) {
+  RE_ASSERT_MSG(get(entity.handle()) == &entity, "Entity is not registered here!")
+  remove(entity.handle());
+}
+
+/**
+ * Ensures that the given number of entities can be registered without the
+ * packed arrays growing
+ *
+ * @param capacity The number of entities to make room for
+ */
+
+void EntityRegistry::reserve(reUInt capacity) {
+  _entities.reserve(capacity);
+  _owners.reserve(capacity);
+}
+
+/**
+ * Unregisters all entities. The slots are kept, so handles issued before
+ * clearing remain invalid afterwards.
+ */
+
+void EntityRegistry::clear() {
+  while (!_entities.empty()) {
+    remove(_entities[_entities.size() - 1]->handle());
+  }
+}
@@ -0,0 +1,157 @@
+#include "react/Memory/reChunkedFreeListAllocator.h"
+
+#include <new>
+#include <sys/mman.h>
+
+#include "react/common.h"
+
+const u32 reChunkedFreeListAllocator::CHUNK_SIZE;
+
+namespace {
+  /** The space taken by the chunk header, keeping the free list aligned */
+  template <class T> u32 headerSize() {
+    return (sizeof(T) + 15) & ~15u;
+  }
+}
+
+reChunkedFreeListAllocator::Chunk::Chunk(u32 b, void* start) : prev(nullptr), next(nullptr), bytes(b), list(b - headerSize<Chunk>(), start) {
+  // do nothing
+}
+
+/**
+ * Creates an empty allocator, chunks are only mapped once they are needed
+ */
+
+reChunkedFreeListAllocator::reChunkedFreeListAllocator() : reBaseAllocator(), _used(0), _numAllocs(0), _size(0), _chunks(nullptr), _numChunks(0) {
+  // do nothing
+}
+
+reChunkedFreeListAllocator::~reChunkedFreeListAllocator() {
+  while (_chunks != nullptr) {
+    unmap(_chunks);
+  }
+}
+
+void* reChunkedFreeListAllocator::alloc(u32 size, u8 alignment) {
+  RE_ASSERT(size != 0)
+
+  for (Chunk* chunk = _chunks; chunk != nullptr; chunk = chunk->next) {
+    // blocks past the first chunk size could not be traced back to the chunk
+    if (chunk->bytes > CHUNK_SIZE) {
+      continue;
+    }
+
+    const u32 before = chunk->list.used();
+    void* p = chunk->list.tryAlloc(size, alignment);
+    if (p != nullptr) {
+      _used += chunk->list.used() - before;
+      _numAllocs++;
+      return p;
+    }
+  }
+
+  // the worst case overhead of a free list allocation is its alignment and header
+  const u32 needed = headerSize<Chunk>() + size + alignment + 16;
+  const u32 bytes = needed > CHUNK_SIZE ? (needed + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE : CHUNK_SIZE;
+  Chunk* chunk = map(bytes);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+
+  void* p = chunk->list.tryAlloc(size, alignment);
+  RE_ASSERT(p != nullptr)
+  _used += chunk->list.used();
+  _numAllocs++;
+
+  return p;
+}
+
+void reChunkedFreeListAllocator::dealloc(void* p) {
+  Chunk* chunk = (Chunk*)((uptr)p & ~(uptr)(CHUNK_SIZE - 1));
+
+  const u32 before = chunk->list.used();
+  chunk->list.dealloc(p);
+  _used -= before - chunk->list.used();
+  _numAllocs--;
+
+  if (chunk->list.numAllocs() != 0) {
+    return;
+  }
+
+  // keep a single empty chunk as a spare, return any other to the system
+  for (Chunk* other = _chunks; other != nullptr; other = other->next) {
+    if (other != chunk && other->list.numAllocs() == 0) {
+      unmap(chunk->bytes > CHUNK_SIZE ? chunk : other);
+      return;
+    }
+  }
+  if (chunk->bytes > CHUNK_SIZE) {
+    unmap(chunk);
+  }
+}
+
+/**
+ * Maps a new chunk aligned to the chunk size and places it at the front of
+ * the list of chunks. The mapping is made larger than needed, and the
+ * unaligned ends are unmapped again.
+ *
+ * @param bytes The size of the chunk, a multiple of the chunk size
+ * @return The new chunk, or a null pointer if the system is out of memory
+ */
+
+reChunkedFreeListAllocator::Chunk* reChunkedFreeListAllocator::map(u32 bytes) {
+  const size_t length = (size_t)bytes + CHUNK_SIZE;
+  void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    RE_WARN("Couldn\'t map a chunk of memory from the system!\n")
+    return nullptr;
+  }
+
+  const uptr start = (uptr)memory;
+  const uptr aligned = (start + CHUNK_SIZE - 1) & ~(uptr)(CHUNK_SIZE - 1);
+  if (aligned != start) {
+    munmap(memory, aligned - start);
+  }
+  if (aligned + bytes != start + length) {
+    munmap((void*)(aligned + bytes), start + length - aligned - bytes);
+  }
+
+#ifdef MADV_HUGEPAGE
+  madvise((void*)aligned, bytes, MADV_HUGEPAGE);
+#endif
+
+  Chunk* chunk = new ((void*)aligned) Chunk(bytes, (void*)(aligned + headerSize<Chunk>()));
+  chunk->next = _chunks;
+  if (_chunks != nullptr) {
+    _chunks->prev = chunk;
+  }
+  _chunks = chunk;
+  _size += bytes;
+  _numChunks++;
+
+  return chunk;
+}
+
+/**
+ * Unlinks the chunk and returns its memory to the system
+ *
+ * @param chunk The chunk to unmap
+ */
+
+void reChunkedFreeListAllocator::unmap(Chunk* chunk) {
+  if (chunk->prev != nullptr) {
+    chunk->prev->next = chunk->next;
+  } else {
+    _chunks = chunk->next;
+  }
+  if (chunk->next != nullptr) {
+    chunk->next->prev = chunk->prev;
+  }
+
+  const u32 bytes = chunk->bytes;
+  _size -= bytes;
+  _numChunks--;
+
+  chunk->~Chunk();
+  munmap(chunk, bytes);
+}
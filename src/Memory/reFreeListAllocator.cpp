@@ -15,6 +15,7 @@ reFreeListAllocator::reFreeListAllocator(u32 size, void* start) : reBaseAllocato
 _used(0), _numAllocs(0), _size(size), _ptr(start),
 _freeBlocks((FreeBlock*)start) {
   RE_ASSERT_MSG(size > sizeof(FreeBlock), "Allocated memory is too small!")
+  RE_ASSERT_MSG((uptr)start % __alignof(FreeBlock) == 0, "Allocated memory is misaligned!")
   
 #ifdef RE_ZERO_MEMORY
   memset(start, RE_ZERO_MEM_VAL, size);
@@ -29,8 +30,29 @@ reFreeListAllocator::~reFreeListAllocator() {
 }
 
 void* reFreeListAllocator::alloc(u32 size, u8 alignment) {
+  void* p = tryAlloc(size, alignment);
+  if (p == nullptr) {
+    RE_WARN("Couldn\'t find a free memory block large enough!\n")
+  }
+  
+  return p;
+}
+
+/**
+ * Allocates memory from the first free block large enough, or returns a null
+ * pointer without any warning if there is none
+ * 
+ * @param size The size of the memory to allocate
+ * @param alignment The required alignment
+ * @return A pointer to the allocated address, or a null pointer
+ */
+
+void* reFreeListAllocator::tryAlloc(u32 size, u8 alignment) {
   RE_ASSERT(size != 0)
   
+  // keeps every block aligned to hold a free block once it is released
+  size = (size + __alignof(FreeBlock) - 1) & ~(u32)(__alignof(FreeBlock) - 1);
+  
   // check free blocks
   FreeBlock* prevFreeBlock = nullptr;
   FreeBlock* freeBlock = _freeBlocks;
@@ -38,18 +60,19 @@ void* reFreeListAllocator::alloc(u32 size, u8 alignment) {
   while (freeBlock) {
     // calculate adjustment needed to keep object correctly aligned
     u8 adjustment = alignAdjustmentWithHeader(freeBlock, alignment, sizeof(Header));
+    u32 total = size + adjustment;
     
     // skip block if it is too small
-    if (size + adjustment > freeBlock->size) {
+    if (total > freeBlock->size) {
       prevFreeBlock = freeBlock;
       freeBlock = prevFreeBlock->next;
       continue;
     }
     
-    // if we ran out of memory
-    if (freeBlock->size - size - adjustment <= sizeof(Header)) {
+    // the remaining memory is too small to be a free block
+    if (freeBlock->size - total < sizeof(FreeBlock)) {
       // increases allocation size instead of creating a new block
-      size = freeBlock->size;
+      total = freeBlock->size;
       
       if (prevFreeBlock != nullptr) {
         prevFreeBlock->next = freeBlock->next;
@@ -57,9 +80,10 @@ void* reFreeListAllocator::alloc(u32 size, u8 alignment) {
         _freeBlocks = freeBlock->next;
       }
     } else {
-      // create a new free block from the remaining memory
-      FreeBlock* nextBlock = (FreeBlock*)( (uptr)freeBlock + size + adjustment);
-      nextBlock->size = freeBlock->size - size - adjustment;
+      // create a new free block from the remaining memory, in the same place
+      // in the list to keep it sorted by address
+      FreeBlock* nextBlock = (FreeBlock*)( (uptr)freeBlock + total);
+      nextBlock->size = freeBlock->size - total;
       nextBlock->next = freeBlock->next;
       
       if (prevFreeBlock != nullptr) {
@@ -72,7 +96,7 @@ void* reFreeListAllocator::alloc(u32 size, u8 alignment) {
     uptr alignedAddress = (uptr)freeBlock + adjustment;
     
     Header* header = (Header*)(alignedAddress - sizeof(Header));
-    header->size = size + adjustment;
+    header->size = total;
     header->adjustment = adjustment;
     
     _used += header->size;
@@ -81,79 +105,51 @@ void* reFreeListAllocator::alloc(u32 size, u8 alignment) {
     return (void*)alignedAddress;
   }
   
-  RE_WARN("Couldn\'t find a free memory block large enough!\n")
-  
   return nullptr;
 }
 
+/**
+ * Returns the block to the free list, which is kept sorted by address so
+ * that the block can be merged with its free neighbours
+ * 
+ * @param ptr A pointer to the address
+ */
+
 void reFreeListAllocator::dealloc(void* ptr) {
   Header* header = (Header*)((uptr)ptr - sizeof(Header));
   
-  u32 size = header->size;
-  
-  uptr blockStart = (uptr)ptr - header->adjustment;
-  uptr blockEnd = blockStart + size;
-  u32 blockSize = size;
+  const u32 size = header->size;
+  FreeBlock* block = (FreeBlock*)((uptr)ptr - header->adjustment);
   
-#ifdef RE_ZERO_MEMORY
-//  memset((void*)blockStart, RE_ZERO_MEM_VAL, blockSize);
-#endif
-  
-  bool blockMerged = false;
-  
-  bool search = true;
+  // find the last free block before the released block
+  FreeBlock* prevFreeBlock = nullptr;
+  FreeBlock* freeBlock = _freeBlocks;
+  while (freeBlock != nullptr && freeBlock < block) {
+    prevFreeBlock = freeBlock;
+    freeBlock = freeBlock->next;
+  }
   
-  while (search) {
-    search = false;
+  if (prevFreeBlock != nullptr && (uptr)prevFreeBlock + prevFreeBlock->size == (uptr)block) {
+    // merge with the preceding block
+    prevFreeBlock->size += size;
+    block = prevFreeBlock;
+  } else {
+    block->size = size;
+    block->next = freeBlock;
     
-    FreeBlock* prevFreeBlock = nullptr;
-    FreeBlock* freeBlock = _freeBlocks;
-    
-    while (freeBlock != nullptr) {
-      if ((uptr)freeBlock + freeBlock->size == blockStart) {
-        freeBlock->size += blockSize;
-        
-        blockStart = (uptr)freeBlock;
-        blockEnd = blockStart + freeBlock->size;
-        blockSize = freeBlock->size;
-        
-        search = true;
-        blockMerged = true;
-        break;
-      } else if (blockEnd == (uptr)freeBlock) {
-        FreeBlock* newFreeBlock = (FreeBlock*) blockStart;
-        newFreeBlock->next = freeBlock->next;
-        newFreeBlock->size = blockSize + freeBlock->size;
-        
-        if (freeBlock == _freeBlocks) {
-          _freeBlocks = newFreeBlock;
-        } else if (prevFreeBlock != newFreeBlock) {
-          prevFreeBlock->next = newFreeBlock;
-        }
-        
-        blockStart = (uptr)newFreeBlock;
-        blockEnd = blockStart + newFreeBlock->size;
-        blockSize = newFreeBlock->size;
-        
-        search = true;
-        blockMerged = true;
-        break;
-      }
-      
-      prevFreeBlock = freeBlock;
-      freeBlock = freeBlock->next;
+    if (prevFreeBlock != nullptr) {
+      prevFreeBlock->next = block;
+    } else {
+      _freeBlocks = block;
     }
   }
   
-  if (!blockMerged) {
-    FreeBlock* block = (FreeBlock*)((uptr)ptr - header->adjustment);
-    block->size = blockSize;
-    block->next = _freeBlocks;
-    
-    _freeBlocks = block;
+  // merge with the following block
+  if (freeBlock != nullptr && (uptr)block + block->size == (uptr)freeBlock) {
+    block->size += freeBlock->size;
+    block->next = freeBlock->next;
   }
   
   _numAllocs--;
   _used -= size;
 }
-
@@ -0,0 +1,110 @@
+#include "react/Memory/reLinearAllocator.h"
+
+#include <cstring>
+
+#include "react/common.h"
+
+const u32 reLinearAllocator::DEFAULT_CAPACITY;
+
+/**
+ * Creates a new allocator with a buffer obtained from the backing allocator
+ *
+ * @param backing The allocator which provides the buffer and overflow pages
+ * @param capacity The initial size of the buffer
+ */
+
+reLinearAllocator::reLinearAllocator(reAllocator& backing, u32 capacity) : reBaseAllocator(),
+_backing(backing), _start(nullptr), _current(nullptr), _end(nullptr),
+_pages(nullptr), _used(0), _numAllocs(0), _size(capacity) {
+  RE_ASSERT(capacity != 0)
+
+  _start = (u8*)_backing.alloc(_size, 16);
+  _current = _start;
+  _end = _start + _size;
+}
+
+reLinearAllocator::~reLinearAllocator() {
+  reset();
+  _backing.dealloc(_start);
+}
+
+void* reLinearAllocator::alloc(u32 size, u8 alignment) {
+  RE_ASSERT(size != 0)
+
+  u8* block = (u8*)nextAlignedAddress(_current, alignment);
+  if (block + size > _end) {
+    return allocOverflow(size, alignment);
+  }
+
+  _current = block + size;
+  _used += size;
+  _numAllocs++;
+
+  return block;
+}
+
+/**
+ * Does nothing, the memory is only released by reset
+ *
+ * @param p A pointer to the address
+ */
+
+void reLinearAllocator::dealloc(void*) {
+  // do nothing
+}
+
+/**
+ * Releases every allocation made since the last reset. If overflow pages
+ * were needed, they are returned to the backing allocator and the buffer is
+ * grown to hold everything allocated since the last reset.
+ */
+
+void reLinearAllocator::reset() {
+  if (_pages != nullptr) {
+    while (_pages != nullptr) {
+      Page* page = _pages;
+      _pages = page->next;
+      _backing.dealloc(page);
+    }
+
+    // leave room for the alignment padding between allocations
+    const u32 peak = _used + _numAllocs * 16;
+    _backing.dealloc(_start);
+    while (_size < peak) {
+      _size *= 2;
+    }
+    _start = (u8*)_backing.alloc(_size, 16);
+  }
+
+#ifdef RE_ZERO_MEMORY
+  memset(_start, RE_ZERO_MEM_VAL, _size);
+#endif
+
+  _current = _start;
+  _end = _start + _size;
+  _used = 0;
+  _numAllocs = 0;
+}
+
+/**
+ * Obtains an overflow page from the backing allocator large enough for the
+ * allocation, and continues carving from that page
+ *
+ * @param size The size of the allocation in bytes
+ * @param alignment The required alignment of the allocation
+ * @return A pointer to the allocated memory
+ */
+
+void* reLinearAllocator::allocOverflow(u32 size, u8 alignment) {
+  const u32 needed = sizeof(Page) + alignment + size;
+  const u32 bytes = needed > _size ? needed : _size;
+  Page* page = (Page*)_backing.alloc(bytes, 16);
+  RE_ASSERT_MSG(page != nullptr, "Couldn't obtain an overflow page!")
+
+  page->next = _pages;
+  _pages = page;
+  _current = (u8*)page + sizeof(Page);
+  _end = (u8*)page + bytes;
+
+  return alloc(size, alignment);
+}
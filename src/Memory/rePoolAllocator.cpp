@@ -0,0 +1,199 @@
+#include "react/Memory/rePoolAllocator.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "react/common.h"
+
+const u32 rePoolAllocator::CHUNK_SIZE;
+const u32 rePoolAllocator::BLOCK_ALIGNMENT;
+const u32 rePoolAllocator::NUM_CLASSES;
+const u32 rePoolAllocator::MAX_CLASS_SIZE;
+const u32 rePoolAllocator::CLASS_SIZES[NUM_CLASSES] = {
+  16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048
+};
+
+namespace {
+  /**
+   * Maps each multiple of the block alignment to the smallest size class
+   * which can hold it
+   */
+
+  struct ClassTable {
+    ClassTable() {
+      u32 sizeClass = 0;
+      for (u32 i = 0; i <= rePoolAllocator::MAX_CLASS_SIZE / rePoolAllocator::BLOCK_ALIGNMENT; i++) {
+        while (rePoolAllocator::CLASS_SIZES[sizeClass] < i * rePoolAllocator::BLOCK_ALIGNMENT) {
+          sizeClass++;
+        }
+        index[i] = sizeClass;
+      }
+    }
+
+    u8 index[rePoolAllocator::MAX_CLASS_SIZE / rePoolAllocator::BLOCK_ALIGNMENT + 1];
+  };
+
+  const ClassTable CLASS_TABLE;
+
+  u32 roundUp(u32 value, u32 alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+  }
+}
+
+/**
+ * Creates an empty allocator, chunks are only obtained from the system once
+ * they are needed
+ */
+
+rePoolAllocator::rePoolAllocator() : reBaseAllocator(), _used(0), _numAllocs(0), _size(0), _chunks(nullptr), _classes() {
+  for (SizeClass& sc : _classes) {
+    sc.freeBlocks = nullptr;
+    sc.next = nullptr;
+    sc.end = nullptr;
+  }
+}
+
+rePoolAllocator::~rePoolAllocator() {
+  while (_chunks != nullptr) {
+    Chunk* chunk = _chunks;
+    _chunks = chunk->next;
+    free(chunk);
+  }
+}
+
+void* rePoolAllocator::alloc(u32 size, u8 alignment) {
+  RE_ASSERT(size != 0)
+
+  if (size > MAX_CLASS_SIZE || alignment > BLOCK_ALIGNMENT) {
+    return allocLarge(size, alignment);
+  }
+
+  const u32 index = CLASS_TABLE.index[(size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT];
+  SizeClass& sc = _classes[index];
+
+  void* block;
+  if (sc.freeBlocks != nullptr) {
+    block = sc.freeBlocks;
+    sc.freeBlocks = sc.freeBlocks->next;
+  } else {
+    if (sc.next == sc.end) {
+      refill(index);
+    }
+    block = sc.next;
+    sc.next += CLASS_SIZES[index];
+  }
+
+  _used += CLASS_SIZES[index];
+  _numAllocs++;
+
+  return block;
+}
+
+void rePoolAllocator::dealloc(void* p) {
+  Chunk* chunk = (Chunk*)((uptr)p & ~(uptr)(CHUNK_SIZE - 1));
+
+  _numAllocs--;
+  if (chunk->sizeClass == NUM_CLASSES) {
+    _used -= chunk->blockSize;
+    _size -= chunk->blockSize;
+
+    // unlink the chunk, large allocations are rare so the walk is acceptable
+    Chunk** link = &_chunks;
+    while (*link != chunk) {
+      link = &(*link)->next;
+    }
+    *link = chunk->next;
+    free(chunk);
+    return;
+  }
+
+  _used -= CLASS_SIZES[chunk->sizeClass];
+
+  SizeClass& sc = _classes[chunk->sizeClass];
+  FreeBlock* block = (FreeBlock*)p;
+  block->next = sc.freeBlocks;
+  sc.freeBlocks = block;
+}
+
+/**
+ * Finds the allocator which made the allocation from the address alone,
+ * without touching any allocator state
+ *
+ * @param p A pointer to memory allocated by any rePoolAllocator
+ * @return The allocator which made the allocation
+ */
+
+rePoolAllocator& rePoolAllocator::ownerOf(const void* p) {
+  return *((Chunk*)((uptr)p & ~(uptr)(CHUNK_SIZE - 1)))->owner;
+}
+
+/**
+ * Gives an allocation which does not fit any size class a chunk of its own
+ *
+ * @param size The size of the allocation in bytes
+ * @param alignment The required alignment of the allocation
+ * @return A pointer to the allocated memory
+ */
+
+void* rePoolAllocator::allocLarge(u32 size, u8 alignment) {
+  const u32 offset = roundUp(sizeof(Chunk), alignment > BLOCK_ALIGNMENT ? alignment : BLOCK_ALIGNMENT);
+  Chunk* chunk = newChunk(offset + size, NUM_CLASSES);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+
+  chunk->blockSize = offset + size;
+  _used += chunk->blockSize;
+  _numAllocs++;
+
+  return (u8*)chunk + offset;
+}
+
+/**
+ * Obtains a new chunk for the size class and makes its blocks available for
+ * carving
+ *
+ * @param sizeClass The index of the size class
+ */
+
+void rePoolAllocator::refill(u32 sizeClass) {
+  Chunk* chunk = newChunk(CHUNK_SIZE, sizeClass);
+  RE_ASSERT_MSG(chunk != nullptr, "Couldn't obtain memory from the system!")
+
+  const u32 blockSize = CLASS_SIZES[sizeClass];
+  const u32 offset = roundUp(sizeof(Chunk), BLOCK_ALIGNMENT);
+  SizeClass& sc = _classes[sizeClass];
+  sc.next = (u8*)chunk + offset;
+  sc.end = sc.next + (CHUNK_SIZE - offset) / blockSize * blockSize;
+}
+
+/**
+ * Obtains a chunk from the system aligned to the chunk size, and links it
+ * into the list of chunks
+ *
+ * @param bytes The number of bytes in the chunk
+ * @param sizeClass The size class of the chunk's blocks
+ * @return The new chunk, or a null pointer if the system is out of memory
+ */
+
+rePoolAllocator::Chunk* rePoolAllocator::newChunk(u32 bytes, u32 sizeClass) {
+  void* memory = nullptr;
+  if (posix_memalign(&memory, CHUNK_SIZE, bytes) != 0) {
+    RE_WARN("Couldn\'t obtain a chunk of memory from the system!\n")
+    return nullptr;
+  }
+
+#ifdef RE_ZERO_MEMORY
+  memset(memory, RE_ZERO_MEM_VAL, bytes);
+#endif
+
+  Chunk* chunk = (Chunk*)memory;
+  chunk->next = _chunks;
+  chunk->owner = this;
+  chunk->sizeClass = sizeClass;
+  chunk->blockSize = 0;
+  _chunks = chunk;
+  _size += bytes;
+
+  return chunk;
+}
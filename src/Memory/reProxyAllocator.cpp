@@ -2,9 +2,36 @@
 
 #include "react/common.h"
 
+const char* re::memoryTagName(re::MemoryTag tag) {
+  switch (tag) {
+    case re::MEMORY_GENERAL:
+      return "general";
+    case re::MEMORY_BROAD_PHASE:
+      return "broad phase";
+    case re::MEMORY_CONTACTS:
+      return "contacts";
+    case re::MEMORY_SHAPES:
+      return "shapes";
+    case re::MEMORY_ENTITIES:
+      return "entities";
+    case re::MEMORY_FRAME:
+      return "frame";
+    default:
+      return "unknown";
+  }
+}
+
 reProxyAllocator::reProxyAllocator(reBaseAllocator* allocator) : reAllocator(),
-_allocator(allocator) {
+_allocator(allocator), _counters() {
   RE_ASSERT(allocator != nullptr)
+  
+  for (Counters& counters : _counters) {
+    counters.used.store(0, std::memory_order_relaxed);
+    counters.peak.store(0, std::memory_order_relaxed);
+    counters.numAllocs.store(0, std::memory_order_relaxed);
+    counters.totalAllocs.store(0, std::memory_order_relaxed);
+    counters.totalFrees.store(0, std::memory_order_relaxed);
+  }
 }
 
 reProxyAllocator::~reProxyAllocator() {
@@ -15,32 +42,90 @@ reProxyAllocator::~reProxyAllocator() {
   RE_ASSERT(_allocator != nullptr)
 }
 
-void* reProxyAllocator::alloc(u32 size, u8 alignment) {
-  void* tmp = _allocator->alloc(size, alignment);
+/**
+ * Allocates memory accounted to the tag. The allocation is preceded by a
+ * header holding its size and tag.
+ * 
+ * @param size The size of the memory to allocate
+ * @param alignment The required alignment
+ * @param tag The subsystem responsible for the allocation
+ * @return A pointer to the allocated address
+ */
+
+void* reProxyAllocator::alloc(u32 size, u8 alignment, re::MemoryTag tag) {
+  const u8 offset = alignment > sizeof(Header) ? alignment : sizeof(Header);
+  u8* block = (u8*)_allocator->alloc(size + offset, offset);
+  if (block == nullptr) {
+    return nullptr;
+  }
+  
+  u8* tmp = block + offset;
+  Header* header = (Header*)(tmp - sizeof(Header));
+  header->size = size;
+  header->tag = tag;
+  header->offset = offset;
+  
+  Counters& counters = _counters[tag];
+  const u32 used = counters.used.fetch_add(size, std::memory_order_relaxed) + size;
+  u32 peak = counters.peak.load(std::memory_order_relaxed);
+  while (used > peak && !counters.peak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+    // retry with the updated peak
+  }
+  counters.numAllocs.fetch_add(1, std::memory_order_relaxed);
+  counters.totalAllocs.fetch_add(1, std::memory_order_relaxed);
 //  RE_DEBUG("alloc  : {#%02d-%5d}", _allocator->numAllocs(), size + alignment)
   return tmp;
 }
 
 void reProxyAllocator::dealloc(void* ptr) {
-#ifdef NDEBUG
-//  unsigned int uu = _allocator->used();
-#endif
-  _allocator->dealloc(ptr);
+  const Header* header = (const Header*)((uptr)ptr - sizeof(Header));
+  
+  Counters& counters = _counters[header->tag];
+  counters.used.fetch_sub(header->size, std::memory_order_relaxed);
+  counters.numAllocs.fetch_sub(1, std::memory_order_relaxed);
+  counters.totalFrees.fetch_add(1, std::memory_order_relaxed);
+  
+  _allocator->dealloc((u8*)ptr - header->offset);
 //  RE_DEBUG("dealloc: {#%02d-%5d}", _allocator->numAllocs(), uu - _allocator->used())
 }
 
-void reProxyAllocator::show() {
-  const int size = _allocator->size();
-  const u8* ptr = (u8*)_allocator->ptr();
-  
-  printf(" |  %02X", ptr[0]);
-  for (int i = 1; i < size; i++) {
-    if (i % 20 == 0) {
-      printf("  |\n |  %02X", ptr[i]);
-    } else {
-      printf(":%02X", ptr[i]);
-    }
+/**
+ * Takes a snapshot of the memory accounted to each tag, along with the
+ * memory used and reserved by the underlying allocator
+ * 
+ * @return The memory statistics
+ */
+
+re::MemoryStats reProxyAllocator::stats() const {
+  re::MemoryStats stats;
+  for (reUInt i = 0; i < re::NUM_MEMORY_TAGS; i++) {
+    const Counters& counters = _counters[i];
+    re::TagStats& tag = stats.tags[i];
+    tag.used = counters.used.load(std::memory_order_relaxed);
+    tag.peak = counters.peak.load(std::memory_order_relaxed);
+    tag.numAllocs = counters.numAllocs.load(std::memory_order_relaxed);
+    tag.totalAllocs = counters.totalAllocs.load(std::memory_order_relaxed);
+    tag.totalFrees = counters.totalFrees.load(std::memory_order_relaxed);
+    stats.requested += tag.used;
   }
-  printf("\n");
+  
+  stats.used = _allocator->used();
+  stats.reserved = _allocator->size();
+  
+  return stats;
 }
 
+/**
+ * Prints the memory accounted to each tag
+ */
+
+void reProxyAllocator::show() {
+  const re::MemoryStats s = stats();
+  
+  printf(" | %-12s %10s %10s %8s\n", "tag", "used", "peak", "allocs");
+  for (reUInt i = 0; i < re::NUM_MEMORY_TAGS; i++) {
+    const re::TagStats& tag = s.tags[i];
+    printf(" | %-12s %10u %10u %8u\n", re::memoryTagName((re::MemoryTag)i), tag.used, tag.peak, tag.numAllocs);
+  }
+  printf(" | requested %u, used %u, reserved %u\n", s.requested, s.used, s.reserved);
+}
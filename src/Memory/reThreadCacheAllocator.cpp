@@ -0,0 +1,280 @@
+#include "react/Memory/reThreadCacheAllocator.h"
+
+#include <vector>
+
+#include "react/common.h"
+
+const u32 reThreadCacheAllocator::MAX_THREADS;
+const u32 reThreadCacheAllocator::BATCH_SIZE;
+
+namespace {
+  std::mutex indexLock;
+  std::vector<u32> freeIndices;
+  u32 nextIndex = 0;
+
+  /**
+   * Gives each live thread a distinct small index. Indices are recycled when
+   * threads exit, so a new thread takes over the caches of an old one.
+   */
+
+  struct ThreadIndex {
+    ThreadIndex() : value(0) {
+      std::lock_guard<std::mutex> lock(indexLock);
+      if (freeIndices.empty()) {
+        value = nextIndex++;
+      } else {
+        value = freeIndices.back();
+        freeIndices.pop_back();
+      }
+    }
+
+    ~ThreadIndex() {
+      std::lock_guard<std::mutex> lock(indexLock);
+      freeIndices.push_back(value);
+    }
+
+    u32 value;
+  };
+
+  thread_local ThreadIndex THREAD_INDEX;
+}
+
+reThreadCacheAllocator::Cache::Cache(u32 i) : rePoolAllocator(), index(i), inbox(nullptr), batches() {
+  for (Batch& batch : batches) {
+    batch.head = nullptr;
+    batch.tail = nullptr;
+    batch.size = 0;
+  }
+}
+
+reThreadCacheAllocator::reThreadCacheAllocator() : reBaseAllocator(), _caches(), _shared(MAX_THREADS), _sharedLock() {
+  for (std::atomic<Cache*>& cache : _caches) {
+    cache.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+reThreadCacheAllocator::~reThreadCacheAllocator() {
+  for (std::atomic<Cache*>& cache : _caches) {
+    delete cache.load(std::memory_order_acquire);
+  }
+}
+
+void* reThreadCacheAllocator::alloc(u32 size, u8 alignment) {
+  if (THREAD_INDEX.value >= MAX_THREADS) {
+    std::lock_guard<std::mutex> lock(_sharedLock);
+    drain(_shared);
+    return _shared.alloc(size, alignment);
+  }
+
+  Cache& cache = local();
+  if (cache.inbox.load(std::memory_order_relaxed) != nullptr) {
+    drain(cache);
+  }
+  return cache.alloc(size, alignment);
+}
+
+void reThreadCacheAllocator::dealloc(void* p) {
+  Cache& owner = static_cast<Cache&>(rePoolAllocator::ownerOf(p));
+
+  if (THREAD_INDEX.value >= MAX_THREADS) {
+    if (&owner == &_shared) {
+      std::lock_guard<std::mutex> lock(_sharedLock);
+      _shared.dealloc(p);
+    } else {
+      hand(owner, (Block*)p, (Block*)p);
+    }
+    return;
+  }
+
+  Cache& cache = local();
+  if (&owner == &cache) {
+    cache.dealloc(p);
+    return;
+  }
+
+  Block* block = (Block*)p;
+  Batch& batch = cache.batches[owner.index];
+  block->next = batch.head;
+  if (batch.head == nullptr) {
+    batch.tail = block;
+  }
+  batch.head = block;
+
+  if (++batch.size == BATCH_SIZE) {
+    hand(owner, batch.head, batch.tail);
+    batch.head = nullptr;
+    batch.tail = nullptr;
+    batch.size = 0;
+  }
+}
+
+/**
+ * Hands every partial batch gathered by the calling thread to its owner, and
+ * collects the blocks handed to the calling thread. Should be called by
+ * threads which stop allocating, so their frees are not held back.
+ */
+
+void reThreadCacheAllocator::flush() {
+  if (THREAD_INDEX.value >= MAX_THREADS) {
+    return;
+  }
+
+  Cache& cache = local();
+  for (u32 i = 0; i <= MAX_THREADS; i++) {
+    Batch& batch = cache.batches[i];
+    if (batch.head != nullptr) {
+      hand(this->cache(i), batch.head, batch.tail);
+      batch.head = nullptr;
+      batch.tail = nullptr;
+      batch.size = 0;
+    }
+  }
+  drain(cache);
+}
+
+/**
+ * Returns every block freed by another thread to the pool it came from. This
+ * touches the caches of all threads, so it must only be called while no
+ * other thread is using the allocator, for example before it is destroyed.
+ */
+
+void reThreadCacheAllocator::collect() {
+  for (u32 i = 0; i <= MAX_THREADS; i++) {
+    Cache* cache = (i == MAX_THREADS) ? &_shared : _caches[i].load(std::memory_order_acquire);
+    if (cache == nullptr) {
+      continue;
+    }
+
+    for (u32 j = 0; j <= MAX_THREADS; j++) {
+      Batch& batch = cache->batches[j];
+      if (batch.head != nullptr) {
+        hand(this->cache(j), batch.head, batch.tail);
+        batch.head = nullptr;
+        batch.tail = nullptr;
+        batch.size = 0;
+      }
+    }
+  }
+
+  for (u32 i = 0; i <= MAX_THREADS; i++) {
+    Cache* cache = (i == MAX_THREADS) ? &_shared : _caches[i].load(std::memory_order_acquire);
+    if (cache != nullptr) {
+      drain(*cache);
+    }
+  }
+}
+
+/**
+ * Sums the bytes in use over all caches. Blocks freed by another thread are
+ * counted until they are collected by their owner.
+ *
+ * @return The number of bytes used
+ */
+
+u32 reThreadCacheAllocator::used() const {
+  u32 total = _shared.used();
+  for (const std::atomic<Cache*>& cache : _caches) {
+    const Cache* c = cache.load(std::memory_order_acquire);
+    if (c != nullptr) {
+      total += c->used();
+    }
+  }
+  return total;
+}
+
+/**
+ * Sums the allocations over all caches. Blocks freed by another thread are
+ * counted until they are collected by their owner.
+ *
+ * @return The number of allocations made
+ */
+
+u32 reThreadCacheAllocator::numAllocs() const {
+  u32 total = _shared.numAllocs();
+  for (const std::atomic<Cache*>& cache : _caches) {
+    const Cache* c = cache.load(std::memory_order_acquire);
+    if (c != nullptr) {
+      total += c->numAllocs();
+    }
+  }
+  return total;
+}
+
+/**
+ * Returns the total number of bytes obtained from the system by all caches
+ *
+ * @return The number of bytes reserved by the allocator
+ */
+
+u32 reThreadCacheAllocator::size() const {
+  u32 total = _shared.size();
+  for (const std::atomic<Cache*>& cache : _caches) {
+    const Cache* c = cache.load(std::memory_order_acquire);
+    if (c != nullptr) {
+      total += c->size();
+    }
+  }
+  return total;
+}
+
+/**
+ * Returns the cache of the calling thread, creating it on first use. Only
+ * the thread with the cache's index ever creates it.
+ *
+ * @return The cache of the calling thread
+ */
+
+reThreadCacheAllocator::Cache& reThreadCacheAllocator::local() {
+  const u32 index = THREAD_INDEX.value;
+  Cache* cache = _caches[index].load(std::memory_order_acquire);
+  if (cache == nullptr) {
+    cache = new Cache(index);
+    _caches[index].store(cache, std::memory_order_release);
+  }
+  return *cache;
+}
+
+/**
+ * Returns the cache with the given index, which must already exist
+ *
+ * @param index The index of the cache, MAX_THREADS for the shared cache
+ * @return The cache
+ */
+
+reThreadCacheAllocator::Cache& reThreadCacheAllocator::cache(u32 index) {
+  if (index == MAX_THREADS) {
+    return _shared;
+  }
+  return *_caches[index].load(std::memory_order_acquire);
+}
+
+/**
+ * Pushes a chain of blocks onto the inbox of the cache which owns them
+ *
+ * @param owner The cache which allocated the blocks
+ * @param head The first block in the chain
+ * @param tail The last block in the chain
+ */
+
+void reThreadCacheAllocator::hand(Cache& owner, Block* head, Block* tail) {
+  Block* top = owner.inbox.load(std::memory_order_relaxed);
+  do {
+    tail->next = top;
+  } while (!owner.inbox.compare_exchange_weak(top, head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/**
+ * Returns every block in the cache's inbox to its pool. Must be called by
+ * the thread which owns the cache, or with the shared cache locked.
+ *
+ * @param cache The cache to drain
+ */
+
+void reThreadCacheAllocator::drain(Cache& cache) {
+  Block* block = cache.inbox.exchange(nullptr, std::memory_order_acquire);
+  while (block != nullptr) {
+    Block* next = block->next;
+    cache.dealloc(block);
+    block = next;
+  }
+}
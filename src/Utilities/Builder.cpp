@@ -8,80 +8,152 @@
 #include "react/Entities/Static.h"
 
 #include "react/Collision/Shapes/shapes.h"
+#include "react/Utilities/ShapeCache.h"
 
 #include "react/Dynamics/reGravAction.h"
 
+namespace {
+  /**
+   * Returns true if the transform only rotates and translates, writing it as
+   * a rigid transform to the output parameter
+   */
+
+  bool isRigid(const re::Transform& transform, re::RigidTransform& rigid) {
+    const re::mat3& m = transform.m;
+    const re::mat3 error = m * re::transpose(m) - re::mat3(1.0);
+    for (reUInt i = 0; i < 3; i++) {
+      for (reUInt j = 0; j < 3; j++) {
+        if (re::abs(error[i][j]) > RE_FP_TOLERANCE) {
+          return false;
+        }
+      }
+    }
+
+    // reflections can not be represented by a rotation
+    const re::vec3 x(m[0][0], m[0][1], m[0][2]);
+    const re::vec3 y(m[1][0], m[1][1], m[1][2]);
+    const re::vec3 z(m[2][0], m[2][1], m[2][2]);
+    if (re::dot(x, re::cross(y, z)) < 0.0) {
+      return false;
+    }
+
+    rigid = re::RigidTransform(re::toQuat(m), transform.v);
+    return true;
+  }
+
+  /**
+   * Creates an entity with the transformed shape. Rigid transforms are kept on
+   * the entity, so the entity shares the untransformed shape, otherwise the
+   * shape cache decides how the transform is applied.
+   */
+
+  template <class T>
+  T* create(reWorld& world, const reShape& shape, const re::Transform& transform) {
+    reAllocator& allocator = world.allocator(re::MEMORY_ENTITIES);
+    re::RigidTransform offset;
+    if (isRigid(transform, offset)) {
+      return allocator.alloc_new<T>(world.shapes().instance(shape), offset);
+    }
+
+    return allocator.alloc_new<T>(world.shapes().instance(shape, transform));
+  }
+}
+
 /**
- * Creates a new Rigid and properly initializes it into the reWorld
+ * Creates a new Rigid and properly initializes it into the reWorld. The shape
+ * is shared with all other entities built from an equal shape.
  * 
  * @return The attached Rigid entity
  */
 
 re::Rigid& re::Builder::Rigid(const reShape& shape) {
-  re::Rigid* body = _world.allocator().alloc_new<re::Rigid>(*copyOf(shape));
+  re::Rigid* body = _world.allocator(re::MEMORY_ENTITIES).alloc_new<re::Rigid>(_world.shapes().instance(shape));
   _world.add(*body);
   return *body;
 }
 
 /**
- * Creates a new Rigid and properly initializes it into the reWorld
+ * Creates a new Rigid and properly initializes it into the reWorld. Rigid
+ * transforms are kept on the entity as its shape offset. Otherwise a shared
+ * re::ShapeProxy is only used if the transform cannot be absorbed into the
+ * shared shape.
  * 
  * @return The attached Rigid entity
  */
 
 re::Rigid& re::Builder::Rigid(const reShape& shape, const re::Transform& transform) {
-  reShape* base = copyOf(shape);
-  reShape* proxy = _world.allocator().alloc_new<re::ShapeProxy>(base, transform);
-  re::Rigid* body = _world.allocator().alloc_new<re::Rigid>(*proxy);
+  re::Rigid* body = create<re::Rigid>(_world, shape, transform);
   _world.add(*body);
   return *body;
 }
 
 re::Static& re::Builder::Static(const reShape& shape) {
-  re::Static* body = _world.allocator().alloc_new<re::Static>(*copyOf(shape));
+  re::Static* body = _world.allocator(re::MEMORY_ENTITIES).alloc_new<re::Static>(_world.shapes().instance(shape));
   _world.add(*body);
   return *body;
 }
 
 re::Static& re::Builder::Static(const reShape& shape, const re::Transform& transform) {
-  reShape* base = copyOf(shape);
-  reShape* proxy = _world.allocator().alloc_new<re::ShapeProxy>(base, transform);
-  re::Static* body = _world.allocator().alloc_new<re::Static>(*proxy);
+  re::Static* body = create<re::Static>(_world, shape, transform);
   _world.add(*body);
   return *body;
 }
 
+/**
+ * Creates many entities at once from their descriptions and attaches them to
+ * the reWorld in a single batch, so that the broad phase is only built once.
+ * Each entity is still allocated on its own from the entity allocator, so it
+ * can be destroyed individually like any other entity. The batch saves the
+ * work of registering each entity and placing it into the broad phase.
+ * 
+ * @param descs The descriptions of the entities
+ * @param n The number of descriptions
+ * @param results An optional buffer of n entities to write the new entities to
+ * @return The number of entities created
+ */
+
+reUInt re::Builder::Entities(const EntityDesc* descs, reUInt n, re::Entity** results) {
+  if (n == 0) {
+    return 0;
+  }
+  
+  re::Entity** entities = results;
+  if (entities == nullptr) {
+    entities = (re::Entity**)_world.allocator().alloc(n * sizeof(re::Entity*), __alignof(re::Entity*));
+  }
+  
+  for (reUInt i = 0; i < n; i++) {
+    const EntityDesc& desc = descs[i];
+    if (desc.isStatic) {
+      entities[i] = create<re::Static>(_world, *desc.shape, desc.transform);
+    } else {
+      entities[i] = create<re::Rigid>(_world, *desc.shape, desc.transform);
+    }
+    entities[i]->setPos(desc.pos);
+  }
+  
+  _world.add(entities, n);
+  
+  if (entities != results) {
+    _world.allocator().dealloc(entities);
+  }
+  
+  return n;
+}
+
 reGravAction& re::Builder::GravAction(Entity& A, Entity& B) {
-  reGravAction* action = _world.allocator().alloc_new<reGravAction>();
+  reGravAction* action = _world.allocator(re::MEMORY_CONTACTS).alloc_new<reGravAction>();
   _world.broadPhase().addInteraction(*action, A, B);
   return *action;
 }
 
+/**
+ * Creates an unshared copy of the shape using the reWorld's allocator
+ * 
+ * @param shape The shape to copy
+ * @return The new copy, or a null pointer if the shape can not be copied
+ */
+
 reShape* re::Builder::copyOf(const reShape& shape) {
-  switch (shape.type()) {
-    case reShape::SPHERE:
-      return _world.allocator().alloc_new<re::Sphere>((const re::Sphere&)shape);
-
-    case reShape::PLANE:
-      return _world.allocator().alloc_new<re::Plane>((const re::Plane&)shape);
-    
-    case reShape::RECTANGLE:
-      RE_NOT_IMPLEMENTED
-      break;
-    
-    case reShape::COMPOUND:
-      RE_NOT_IMPLEMENTED
-      break;
-    
-    case reShape::TRIANGLE:
-      return _world.allocator().alloc_new<reTriangle>((const reTriangle&)shape);
-    
-    case reShape::PROXY:
-      RE_NOT_IMPLEMENTED
-      break;
-  }
-  
-  RE_IMPOSSIBLE
-  throw 0; // TODO proper exceptions
+  return _world.shapes().copyOf(shape);
 }
-
@@ -0,0 +1,349 @@
+#include "react/Utilities/ShapeCache.h"
+
+#include "react/math.h"
+#include "react/Collision/Shapes/shapes.h"
+
+#include <cstdint>
+
+using namespace re;
+
+namespace {
+  reUInt mix(reUInt hash, reFloat value) {
+    // normalize negative zero so that equal values share a bucket
+    if (value == 0.0) {
+      value = 0.0;
+    }
+    reUInt bits[sizeof(reFloat) / sizeof(reUInt)];
+    memcpy(&bits[0], &value, sizeof(reFloat));
+    for (reUInt b : bits) {
+      hash = (hash ^ b) * 16777619u;
+    }
+    return hash;
+  }
+
+  reUInt mix(reUInt hash, const re::vec3& v) {
+    return mix(mix(mix(hash, v[0]), v[1]), v[2]);
+  }
+
+  reUInt hashOf(const reShape& shape) {
+    reUInt hash = mix(2166136261u + shape.type(), shape.shell());
+
+    switch (shape.type()) {
+      case reShape::PLANE:
+        {
+          const re::Plane& plane = (const re::Plane&)shape;
+          return mix(mix(hash, plane.normal()), plane.offset());
+        }
+
+      case reShape::PROXY:
+        {
+          // proxies are only ever built around shared shapes, so the address
+          // of the wrapped shape identifies it
+          const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+          const uintptr_t base = (uintptr_t)proxy.shape();
+          hash = (hash ^ (reUInt)(base ^ (base >> 16))) * 16777619u;
+          for (reUInt i = 0; i < 3; i++) {
+            for (reUInt j = 0; j < 3; j++) {
+              hash = mix(hash, proxy.transform().m[i][j]);
+            }
+          }
+          return mix(hash, proxy.transform().v);
+        }
+
+      default:
+        for (reUInt i = 0; i < shape.numVerts(); i++) {
+          hash = mix(hash, shape.vert(i));
+        }
+        return hash;
+    }
+  }
+
+  /**
+   * Returns true if the two shapes are identical in value. Only shapes which
+   * can be safely shared are ever considered equal
+   */
+
+  bool equals(const reShape& a, const reShape& b) {
+    if (a.type() != b.type() || a.shell() != b.shell()) {
+      return false;
+    }
+
+    switch (a.type()) {
+      case reShape::SPHERE:
+        return true;
+
+      case reShape::PLANE:
+        {
+          const re::Plane& pa = (const re::Plane&)a;
+          const re::Plane& pb = (const re::Plane&)b;
+          return pa.offset() == pb.offset() &&
+                 pa.normal()[0] == pb.normal()[0] &&
+                 pa.normal()[1] == pb.normal()[1] &&
+                 pa.normal()[2] == pb.normal()[2];
+        }
+
+      case reShape::TRIANGLE:
+        for (reUInt i = 0; i < 3; i++) {
+          for (reUInt j = 0; j < 3; j++) {
+            if (a.vert(i)[j] != b.vert(i)[j]) {
+              return false;
+            }
+          }
+        }
+        return true;
+
+      case reShape::PROXY:
+        {
+          const re::ShapeProxy& pa = (const re::ShapeProxy&)a;
+          const re::ShapeProxy& pb = (const re::ShapeProxy&)b;
+          if (pa.shape() != pb.shape()) {
+            return false;
+          }
+
+          for (reUInt i = 0; i < 3; i++) {
+            for (reUInt j = 0; j < 3; j++) {
+              if (pa.transform().m[i][j] != pb.transform().m[i][j]) {
+                return false;
+              }
+            }
+            if (pa.transform().v[i] != pb.transform().v[i]) {
+              return false;
+            }
+          }
+          return true;
+        }
+
+      default:
+        return false;
+    }
+  }
+
+  /**
+   * Returns true if the transform is a rotation combined with a uniform
+   * scaling, writing the scaling factor to the output parameter
+   */
+
+  bool isUniformScaling(const re::mat3& m, reFloat& scale) {
+    const re::vec3 c0(m[0][0], m[1][0], m[2][0]);
+    const re::vec3 c1(m[0][1], m[1][1], m[2][1]);
+    const re::vec3 c2(m[0][2], m[1][2], m[2][2]);
+    const reFloat s2 = re::lengthSq(c0);
+
+    if (re::abs(re::lengthSq(c1) - s2) > RE_FP_TOLERANCE ||
+        re::abs(re::lengthSq(c2) - s2) > RE_FP_TOLERANCE ||
+        re::abs(re::dot(c0, c1)) > RE_FP_TOLERANCE ||
+        re::abs(re::dot(c1, c2)) > RE_FP_TOLERANCE ||
+        re::abs(re::dot(c0, c2)) > RE_FP_TOLERANCE) {
+      return false;
+    }
+
+    scale = re::sqrt(s2);
+    return true;
+  }
+}
+
+/**
+ * Creates an empty shape cache
+ *
+ * @param allocator The allocator used for the shapes and internal structures
+ */
+
+ShapeCache::ShapeCache(reAllocator& allocator) : _allocator(allocator), _buckets{nullptr}, _size(0) {
+  for (reUInt i = 0; i < NUM_BUCKETS; i++) {
+    _buckets[i] = _allocator.alloc_new<reLinkedList<reShape*>>(_allocator);
+  }
+}
+
+ShapeCache::~ShapeCache() {
+  clear();
+
+  for (reUInt i = 0; i < NUM_BUCKETS; i++) {
+    _allocator.alloc_delete(_buckets[i]);
+  }
+}
+
+/**
+ * Returns a shared shape equal in value to the input. A copy is only made if
+ * no such shape exists in the cache. The caller owns one reference to the
+ * returned shape, which should eventually be released.
+ *
+ * @param shape The shape to instance
+ * @return A shared shape equal to the input
+ */
+
+const reShape& ShapeCache::instance(const reShape& shape) {
+  if (shape.type() == reShape::PROXY) {
+    const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+    return instance(*proxy.shape(), proxy.transform());
+  }
+
+  reLinkedList<reShape*>& bucket = bucketFor(shape);
+
+  for (reShape* cached : bucket) {
+    if (equals(*cached, shape)) {
+      cached->retain();
+      return *cached;
+    }
+  }
+
+  reShape* copy = copyOf(shape);
+  RE_ASSERT_MSG(copy != nullptr, "Shape type can not be shared!")
+  // one reference for the cache, another for the caller
+  copy->retain();
+  copy->retain();
+  bucket.add(copy);
+  _size++;
+
+  return *copy;
+}
+
+/**
+ * Returns a shape equivalent to the input transformed by the given transform.
+ * Where the transform can be absorbed into the shape itself, a shared shape
+ * is returned, otherwise a re::ShapeProxy around the shared base shape is
+ * returned. Proxies are shared too, so equal shapes with equal transforms
+ * cost a single proxy. Nested proxies are collapsed into a single proxy, so
+ * that queries never need to walk more than one level. The caller owns one
+ * reference to the returned shape.
+ *
+ * @param shape The shape to instance
+ * @param transform The transform applied to the shape
+ * @return A shape equivalent to the transformed input
+ */
+
+const reShape& ShapeCache::instance(const reShape& shape, const re::Transform& transform) {
+  if (shape.type() == reShape::PROXY) {
+    const re::ShapeProxy& proxy = (const re::ShapeProxy&)shape;
+    return instance(*proxy.shape(), transform * proxy.transform());
+  }
+
+  if (re::similar(transform, re::Transform())) {
+    return instance(shape);
+  }
+
+  reFloat scale = 1.0;
+  if (shape.type() == reShape::SPHERE &&
+      re::similar(transform.v, re::vec3(0.0, 0.0, 0.0)) &&
+      isUniformScaling(transform.m, scale)) {
+    return instance(re::Sphere(((const re::Sphere&)shape).radius() * scale));
+  }
+
+  // the reference to the base shape is handed to a new proxy, or returned
+  const reShape& base = instance(shape);
+  const re::ShapeProxy key(&base, transform);
+  reLinkedList<reShape*>& bucket = bucketFor(key);
+
+  for (reShape* cached : bucket) {
+    if (equals(*cached, key)) {
+      release(base);
+      cached->retain();
+      return *cached;
+    }
+  }
+
+  reShape* proxy = _allocator.alloc_new<re::ShapeProxy>(&base, transform);
+  // one reference for the cache, another for the caller
+  proxy->retain();
+  proxy->retain();
+  bucket.add(proxy);
+  _size++;
+
+  return *proxy;
+}
+
+/**
+ * Creates an unshared copy of the shape using the cache's allocator
+ *
+ * @param shape The shape to copy
+ * @return A pointer to the new copy, or a null pointer if shapes of that type
+ * can not be copied
+ */
+
+reShape* ShapeCache::copyOf(const reShape& shape) {
+  switch (shape.type()) {
+    case reShape::SPHERE:
+      return _allocator.alloc_new<re::Sphere>((const re::Sphere&)shape);
+
+    case reShape::PLANE:
+      return _allocator.alloc_new<re::Plane>((const re::Plane&)shape);
+
+    case reShape::TRIANGLE:
+      return _allocator.alloc_new<reTriangle>((const reTriangle&)shape);
+
+    case reShape::RECTANGLE:
+    case reShape::COMPOUND:
+    case reShape::PROXY:
+      RE_NOT_IMPLEMENTED
+      return nullptr;
+  }
+
+  RE_IMPOSSIBLE
+  return nullptr;
+}
+
+/**
+ * Destroys all cached shapes which are no longer referenced outside the
+ * cache. Destroying a proxy may leave the shape it wrapped unreferenced, so
+ * the buckets are swept until nothing more is destroyed.
+ */
+
+void ShapeCache::purge() {
+  bool purged = true;
+  while (purged) {
+    purged = false;
+    for (reLinkedList<reShape*>* bucket : _buckets) {
+      auto end = bucket->end();
+      for (auto it = bucket->begin(); it != end;) {
+        reShape* shape = *it;
+        ++it;
+        if (shape->references() == 1) {
+          bucket->remove(shape);
+          release(*shape);
+          _size--;
+          purged = true;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Releases the references held by the cache. Shapes still in use by entities
+ * remain valid until their owners release them.
+ */
+
+void ShapeCache::clear() {
+  for (reLinkedList<reShape*>* bucket : _buckets) {
+    for (reShape* shape : *bucket) {
+      release(*shape);
+    }
+    bucket->clear();
+  }
+  _size = 0;
+}
+
+/**
+ * Releases a reference to the shape, destroying it along with any wrapped
+ * shapes once no other owners remain. Shapes which were never retained are
+ * assumed to have a single owner.
+ *
+ * @param allocator The allocator which created the shape
+ * @param shape The shape to release
+ */
+
+void ShapeCache::release(reAllocator& allocator, const reShape& shape) {
+  if (shape.release() == 0) {
+    if (shape.type() == reShape::PROXY) {
+      const reShape* base = ((const re::ShapeProxy&)shape).shape();
+      if (base != nullptr) {
+        release(allocator, *base);
+      }
+    }
+    // shared shapes are only exposed as const, but the last owner may free them
+    allocator.alloc_delete(const_cast<reShape*>(&shape));
+  }
+}
+
+reLinkedList<reShape*>& ShapeCache::bucketFor(const reShape& shape) {
+  return *_buckets[hashOf(shape) % NUM_BUCKETS];
+}
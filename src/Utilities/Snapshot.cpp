@@ -0,0 +1,676 @@
+#include "react/Utilities/Snapshot.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "react/reWorld.h"
+#include "react/Collision/reBroadPhase.h"
+#include "react/Collision/Shapes/shapes.h"
+#include "react/Entities/Rigid.h"
+#include "react/Entities/Static.h"
+#include "react/Dynamics/reGravAction.h"
+#include "react/Utilities/ShapeCache.h"
+
+using namespace re;
+
+namespace {
+  const char MAGIC[4] = { 'R', 'E', 'S', 'N' };
+  const reUInt NO_SHAPE = 0xFFFFFFFF;
+
+  /**
+   * Computes the size of a snapshot from the number of records it holds
+   */
+
+  uint64_t snapshotSize(uint64_t numShapes, uint64_t numEntities, uint64_t numInteractions, uint64_t numSplits) {
+    return sizeof(SnapshotHeader) +
+      numShapes * sizeof(ShapeRecord) +
+      numEntities * sizeof(EntityRecord) +
+      numInteractions * sizeof(InteractionRecord) +
+      numSplits * sizeof(reBPSplit);
+  }
+
+  /**
+   * Maps the addresses of shapes and entities to their indices in the
+   * snapshot. The table is open addressed and sized up front, so it is built
+   * from two allocations taken from the reWorld's allocator.
+   */
+
+  class IndexTable {
+  public:
+    IndexTable(reAllocator& allocator, reUInt n) : _allocator(allocator), _capacity(8), _keys(nullptr), _indices(nullptr) {
+      // keep the table under half full
+      while (_capacity < 2 * n) {
+        _capacity *= 2;
+      }
+      _keys = (const void**)_allocator.alloc(_capacity * sizeof(const void*), __alignof(const void*));
+      _indices = (reUInt*)_allocator.alloc(_capacity * sizeof(reUInt), __alignof(reUInt));
+      memset(_keys, 0, _capacity * sizeof(const void*));
+    }
+
+    IndexTable(const IndexTable&) = delete;
+
+    ~IndexTable() {
+      _allocator.dealloc(_indices);
+      _allocator.dealloc(_keys);
+    }
+
+    IndexTable& operator=(const IndexTable&) = delete;
+
+    /** Returns the index of the key, or NO_INDEX if the key is not in the table */
+    reUInt find(const void* key) const {
+      const reUInt slot = slotFor(key);
+      return _keys[slot] == key ? _indices[slot] : NO_INDEX;
+    }
+
+    void insert(const void* key, reUInt index) {
+      const reUInt slot = slotFor(key);
+      _keys[slot] = key;
+      _indices[slot] = index;
+    }
+
+    static const reUInt NO_INDEX = 0xFFFFFFFF;
+
+  private:
+    reUInt slotFor(const void* key) const {
+      const uintptr_t bits = (uintptr_t)key;
+      reUInt slot = (reUInt)((bits >> 4) ^ (bits >> 24)) * 2654435761u & (_capacity - 1);
+      while (_keys[slot] != nullptr && _keys[slot] != key) {
+        slot = (slot + 1) & (_capacity - 1);
+      }
+      return slot;
+    }
+
+    reAllocator& _allocator;
+    reUInt _capacity;
+    const void** _keys;
+    reUInt* _indices;
+  };
+
+  /**
+   * Returns true if the shape, and every shape it wraps, has a record format
+   */
+
+  bool canWrite(const reShape& shape) {
+    switch (shape.type()) {
+      case reShape::SPHERE:
+      case reShape::PLANE:
+      case reShape::TRIANGLE:
+        return true;
+
+      case reShape::PROXY: {
+        const reShape* base = ((const ShapeProxy&)shape).shape();
+        return base != nullptr && canWrite(*base);
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  /**
+   * Returns the number of shapes which need a record for the shape, counting
+   * the shapes wrapped by proxies
+   */
+
+  reUInt countShapes(const reShape& shape) {
+    if (shape.type() == reShape::PROXY) {
+      return 1 + countShapes(*((const ShapeProxy&)shape).shape());
+    }
+    return 1;
+  }
+
+  /**
+   * Gives the shape an index, after giving one to the shape it wraps, so
+   * that wrapped shapes are always restored first
+   */
+
+  reUInt indexShape(const reShape& shape, IndexTable& indices, reDenseArray<const reShape*>& shapes) {
+    const reUInt found = indices.find(&shape);
+    if (found != IndexTable::NO_INDEX) {
+      return found;
+    }
+
+    if (shape.type() == reShape::PROXY) {
+      indexShape(*((const ShapeProxy&)shape).shape(), indices, shapes);
+    }
+
+    const reUInt index = shapes.add(&shape);
+    indices.insert(&shape, index);
+    return index;
+  }
+
+  void writeShape(const reShape& shape, const IndexTable& indices, ShapeRecord& record) {
+    memset(&record, 0, sizeof(ShapeRecord));
+    record.type = shape.type();
+    record.base = NO_SHAPE;
+
+    switch (shape.type()) {
+      case reShape::SPHERE:
+        record.data[0] = ((const Sphere&)shape).radius();
+        break;
+
+      case reShape::PLANE:
+        for (reUInt i = 0; i < 3; i++) {
+          record.data[i] = ((const Plane&)shape).normal()[i];
+        }
+        record.data[3] = ((const Plane&)shape).offset();
+        break;
+
+      case reShape::TRIANGLE:
+        for (reUInt i = 0; i < 3; i++) {
+          const vec3 vert = shape.vert(i);
+          for (reUInt j = 0; j < 3; j++) {
+            record.data[3 * i + j] = vert[j];
+          }
+        }
+        break;
+
+      case reShape::PROXY: {
+        const ShapeProxy& proxy = (const ShapeProxy&)shape;
+        record.base = indices.find(proxy.shape());
+        for (reUInt i = 0; i < 3; i++) {
+          for (reUInt j = 0; j < 3; j++) {
+            record.data[3 * i + j] = proxy.transform().m[i][j];
+          }
+          record.data[9 + i] = proxy.transform().v[i];
+        }
+        break;
+      }
+
+      default:
+        // writeSnapshot checks every shape with canWrite first
+        RE_IMPOSSIBLE
+    }
+  }
+
+  /**
+   * Obtains a shared shape equal to the record from the reWorld's shape
+   * cache. The caller owns one reference to the shape.
+   */
+
+  const reShape& readShape(ShapeCache& cache, const ShapeRecord& record, const reShape* const* shapes) {
+    switch (record.type) {
+      case reShape::SPHERE:
+        return cache.instance(Sphere(record.data[0]));
+
+      case reShape::PLANE:
+        return cache.instance(Plane(vec3(record.data[0], record.data[1], record.data[2]), record.data[3]));
+
+      case reShape::TRIANGLE:
+        return cache.instance(reTriangle(
+          vec3(record.data[0], record.data[1], record.data[2]),
+          vec3(record.data[3], record.data[4], record.data[5]),
+          vec3(record.data[6], record.data[7], record.data[8])
+        ));
+
+      default: {
+        Transform transform;
+        for (reUInt i = 0; i < 3; i++) {
+          for (reUInt j = 0; j < 3; j++) {
+            transform.m[i][j] = record.data[3 * i + j];
+          }
+          transform.v[i] = record.data[9 + i];
+        }
+        return cache.instance(*shapes[record.base], transform);
+      }
+    }
+  }
+
+  void writeEntity(const Entity& entity, reUInt shape, EntityRecord& record) {
+    memset(&record, 0, sizeof(EntityRecord));
+    record.type = entity.type();
+    record.shape = shape;
+    record.continuous = entity.isContinuous() ? 1 : 0;
+    for (reUInt i = 0; i < 3; i++) {
+      record.pos[i] = entity.pos()[i];
+      record.vel[i] = entity.vel()[i];
+      record.angVel[i] = entity.angVel()[i];
+      record.offsetPos[i] = entity.shapeOffset().v[i];
+    }
+    for (reUInt i = 0; i < 4; i++) {
+      record.orient[i] = entity.orient().v[i];
+      record.offsetOrient[i] = entity.shapeOffset().q.v[i];
+    }
+    record.massInv = entity.massInv();
+    record.restitution = entity.restitution();
+    record.friction = entity.friction();
+    record.resistance = entity.resistance();
+  }
+
+  /**
+   * Returns true if none of the numbers are infinite or NaN
+   */
+
+  bool isFinite(const reFloat* values, reUInt n) {
+    for (reUInt i = 0; i < n; i++) {
+      if (!std::isfinite(values[i])) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Returns true if the vector is long enough to be normalized. Normals and
+   * orientations are saved with unit length, so anything much shorter is
+   * damaged.
+   */
+
+  bool hasDirection(const vec3& v) {
+    return lengthSq(v) >= RE_FP_TOLERANCE;
+  }
+
+  /**
+   * Returns true if the quaternion is long enough to be a rotation
+   */
+
+  bool hasRotation(const reFloat* q) {
+    return q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3] >= RE_FP_TOLERANCE;
+  }
+
+  bool validateShape(const ShapeRecord& record, reUInt index) {
+    switch (record.type) {
+      case reShape::SPHERE:
+        return isFinite(record.data, 1) && record.data[0] > 0.0;
+
+      case reShape::PLANE:
+        return isFinite(record.data, 4) &&
+          hasDirection(vec3(record.data[0], record.data[1], record.data[2]));
+
+      case reShape::TRIANGLE: {
+        if (!isFinite(record.data, 9)) {
+          return false;
+        }
+
+        const vec3 a(record.data[0], record.data[1], record.data[2]);
+        const vec3 b(record.data[3], record.data[4], record.data[5]);
+        const vec3 c(record.data[6], record.data[7], record.data[8]);
+        return lengthSq(cross(a - b, c - b)) > 0.0;
+      }
+
+      case reShape::PROXY: {
+        if (record.base >= index || !isFinite(record.data, 12)) {
+          return false;
+        }
+
+        // the proxy must be able to invert its transform
+        const vec3 x(record.data[0], record.data[1], record.data[2]);
+        const vec3 y(record.data[3], record.data[4], record.data[5]);
+        const vec3 z(record.data[6], record.data[7], record.data[8]);
+        return dot(x, cross(y, z)) != 0.0;
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  bool validateEntity(const EntityRecord& record, reUInt numShapes) {
+    if ((record.type != Entity::RIGID && record.type != Entity::STATIC) ||
+        record.shape >= numShapes) {
+      return false;
+    }
+
+    if (!isFinite(record.pos, 3) || !isFinite(record.orient, 4) ||
+        !isFinite(record.vel, 3) || !isFinite(record.angVel, 3) ||
+        !isFinite(&record.massInv, 1) || !isFinite(&record.restitution, 1) ||
+        !isFinite(&record.friction, 1) || !isFinite(&record.resistance, 1) ||
+        !isFinite(record.offsetPos, 3) || !isFinite(record.offsetOrient, 4)) {
+      return false;
+    }
+
+    if (!hasRotation(record.orient) || !hasRotation(record.offsetOrient)) {
+      return false;
+    }
+
+    // the mass of a rigid entity is restored from its inverse
+    return record.type == Entity::STATIC || record.massInv > 0.0;
+  }
+
+  /**
+   * Walks the broad phase records without recursing, checking that they
+   * form exactly one complete tree no deeper than reBPSplit::MAX_DEPTH
+   */
+
+  bool validateLayout(const reBPSplit* splits, reUInt n) {
+    if (n == 0) {
+      return true;
+    }
+
+    // the depths of the nodes still to be read. Every level holds at most the
+    // second child of a node above it, so the stack never overflows
+    reUInt pending[reBPSplit::MAX_DEPTH + 1];
+    reUInt size = 0;
+    pending[size++] = 0;
+
+    for (reUInt i = 0; i < n; i++) {
+      if (size == 0) {
+        return false;
+      }
+
+      const reBPSplit& split = splits[i];
+      const reUInt depth = pending[--size];
+      if (!isFinite(split.normal, 3) || !isFinite(&split.offset, 1) ||
+          !hasDirection(vec3(split.normal[0], split.normal[1], split.normal[2]))) {
+        return false;
+      }
+
+      if (split.children != 0) {
+        if (depth >= reBPSplit::MAX_DEPTH) {
+          return false;
+        }
+
+        pending[size++] = depth + 1;
+        pending[size++] = depth + 1;
+      }
+    }
+
+    return size == 0;
+  }
+
+  /**
+   * Checks every record in the snapshot, so that a damaged snapshot is
+   * rejected before the reWorld is modified. Indices must refer to earlier
+   * records, numbers must be finite and directions must not be zero.
+   */
+
+  bool validate(const SnapshotHeader& header, const ShapeRecord* shapes, const EntityRecord* entities, const InteractionRecord* interactions, const reBPSplit* splits) {
+    for (reUInt i = 0; i < header.numShapes; i++) {
+      if (!validateShape(shapes[i], i)) {
+        return false;
+      }
+    }
+
+    for (reUInt i = 0; i < header.numEntities; i++) {
+      if (!validateEntity(entities[i], header.numShapes)) {
+        return false;
+      }
+    }
+
+    for (reUInt i = 0; i < header.numInteractions; i++) {
+      if (interactions[i].type != reInteraction::GRAVITY ||
+          interactions[i].A >= header.numEntities ||
+          interactions[i].B >= header.numEntities) {
+        return false;
+      }
+    }
+
+    return validateLayout(splits, header.numSplits);
+  }
+}
+
+/**
+ * Writes the entities, shapes, material properties, built in interactions
+ * and broad phase layout of the reWorld to the buffer. Interactions defined
+ * by the user cannot be restored, so they are left out. Nothing is written
+ * if the buffer is too small, so the size needed can be found by passing an
+ * empty buffer.
+ *
+ * @param world The reWorld to save
+ * @param buffer The buffer to write to, aligned to the size of a float
+ * @param capacity The size of the buffer in bytes
+ * @return The size of the snapshot in bytes, or 0 if an entity has a shape
+ * which snapshots can not describe
+ */
+
+reUInt re::writeSnapshot(const reWorld& world, void* buffer, reUInt capacity) {
+  const reDenseArray<Entity*>& entities = world.entities();
+  reUInt maxShapes = 0;
+  for (const Entity* entity : entities) {
+    if (!canWrite(entity->shape())) {
+      return 0;
+    }
+    maxShapes += countShapes(entity->shape());
+  }
+
+  reAllocator& allocator = world.allocator();
+  IndexTable shapeIndices(allocator, maxShapes);
+  reDenseArray<const reShape*> shapes(allocator);
+  shapes.reserve(maxShapes);
+  IndexTable entityIndices(allocator, entities.size());
+  for (reUInt i = 0; i < entities.size(); i++) {
+    indexShape(entities[i]->shape(), shapeIndices, shapes);
+    entityIndices.insert(entities[i], i);
+  }
+
+  reDenseArray<InteractionRecord> interactions(allocator);
+  for (const ContactEdge* edge : world.broadPhase().contacts().edges()) {
+    for (const reInteraction* action : edge->interactions) {
+      if (action->type() == reInteraction::CUSTOM) {
+        continue;
+      }
+
+      const reUInt A = entityIndices.find(&edge->A);
+      const reUInt B = entityIndices.find(&edge->B);
+      if (A == IndexTable::NO_INDEX || B == IndexTable::NO_INDEX) {
+        continue;
+      }
+
+      InteractionRecord record;
+      record.type = action->type();
+      record.A = A;
+      record.B = B;
+      record.padding = 0;
+      interactions.add(record);
+    }
+  }
+
+  const reUInt numSplits = world.broadPhase().layout(nullptr, 0);
+  const uint64_t size = snapshotSize(shapes.size(), entities.size(), interactions.size(), numSplits);
+  RE_ASSERT_MSG(size <= 0xFFFFFFFF, "World is too large for a snapshot!")
+  if (size > capacity) {
+    return size;
+  }
+
+  SnapshotHeader& header = *(SnapshotHeader*)buffer;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = SNAPSHOT_VERSION;
+  header.floatSize = sizeof(reFloat);
+  header.size = size;
+  header.numShapes = shapes.size();
+  header.numEntities = entities.size();
+  header.numInteractions = interactions.size();
+  header.numSplits = numSplits;
+
+  ShapeRecord* shapeRecords = (ShapeRecord*)(&header + 1);
+  for (reUInt i = 0; i < shapes.size(); i++) {
+    writeShape(*shapes[i], shapeIndices, shapeRecords[i]);
+  }
+
+  EntityRecord* entityRecords = (EntityRecord*)(shapeRecords + shapes.size());
+  for (reUInt i = 0; i < entities.size(); i++) {
+    writeEntity(*entities[i], shapeIndices.find(&entities[i]->shape()), entityRecords[i]);
+  }
+
+  InteractionRecord* interactionRecords = (InteractionRecord*)(entityRecords + entities.size());
+  for (reUInt i = 0; i < interactions.size(); i++) {
+    interactionRecords[i] = interactions[i];
+  }
+
+  reBPSplit* splits = (reBPSplit*)(interactionRecords + interactions.size());
+  world.broadPhase().layout(splits, numSplits);
+
+  return size;
+}
+
+/**
+ * Replaces the contents of the reWorld with the snapshot. The records are
+ * read in place, so a snapshot mapped from a file is never copied. The
+ * snapshot is checked before the reWorld is cleared, so a snapshot which is
+ * rejected leaves the reWorld unchanged.
+ *
+ * Accepting a snapshot destroys the existing entities, invalidating their
+ * handles, and creates new entities in the order they were saved. Contacts
+ * and their accumulated impulses are not part of the snapshot, so a restored
+ * simulation only replays exactly from a state without resting contacts.
+ *
+ * @param world The reWorld to restore into
+ * @param data The snapshot, aligned to the size of a float
+ * @param size The size of the snapshot in bytes
+ * @return False if the snapshot is damaged or was written by an incompatible
+ * build
+ */
+
+bool re::readSnapshot(reWorld& world, const void* data, reUInt size) {
+  if (size < sizeof(SnapshotHeader)) {
+    return false;
+  }
+
+  const SnapshotHeader& header = *(const SnapshotHeader*)data;
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.version != SNAPSHOT_VERSION ||
+      header.floatSize != sizeof(reFloat) ||
+      header.size != size ||
+      snapshotSize(header.numShapes, header.numEntities, header.numInteractions, header.numSplits) != size) {
+    return false;
+  }
+
+  const ShapeRecord* shapeRecords = (const ShapeRecord*)(&header + 1);
+  const EntityRecord* entityRecords = (const EntityRecord*)(shapeRecords + header.numShapes);
+  const InteractionRecord* interactionRecords = (const InteractionRecord*)(entityRecords + header.numEntities);
+  const reBPSplit* splits = (const reBPSplit*)(interactionRecords + header.numInteractions);
+
+  if (!validate(header, shapeRecords, entityRecords, interactionRecords, splits)) {
+    return false;
+  }
+
+  world.clear();
+
+  if (header.numSplits > 0 && !world.broadPhase().setLayout(splits, header.numSplits)) {
+    RE_WARN("Snapshot has an incomplete broad phase layout, the layout will be rebuilt\n")
+  }
+
+  if (header.numEntities == 0) {
+    return true;
+  }
+
+  // the shape and entity tables share a single temporary allocation
+  const reUInt tableSize = header.numShapes * sizeof(const reShape*) + header.numEntities * sizeof(Entity*);
+  void* table = world.allocator().alloc(tableSize, __alignof(void*));
+  const reShape** shapes = (const reShape**)table;
+  Entity** entities = (Entity**)(shapes + header.numShapes);
+
+  for (reUInt i = 0; i < header.numShapes; i++) {
+    shapes[i] = &readShape(world.shapes(), shapeRecords[i], shapes);
+  }
+
+  reAllocator& allocator = world.allocator(MEMORY_ENTITIES);
+  for (reUInt i = 0; i < header.numEntities; i++) {
+    const EntityRecord& record = entityRecords[i];
+    const reShape& shape = *shapes[record.shape];
+    // each entity owns a reference to its shape
+    shape.retain();
+
+    const RigidTransform offset(
+      quat(record.offsetOrient[0], record.offsetOrient[1], record.offsetOrient[2], record.offsetOrient[3]),
+      vec3(record.offsetPos[0], record.offsetPos[1], record.offsetPos[2])
+    );
+
+    Entity* entity;
+    if (record.type == Entity::STATIC) {
+      entity = allocator.alloc_new<Static>(shape, offset);
+    } else {
+      entity = allocator.alloc_new<Rigid>(shape, offset);
+      entity->setMass(1.0 / record.massInv);
+    }
+
+    entity->setPos(record.pos[0], record.pos[1], record.pos[2]);
+    entity->setOrient(quat(record.orient[0], record.orient[1], record.orient[2], record.orient[3]));
+    entity->setVel(record.vel[0], record.vel[1], record.vel[2]);
+    entity->setAngVel(record.angVel[0], record.angVel[1], record.angVel[2]);
+    entity->setRestitution(record.restitution);
+    entity->setFriction(record.friction);
+    entity->setResistance(record.resistance);
+    entity->setContinuous(record.continuous != 0);
+    entities[i] = entity;
+  }
+
+  world.add(entities, header.numEntities);
+
+  for (reUInt i = 0; i < header.numInteractions; i++) {
+    const InteractionRecord& record = interactionRecords[i];
+    reGravAction* action = world.allocator(MEMORY_CONTACTS).alloc_new<reGravAction>();
+    world.broadPhase().addInteraction(*action, *entities[record.A], *entities[record.B]);
+  }
+
+  // the entities now hold their own references to the shapes
+  for (reUInt i = 0; i < header.numShapes; i++) {
+    world.shapes().release(*shapes[i]);
+  }
+  world.allocator().dealloc(table);
+
+  return true;
+}
+
+/**
+ * Writes a snapshot of the reWorld to a file
+ *
+ * @param world The reWorld to save
+ * @param path The path of the file to write
+ * @return False if the file could not be written, or an entity has a shape
+ * which snapshots can not describe
+ */
+
+bool re::saveSnapshot(const reWorld& world, const char* path) {
+  const reUInt size = writeSnapshot(world, nullptr, 0);
+  if (size == 0) {
+    return false;
+  }
+
+  void* buffer = world.allocator().alloc(size, __alignof(reFloat));
+  writeSnapshot(world, buffer, size);
+
+  bool written = false;
+  FILE* file = fopen(path, "wb");
+  if (file != nullptr) {
+    written = (fwrite(buffer, 1, size, file) == size);
+    written = (fclose(file) == 0) && written;
+  }
+
+  world.allocator().dealloc(buffer);
+  return written;
+}
+
+/**
+ * Replaces the contents of the reWorld with a snapshot file. The file is
+ * mapped into memory and read in place, so opening a snapshot costs little
+ * more than creating its entities.
+ *
+ * @param world The reWorld to restore into
+ * @param path The path of the file to read
+ * @return False if the file could not be read or its snapshot was rejected
+ */
+
+bool re::loadSnapshot(reWorld& world, const char* path) {
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SnapshotHeader) || (uint64_t)info.st_size > 0xFFFFFFFF) {
+    close(fd);
+    return false;
+  }
+
+  void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  // the records are read once from start to end
+  madvise(data, info.st_size, MADV_SEQUENTIAL);
+  const bool loaded = readSnapshot(world, data, info.st_size);
+  munmap(data, info.st_size);
+
+  return loaded;
+}
@@ -0,0 +1,89 @@
+#include "react/Utilities/ThreadPool.h"
+
+using namespace re;
+
+/**
+ * Creates a pool and starts its worker threads
+ *
+ * @param size The number of threads taking part in each task, including the
+ * calling thread
+ */
+
+ThreadPool::ThreadPool(reUInt size) : _threads(), _lock(), _wake(), _done(), _task(nullptr), _count(0), _next(0), _busy(0), _generation(0), _stopping(false) {
+  for (reUInt i = 1; i < size; i++) {
+    _threads.push_back(std::thread(&ThreadPool::work, this));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    _stopping = true;
+  }
+  _wake.notify_all();
+
+  for (std::thread& thread : _threads) {
+    thread.join();
+  }
+}
+
+/**
+ * Calls the task once for every item index from 0 to count - 1, spread over
+ * all threads in the pool. The items are claimed one at a time, so the order
+ * in which they run is unspecified. Returns once every item has completed.
+ *
+ * @param count The number of items
+ * @param task The function called with the index of each item
+ */
+
+void ThreadPool::run(reUInt count, const std::function<void(reUInt)>& task) {
+  if (_threads.empty() || count <= 1) {
+    for (reUInt i = 0; i < count; i++) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    _task = &task;
+    _count = count;
+    _next = 0;
+    _busy = _threads.size();
+    _generation++;
+  }
+  _wake.notify_all();
+
+  drain();
+
+  std::unique_lock<std::mutex> lock(_lock);
+  _done.wait(lock, [this]() { return _busy == 0; });
+  _task = nullptr;
+}
+
+void ThreadPool::work() {
+  reUInt seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(_lock);
+      _wake.wait(lock, [this, seen]() { return _stopping || _generation != seen; });
+      if (_stopping) {
+        return;
+      }
+      seen = _generation;
+    }
+
+    drain();
+
+    std::lock_guard<std::mutex> lock(_lock);
+    if (--_busy == 0) {
+      _done.notify_one();
+    }
+  }
+}
+
+void ThreadPool::drain() {
+  for (reUInt i = _next++; i < _count; i = _next++) {
+    (*_task)(i);
+  }
+}
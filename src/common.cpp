@@ -2,8 +2,117 @@
 
 #include "react/Collision/reSpatialQueries.h"
 
-reUInt re::queriesMade = 0;
-reUInt re::globalQueryID = 0;
+#include <atomic>
+#include <mutex>
+
+namespace {
+  /**
+   * Holds the number of queries made by a single thread. Each counter is
+   * linked into a global list when its thread first makes a query, so that
+   * threads never write to a shared counter and the totals are only
+   * aggregated when requested.
+   */
+
+  struct QueryCounter {
+    QueryCounter();
+    ~QueryCounter();
+
+    /** The number of queries made by the owning thread */
+    std::atomic<reUInt> count;
+    /** The previous counter in the global list */
+    QueryCounter* prev;
+    /** The next counter in the global list */
+    QueryCounter* next;
+  };
+
+  /** Guards the list of counters and the retired count */
+  std::mutex countersLock;
+  /** The counters of all threads which have made queries */
+  QueryCounter* counters = nullptr;
+  /** The queries made by threads which have since exited */
+  reUInt retiredQueries = 0;
+
+  thread_local QueryCounter localCounter;
+
+  std::atomic<reUInt> globalQueryID(0);
+
+  QueryCounter::QueryCounter() : count(0), prev(nullptr), next(nullptr) {
+    std::lock_guard<std::mutex> lock(countersLock);
+    next = counters;
+    if (counters != nullptr) {
+      counters->prev = this;
+    }
+    counters = this;
+  }
+
+  QueryCounter::~QueryCounter() {
+    std::lock_guard<std::mutex> lock(countersLock);
+    retiredQueries += count.load(std::memory_order_relaxed);
+    if (prev != nullptr) {
+      prev->next = next;
+    } else {
+      counters = next;
+    }
+    if (next != nullptr) {
+      next->prev = prev;
+    }
+  }
+}
 
 FILE* re::logFile = stderr;
 
+/**
+ * Returns the total number of entity tests made by spatial queries, summed
+ * over all threads
+ * 
+ * @return The number of queries made since the last reset
+ */
+
+reUInt re::queriesMade() {
+  std::lock_guard<std::mutex> lock(countersLock);
+  reUInt total = retiredQueries;
+  for (QueryCounter* counter = counters; counter != nullptr; counter = counter->next) {
+    total += counter->count.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+/**
+ * Resets the query counters of all threads. This should not be called while
+ * queries are in progress on other threads.
+ */
+
+void re::resetQueriesMade() {
+  std::lock_guard<std::mutex> lock(countersLock);
+  retiredQueries = 0;
+  for (QueryCounter* counter = counters; counter != nullptr; counter = counter->next) {
+    counter->count.store(0, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * Adds to the query count of the calling thread
+ * 
+ * @param n The number of queries made
+ */
+
+void re::countQueries(reUInt n) {
+  // only the owning thread writes to its counter, so no atomic increment is
+  // needed for the count to be exact
+  std::atomic<reUInt>& count = localCounter.count;
+  count.store(count.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/**
+ * Returns a new query ID, which is unique across all threads and never zero
+ * 
+ * @return The new query ID
+ */
+
+reUInt re::nextQueryID() {
+  reUInt id = globalQueryID.fetch_add(1, std::memory_order_relaxed) + 1;
+  while (id == 0) {
+    id = globalQueryID.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+  return id;
+}
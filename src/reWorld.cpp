@@ -8,38 +8,32 @@
 
 #include "react/Dynamics/reGravAction.h"
 
-#include "react/Memory/reFreeListAllocator.h"
-#include "react/Memory/reProxyAllocator.h"
-
-// strictly for debugging
-namespace {
-  struct SimpleAllocator : public reBaseAllocator {
-  public:
-    SimpleAllocator() : n(0) { }
-    
-    void* alloc(u32 size, u8) { n++; return malloc(size); }
-    
-    void dealloc(void* p) { n--; free(p); }
-    
-    u32 used() const override { return 0; }
-    u32 numAllocs() const override { return n; }
-    u32 size() const override { return 0; }
-    void* ptr() const override { return nullptr; }
-  
-  private:
-    reUInt n;
-  };
-}
+#include "react/Entities/EntityRegistry.h"
+
+#include "react/Memory/reLinearAllocator.h"
+#include "react/Memory/reThreadCacheAllocator.h"
+#include "react/Memory/reTaggedAllocator.h"
+
+#include "react/Utilities/ShapeCache.h"
+#include "react/Utilities/Snapshot.h"
 
 /**
  * Default constructor initializes the world with the default settings
  */
 
-reWorld::reWorld() : _broadPhase(nullptr), _allocator(nullptr), _integrator(nullptr) {
-  SimpleAllocator* tmp = new SimpleAllocator();
-  _allocator = new reProxyAllocator(tmp);
-  _broadPhase = allocator().alloc_new<reBSPTree>(allocator());
+reWorld::reWorld() : _broadPhase(nullptr), _registry(nullptr), _allocator(nullptr), _taggedAllocators(), _frameAllocator(nullptr), _integrator(nullptr), _shapes(nullptr), _stepAllocs(0), _stepFrees(0) {
+  reProxyAllocator* proxy = new reProxyAllocator(new reThreadCacheAllocator());
+  _allocator = proxy;
+  for (reUInt i = 0; i < re::NUM_MEMORY_TAGS; i++) {
+    _taggedAllocators[i] = allocator().alloc_new<reTaggedAllocator>(*proxy, (re::MemoryTag)i);
+  }
+  
+  _frameAllocator = allocator().alloc_new<reLinearAllocator>(allocator(re::MEMORY_FRAME));
+  _broadPhase = allocator().alloc_new<reBSPTree>(allocator(re::MEMORY_BROAD_PHASE), allocator(re::MEMORY_CONTACTS));
+  // the registry keeps its slots after clearing, so it is not accounted to the entities
+  _registry = allocator().alloc_new<re::EntityRegistry>(allocator());
   _integrator = allocator().alloc_new<re::Integrator>();
+  _shapes = allocator().alloc_new<re::ShapeCache>(allocator(re::MEMORY_SHAPES));
 }
 
 /**
@@ -50,41 +44,101 @@ reWorld::~reWorld() {
   clear();
   
   allocator().alloc_delete(_broadPhase);
+  allocator().alloc_delete(_registry);
   allocator().alloc_delete(_integrator);
+  allocator().alloc_delete(_shapes);
+  allocator().alloc_delete(_frameAllocator);
+  for (reTaggedAllocator* tagged : _taggedAllocators) {
+    allocator().alloc_delete(tagged);
+  }
   
   if (_allocator != nullptr) {
-    reBaseAllocator* al = ((reProxyAllocator*)_allocator)->allocator();
+    reThreadCacheAllocator* al = (reThreadCacheAllocator*)((reProxyAllocator*)_allocator)->allocator();
+    // gathers the blocks freed by other threads before checking for leaks
+    al->collect();
     delete _allocator;
     delete al;
   }
 }
 
 /**
- * Removes all entities in the reWorld
+ * Removes all entities in the reWorld, along with any shapes which are no
+ * longer shared
  */
 
 void reWorld::clear() {
+  // handles are invalidated before the broad phase deletes the entities
+  _registry->clear();
   _broadPhase->clear();
+  _shapes->purge();
 }
 
 /**
- * Registers the entity to the world.
+ * Registers the entity to the world. Adding an entity which is already in the
+ * world has no effect.
  * 
  * @param entity The entity to attach
+ * @return The handle referring to the entity
  */
 
-void reWorld::add(re::Entity& entity) {
-  _broadPhase->add(entity);
+re::EntityHandle reWorld::add(re::Entity& entity) {
+  if (_broadPhase->add(entity)) {
+    return _registry->add(entity);
+  }
+  
+  return entity.handle();
+}
+
+/**
+ * Registers many entities to the world at once. Entities which are already
+ * in a world, or repeated in the array, are skipped as they are when added
+ * one at a time. If the broad phase has no structure yet, it is built once
+ * all entities are in place, which is far cheaper than adding them one at a
+ * time. Otherwise the entities are placed into the existing structure, which
+ * is not rebuilt, so callers adding many entities to a populated world should
+ * call reBroadPhase::rebalance() themselves afterwards.
+ * 
+ * @param entities The entities to attach
+ * @param n The number of entities
+ * @return The number of entities attached
+ */
+
+reUInt reWorld::add(re::Entity* const* entities, reUInt n) {
+  if (n == 0) {
+    return 0;
+  }
+  
+  re::Entity** added = (re::Entity**)allocator().alloc(n * sizeof(re::Entity*), __alignof(re::Entity*));
+  reUInt count = 0;
+  _registry->reserve(_registry->size() + n);
+  for (reUInt i = 0; i < n; i++) {
+    // registering issues a handle, so repeats in the array are caught too
+    if (entities[i]->handle().isNull()) {
+      _registry->add(*entities[i]);
+      added[count++] = entities[i];
+    }
+  }
+  
+  count = _broadPhase->add(added, count);
+  allocator().dealloc(added);
+  return count;
 }
 
 /**
  * Removes the entity from the world. This does NOT deallocate the resources
- * associated with the entity.
+ * associated with the entity. Entities which are not in this world are left
+ * alone, even if their handle is also valid in this world.
  * 
  * @param entity The entity to remove
  */
 
 void reWorld::remove(re::Entity& entity) {
+  // handles are only unique within a world, so the entity must match too
+  if (_registry->get(entity.handle()) != &entity) {
+    return;
+  }
+  
+  _registry->remove(entity);
   _broadPhase->remove(entity);
 }
 
@@ -97,18 +151,134 @@ void reWorld::remove(re::Entity& entity) {
 
 void reWorld::destroy(re::Entity& entity) {
   remove(entity);
-  allocator().alloc_delete(&entity.shape());
+  re::ShapeCache::release(allocator(), entity.shape());
   allocator().alloc_delete(&entity);
 }
 
 /**
- * Advances the reWorld forward in time by the given time step
+ * Destroys the entity referred to by the handle, if it is still in the world.
+ * Unlike references, stale handles are detected rather than dereferenced.
+ * 
+ * @param handle The handle of the entity to destroy
+ * @return True if the handle referred to an entity in the world
+ */
+
+bool reWorld::destroy(re::EntityHandle handle) {
+  re::Entity* entity = _registry->get(handle);
+  if (entity == nullptr) {
+    return false;
+  }
+  
+  destroy(*entity);
+  return true;
+}
+
+/**
+ * Advances the reWorld forward in time by the given time step. Temporary data
+ * used within the step is taken from the frame allocator, which is reset at
+ * the start of each step.
  * 
  * @param dt The time step to advance in user defined units
  */
 
 void reWorld::advance(reFloat dt) {
-  _broadPhase->advance(integrator(), dt);
+  const re::MemoryStats before = memoryStats();
+  
+  _frameAllocator->reset();
+  _broadPhase->advance(integrator(), dt, *_frameAllocator);
+  
+  const re::MemoryStats after = memoryStats();
+  _stepAllocs = 0;
+  _stepFrees = 0;
+  for (reUInt i = 0; i < re::NUM_MEMORY_TAGS; i++) {
+    _stepAllocs += after.tags[i].totalAllocs - before.tags[i].totalAllocs;
+    _stepFrees += after.tags[i].totalFrees - before.tags[i].totalFrees;
+  }
+}
+
+/**
+ * Writes a snapshot of the reWorld to the buffer, which can later be
+ * restored to reload the state of its entities. Nothing is written if the
+ * buffer is too small.
+ * 
+ * @param buffer The buffer to write to
+ * @param capacity The size of the buffer in bytes
+ * @return The size of the snapshot in bytes, or 0 if an entity has a shape
+ * which snapshots can not describe
+ * @see re::writeSnapshot
+ */
+
+reUInt reWorld::snapshot(void* buffer, reUInt capacity) const {
+  return re::writeSnapshot(*this, buffer, capacity);
+}
+
+/**
+ * Replaces the contents of the reWorld with a snapshot. This is a reload
+ * rather than a rollback: the existing entities are destroyed, so every
+ * handle and pointer to them becomes invalid, and the restored entities are
+ * issued new handles. Contacts are not saved, so they are found again on the
+ * next step without the impulses which warm started them.
+ * 
+ * @param data The snapshot written by reWorld::snapshot
+ * @param size The size of the snapshot in bytes
+ * @return False if the snapshot was rejected
+ * @see re::readSnapshot
+ */
+
+bool reWorld::restore(const void* data, reUInt size) {
+  return re::readSnapshot(*this, data, size);
+}
+
+/**
+ * Writes a snapshot of the reWorld to a file
+ * 
+ * @param path The path of the file to write
+ * @return False if the file could not be written, or an entity has a shape
+ * which snapshots can not describe
+ */
+
+bool reWorld::save(const char* path) const {
+  return re::saveSnapshot(*this, path);
+}
+
+/**
+ * Replaces the contents of the reWorld with a snapshot file, which is mapped
+ * into memory rather than read
+ * 
+ * @param path The path of the file to read
+ * @return False if the file could not be read or was rejected
+ */
+
+bool reWorld::load(const char* path) {
+  return re::loadSnapshot(*this, path);
+}
+
+/**
+ * Returns the allocator which accounts all memory allocated through it to
+ * the subsystem given by the tag
+ * 
+ * @param tag The subsystem responsible for the allocations
+ * @return The tagged reAllocator
+ */
+
+reAllocator& reWorld::allocator(re::MemoryTag tag) const {
+  return *_taggedAllocators[tag];
+}
+
+/**
+ * Takes a snapshot of the memory used by the reWorld, broken down by the
+ * subsystem responsible. Comparing the high water marks of each subsystem
+ * helps with sizing memory pools, while the step counters reveal steady
+ * state allocations.
+ * 
+ * @return The memory statistics
+ */
+
+re::MemoryStats reWorld::memoryStats() const {
+  re::MemoryStats stats = ((reProxyAllocator*)_allocator)->stats();
+  stats.stepAllocs = _stepAllocs;
+  stats.stepFrees = _stepFrees;
+  return stats;
 }
 
 /**
@@ -117,8 +287,19 @@ void reWorld::advance(reFloat dt) {
  * @return A list of re::Entity
  */
 
-const reLinkedList<re::Entity*>& reWorld::entities() const {
-  return _broadPhase->entities();
+const reDenseArray<re::Entity*>& reWorld::entities() const {
+  return _registry->entities();
+}
+
+/**
+ * Finds the entity referred to by the handle in constant time
+ * 
+ * @param handle The handle of the entity
+ * @return The entity, or a null pointer if it is no longer in the world
+ */
+
+re::Entity* reWorld::entity(re::EntityHandle handle) const {
+  return _registry->get(handle);
 }
 
 /**
@@ -148,3 +329,135 @@ re::Entity* reWorld::queryWithRay(const re::vec3& origin, const re::vec3& dir, r
   return nullptr;
 }
 
+/**
+ * Performs a spatial query on the reBroadPhase for each ray in the array. Each
+ * result holds the closest intersection found for the corresponding ray, with
+ * a null entity if the ray hit nothing.
+ * 
+ * @param rays The array of rays
+ * @param results The array of results, with one element for each ray
+ * @param n The number of rays
+ */
+
+void reWorld::queryWithRays(const re::Ray* rays, re::RayQuery* results, reUInt n) {
+  _broadPhase->queryWithRays(rays, results, n);
+}
+
+/**
+ * Returns true if any entity blocks the ray before the maximum distance. This
+ * is considerably cheaper than finding the closest entity, and should be
+ * preferred for shadow and line of sight tests.
+ * 
+ * @param origin The origin of the ray
+ * @param dir The ray direction
+ * @param maxDist The distance along the ray beyond which entities are ignored
+ * @return True if the ray is blocked
+ */
+
+bool reWorld::queryOcclusion(const re::vec3& origin, const re::vec3& dir, reFloat maxDist) {
+  return _broadPhase->queryOcclusion(re::Ray(origin, dir), maxDist);
+}
+
+/**
+ * Finds all entities overlapping the axis aligned box. At most capacity
+ * entities are written to the results, but all are counted.
+ * 
+ * @param aabb The box dimensions
+ * @param center The center of the box
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @return The number of entities found
+ */
+
+reUInt reWorld::queryWithAABB(const reAABB& aabb, const re::vec3& center, re::Entity** results, reUInt capacity) {
+  return _broadPhase->queryWithAABB(aabb, center, results, capacity);
+}
+
+/**
+ * Finds all entities overlapping the sphere. At most capacity entities are
+ * written to the results, but all are counted.
+ * 
+ * @param center The center of the sphere
+ * @param radius The radius of the sphere
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @return The number of entities found
+ */
+
+reUInt reWorld::queryWithSphere(const re::vec3& center, reFloat radius, re::Entity** results, reUInt capacity) {
+  return _broadPhase->queryWithSphere(center, radius, results, capacity);
+}
+
+/**
+ * Finds all entities overlapping the transformed shape. At most capacity
+ * entities are written to the results, but all are counted.
+ * 
+ * @param shape The shape to test with
+ * @param transform The transform of the shape
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @return The number of entities found
+ */
+
+reUInt reWorld::queryWithShape(const reShape& shape, const re::Transform& transform, re::Entity** results, reUInt capacity) {
+  return _broadPhase->queryWithShape(shape, transform, results, capacity);
+}
+
+/**
+ * Finds all entities which may be visible within the frustum. At most
+ * capacity entities are written to the results, but all are counted.
+ * 
+ * @param frustum The view frustum
+ * @param results The buffer the entities found are written to
+ * @param capacity The number of entities the buffer can hold
+ * @return The number of entities found
+ */
+
+reUInt reWorld::queryWithFrustum(const re::Frustum& frustum, re::Entity** results, reUInt capacity) {
+  return _broadPhase->queryWithFrustum(frustum, results, capacity);
+}
+
+/**
+ * Finds the k entities with centers closest to the point, sorted from nearest
+ * to furthest
+ * 
+ * @param point The point to search around
+ * @param results The buffer the results are written to, holding at least k
+ * @param k The number of entities to find
+ * @return The number of entities found
+ */
+
+reUInt reWorld::queryNearest(const re::vec3& point, re::SingleResult* results, reUInt k) {
+  return _broadPhase->queryNearest(point, results, k);
+}
+
+/**
+ * Finds all entities with centers within the radius of the point. At most
+ * capacity results are written, but all are counted.
+ * 
+ * @param point The point to search around
+ * @param radius The search radius
+ * @param results The buffer the results are written to
+ * @param capacity The number of results the buffer can hold
+ * @return The number of entities found
+ */
+
+reUInt reWorld::queryWithinRadius(const re::vec3& point, reFloat radius, re::SingleResult* results, reUInt capacity) {
+  return _broadPhase->queryWithinRadius(point, radius, results, capacity);
+}
+
+/**
+ * Moves the shape in a straight line along the path and finds the first
+ * entity it touches, along with the time, point and normal of the impact
+ * 
+ * @param shape The shape to sweep
+ * @param path The path travelled by the shape's origin
+ * @param result The first impact found, which is left unchanged on a miss
+ * @param orientation The orientation of the shape
+ * @return True if the shape touches an entity along the path
+ */
+
+bool reWorld::querySweep(const reShape& shape, const re::Segment& path, re::SweepQuery& result, const re::quat& orientation) {
+  return _broadPhase->querySweep(shape, path, result, orientation);
+}
+
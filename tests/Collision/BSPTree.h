@@ -2,6 +2,7 @@
 
 #include "react/Collision/reBSPTree.h"
 #include "react/Entities/Rigid.h"
+#include "react/Entities/Static.h"
 #include "react/Collision/Shapes/shapes.h"
 
 struct reBSPTreeTest : public ::testing::Test {
@@ -72,8 +73,23 @@ TEST_F(reBSPTreeTest, AddContainRemoveActions) {
   ASSERT_EQ(tree.size(), fixtures.size()) <<
     "should have size equal to the number added";
   
-  for (re::Rigid* body : fixtures) {
-    ASSERT_TRUE(tree.remove(*body)) <<
+  reBSPTree other(SHARED_ALLOCATOR);
+  ASSERT_FALSE(other.contains(body)) <<
+    "should return false for entities contained by another tree";
+  ASSERT_FALSE(other.remove(body)) <<
+    "should NOT be able to remove entities contained by another tree";
+  
+  for (reUInt i = 0; i < fixtures.size(); i += 2) {
+    ASSERT_TRUE(tree.remove(*fixtures[i])) <<
+      "should be able to remove contained entities";
+  }
+  for (reUInt i = 0; i < fixtures.size(); i++) {
+    ASSERT_EQ(tree.contains(*fixtures[i]), i % 2 == 1) <<
+      "should keep track of entities moved into the place of removed ones";
+  }
+  
+  for (reUInt i = 1; i < fixtures.size(); i += 2) {
+    ASSERT_TRUE(tree.remove(*fixtures[i])) <<
       "should be able to remove contained entities";
   }
   ASSERT_EQ(tree.size(), 0) <<
@@ -98,15 +114,68 @@ TEST_F(reBSPTreeTest, Sampling) {
       "should be able to add unique entities";
   }
   
-  auto list = tree.sample(300);
+  re::Entity* samples[300];
+  const reUInt n = tree.sample(samples, 300);
   
-  for (re::Entity* body : list) {
-    ASSERT_TRUE(tree.contains(*body)) <<
+  ASSERT_EQ(300u, n) <<
+    "should fill the buffer when the tree has enough entities";
+  
+  for (reUInt i = 0; i < n; i++) {
+    ASSERT_TRUE(tree.contains(*samples[i])) <<
       "should contain the body from the sample";
+    
+    for (reUInt j = 0; j < i; j++) {
+      ASSERT_NE(samples[j], samples[i]) <<
+        "should not sample the same body twice";
+    }
+  }
+  
+  tree.clear();
+  
+  ASSERT_NO_MEM_LEAKS();
+}
+
+TEST_F(reBSPTreeTest, BatchInsertion) {
+  generateFixtures(1000);
+  
+  std::vector<re::Entity*> entities(fixtures.begin(), fixtures.end());
+  ASSERT_EQ(tree.add(entities.data(), entities.size()), fixtures.size()) <<
+    "should add every entity in the batch";
+  
+  ASSERT_EQ(tree.size(), fixtures.size()) <<
+    "should have size equal to the number added";
+  
+  for (re::Rigid* body : fixtures) {
+    ASSERT_TRUE(tree.contains(*body)) <<
+      "should contain every entity in the batch";
   }
   
+  ASSERT_FALSE(tree.isLeaf()) <<
+    "should build the tree structure after adding the batch";
+  
+  ASSERT_LT(tree.placements(), fixtures.size()/3) <<
+    "should have dispersed the elements throughout the tree";
+  
+  reBPMeasure m = tree.measure();
+  ASSERT_EQ(m.references, m.entities) <<
+    "should contain an equal number of references and entities";
+  
+  ASSERT_TRUE(tree.remove(*fixtures[0])) <<
+    "should be able to remove entities added in a batch";
+  
+  ASSERT_TRUE(tree.add(*fixtures[0])) <<
+    "should be able to add entities after a batch";
+  
+  re::Rigid* a = SHARED_ALLOCATOR.alloc_new<re::Rigid>(*SHARED_ALLOCATOR.alloc_new<re::Sphere>(1.0));
+  re::Rigid* b = SHARED_ALLOCATOR.alloc_new<re::Rigid>(*SHARED_ALLOCATOR.alloc_new<re::Sphere>(1.0));
+  re::Entity* const repeated[] = { fixtures[0], a, a, b };
+  ASSERT_EQ(tree.add(repeated, 4), 2) <<
+    "should skip entities already in the tree or repeated in the batch";
+  
+  ASSERT_EQ(tree.size(), fixtures.size() + 2) <<
+    "should only contain each entity once";
+  
   tree.clear();
-  list.clear();
   
   ASSERT_NO_MEM_LEAKS();
 }
@@ -235,3 +304,469 @@ TEST_F(reBSPTreeTest, RayQueries) {
   }
 }
 
+
+TEST_F(reBSPTreeTest, BatchedRayQueries) {
+  const int N = 20;
+  generateFixtures(N*N);
+  
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      re::Rigid* body = fixtures.at(N*i + j);
+      body->setPos(3.0 * re::vec3(i - N/2, j - N/2, 0.0));
+      ASSERT_TRUE(tree.add(*body)) <<
+        "should be able to add new entities";
+    }
+  }
+  tree.rebalance();
+  
+  // an extra ray which misses everything leaves a partially filled packet
+  const re::vec3 origin(0.0, 0.0, 100.0);
+  std::vector<re::Ray> rays;
+  for (re::Rigid* body : fixtures) {
+    rays.push_back(re::Ray(origin, body->center() - origin));
+  }
+  rays.push_back(re::Ray(origin, re::vec3(0.0, 0.0, 1.0)));
+  
+  std::vector<re::RayQuery> results(rays.size());
+  tree.queryWithRays(&rays[0], &results[0], rays.size());
+  
+  for (unsigned int i = 0; i < rays.size(); i++) {
+    const re::RayQuery expected = tree.queryWithRay(rays[i]);
+    ASSERT_EQ(expected.entity, results[i].entity) <<
+      "should find the same entity as a single ray query for ray " << i;
+    
+    if (expected.entity != nullptr) {
+      // single precision loses accuracy for distant ray origins
+      ASSERT_LE(re::length(expected.point - results[i].point), 1e-2) <<
+        "should return the same intersection point for ray " << i;
+      
+      ASSERT_LE(re::length(expected.normal - results[i].normal), 1e-2) <<
+        "should return the same intersection normal for ray " << i;
+    }
+  }
+  
+  ASSERT_EQ(results.back().entity, nullptr) <<
+    "should not find an entity for a ray which misses everything";
+  
+  for (unsigned int i = 0; i < fixtures.size(); i++) {
+    rays.push_back(re::Ray(re::vec3::rand(150.0), re::vec3::rand()));
+  }
+  results.resize(rays.size());
+  tree.queryWithRays(&rays[0], &results[0], rays.size());
+  
+  for (unsigned int i = 0; i < rays.size(); i++) {
+    ASSERT_EQ(tree.queryWithRay(rays[i]).entity, results[i].entity) <<
+      "should find the same entity for incoherent rays " << i;
+  }
+  
+  tree.clear();
+}
+
+TEST_F(reBSPTreeTest, OcclusionQueries) {
+  generateFixtures(500);
+  
+  for (re::Rigid* body : fixtures) {
+    ASSERT_TRUE(tree.add(*body)) <<
+      "should be able to add new entities";
+  }
+  tree.rebalance();
+  
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    const re::Ray ray(re::vec3::rand(150.0), re::vec3::rand());
+    const re::RayQuery closest = tree.queryWithRay(ray);
+    
+    ASSERT_EQ(closest.entity != nullptr, tree.queryOcclusion(ray)) <<
+      "should be blocked by any entity the ray hits";
+    
+    // leaves room for the single precision error of distant ray origins
+    if (closest.entity != nullptr) {
+      ASSERT_TRUE(tree.queryOcclusion(ray, closest.depth + 0.1)) <<
+        "should be blocked when the closest entity is within the maximum distance";
+      
+      ASSERT_FALSE(tree.queryOcclusion(ray, closest.depth - 0.1)) <<
+        "should not be blocked by entities beyond the maximum distance";
+    }
+  }
+  
+  tree.clear();
+}
+
+TEST_F(reBSPTreeTest, IntervalRayQueries) {
+  generateFixtures(500);
+  
+  for (re::Rigid* body : fixtures) {
+    ASSERT_TRUE(tree.add(*body)) <<
+      "should be able to add new entities";
+  }
+  tree.rebalance();
+  
+  for (int i = 0; i < NUM_SAMPLES/10; i++) {
+    re::Ray ray(re::vec3::rand(150.0), re::vec3::rand());
+    if (i % 2 == 1) {
+      ray.setInterval(re::randf(0.0, 50.0), re::randf(50.0, 200.0));
+    }
+    
+    // compare against testing every entity
+    re::RayQuery expected;
+    re::RayQuery res;
+    for (re::Rigid* body : fixtures) {
+      if (body->intersects(ray, res) && res.depth < expected.depth) {
+        expected.depth = res.depth;
+        expected.entity = body;
+      }
+    }
+    
+    const re::RayQuery result = tree.queryWithRay(ray);
+    ASSERT_EQ(expected.entity, result.entity) <<
+      "should find the closest entity within the interval";
+    
+    if (result.entity != nullptr) {
+      ASSERT_GE(result.depth, ray.tMin()) <<
+        "should not return hits before the interval";
+      
+      ASSERT_LE(result.depth, ray.tMax()) <<
+        "should not return hits beyond the interval";
+    }
+  }
+  
+  tree.clear();
+}
+
+#include <thread>
+
+TEST_F(reBSPTreeTest, ConcurrentQueries) {
+  const unsigned int NUM_THREADS = 4;
+  const unsigned int NUM_RAYS = 500;
+  generateFixtures(500);
+  
+  for (re::Rigid* body : fixtures) {
+    ASSERT_TRUE(tree.add(*body)) <<
+      "should be able to add new entities";
+  }
+  tree.rebalance();
+  
+  std::vector<re::Ray> rays;
+  std::vector<re::RayQuery> expected;
+  re::resetQueriesMade();
+  for (unsigned int i = 0; i < NUM_RAYS; i++) {
+    rays.push_back(re::Ray(re::vec3::rand(150.0), re::vec3::rand()));
+    expected.push_back(tree.queryWithRay(rays.back()));
+  }
+  const reUInt queriesPerPass = re::queriesMade();
+  
+  std::vector<std::vector<re::Entity*>> found(NUM_THREADS);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < NUM_THREADS; t++) {
+    threads.push_back(std::thread([&, t]() {
+      for (const re::Ray& ray : rays) {
+        found[t].push_back(tree.queryWithRay(ray).entity);
+        tree.contains(*fixtures[found[t].size() % fixtures.size()]);
+      }
+    }));
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  
+  for (unsigned int t = 0; t < NUM_THREADS; t++) {
+    for (unsigned int i = 0; i < NUM_RAYS; i++) {
+      ASSERT_EQ(expected[i].entity, found[t][i]) <<
+        "should return the same results when queried concurrently";
+    }
+  }
+  
+  ASSERT_EQ(queriesPerPass * (NUM_THREADS + 1), re::queriesMade()) <<
+    "should aggregate the query counts made on every thread";
+  
+  re::resetQueriesMade();
+  ASSERT_EQ(re::queriesMade(), 0) <<
+    "should reset the query counts of every thread";
+  
+  tree.clear();
+}
+
+#include "react/Collision/Frustum.h"
+
+namespace {
+  /**
+   * Checks the entities found against the signed distance of each fixture
+   * from the region, ignoring fixtures too close to the boundary to call
+   */
+  template <class Distance>
+  void checkRegion(const std::vector<re::Rigid*>& fixtures, re::Entity** found, reUInt count, Distance distance) {
+    for (re::Rigid* body : fixtures) {
+      bool isFound = false;
+      for (reUInt i = 0; i < count; i++) {
+        isFound = isFound || found[i] == body;
+      }
+      const reFloat dist = distance(*body);
+      if (dist < -0.01) {
+        ASSERT_TRUE(isFound) <<
+          "should find entities overlapping the region";
+      } else if (dist > 0.01) {
+        ASSERT_FALSE(isFound) <<
+          "should not find entities away from the region";
+      }
+    }
+  }
+}
+
+TEST_F(reBSPTreeTest, RegionQueries) {
+  generateFixtures(1000);
+  
+  for (re::Rigid* body : fixtures) {
+    ASSERT_TRUE(tree.add(*body)) <<
+      "should be able to add new entities";
+  }
+  tree.rebalance();
+  
+  std::vector<re::Entity*> found(fixtures.size());
+  for (int i = 0; i < 50; i++) {
+    const re::vec3 center = re::vec3::rand(100.0);
+    const reFloat radius = re::randf(1.0, 30.0);
+    
+    reUInt count = tree.queryWithSphere(center, radius, &found[0], found.size());
+    checkRegion(fixtures, &found[0], count, [&](re::Rigid& body) {
+      return re::length(body.center() - center) - radius - 1.0;
+    });
+    
+    const re::Sphere sphere(radius);
+    ASSERT_EQ(count, tree.queryWithShape(sphere, re::Transform(re::mat3(1.0), center), &found[0], found.size())) <<
+      "should find the same entities with an equivalent shape";
+    
+    reAABB aabb;
+    aabb.dimens() = re::vec3(re::randf(1.0, 30.0), re::randf(1.0, 30.0), re::randf(1.0, 30.0));
+    count = tree.queryWithAABB(aabb, center, &found[0], found.size());
+    checkRegion(fixtures, &found[0], count, [&](re::Rigid& body) {
+      // treats the spheres as boxes, matching the conservative face tests
+      const re::vec3 d = body.center() - center;
+      return re::max(re::max(re::abs(d.x) - aabb.dimens().x, re::abs(d.y) - aabb.dimens().y), re::abs(d.z) - aabb.dimens().z) - 1.0;
+    });
+    
+    const re::Frustum frustum(center, re::vec3::rand(), re::vec3::rand(), re::randf(0.5, 1.5), re::randf(0.5, 2.0), 1.0, 80.0);
+    count = tree.queryWithFrustum(frustum, &found[0], found.size());
+    checkRegion(fixtures, &found[0], count, [&](re::Rigid& body) {
+      reFloat dist = RE_NEGATIVE_INFINITY;
+      for (reUInt j = 0; j < re::Frustum::NUM_PLANES; j++) {
+        const re::Plane plane = frustum.plane(j);
+        dist = re::max(dist, re::dot(plane.normal(), body.center()) - plane.offset());
+      }
+      return dist - 1.0;
+    });
+    
+    ASSERT_EQ(count, tree.queryWithFrustum(frustum, &found[0], 3)) <<
+      "should count every entity found even when the buffer is too small";
+  }
+  
+  tree.clear();
+}
+
+#include <algorithm>
+
+TEST_F(reBSPTreeTest, MixedRegionQueries) {
+  generateFixtures(300);
+
+  std::vector<re::Entity*> entities(fixtures.begin(), fixtures.end());
+  for (int i = 0; i < 100; i++) {
+    reTriangle* triangle = SHARED_ALLOCATOR.alloc_new<reTriangle>(re::vec3::rand(3.0), re::vec3::rand(3.0), re::vec3::rand(3.0));
+    re::Rigid* body = SHARED_ALLOCATOR.alloc_new<re::Rigid>(*triangle);
+    body->setPos(re::vec3::rand(100.0));
+    entities.push_back(body);
+  }
+  for (int i = 0; i < 50; i++) {
+    re::Sphere* sphere = SHARED_ALLOCATOR.alloc_new<re::Sphere>(1.0);
+    re::ShapeProxy* proxy = SHARED_ALLOCATOR.alloc_new<re::ShapeProxy>(sphere, re::Transform().scale(3.0, 3.0, 3.0));
+    re::Rigid* body = SHARED_ALLOCATOR.alloc_new<re::Rigid>(*proxy);
+    body->setPos(re::vec3::rand(100.0));
+    entities.push_back(body);
+  }
+  entities.push_back(SHARED_ALLOCATOR.alloc_new<re::Static>(*SHARED_ALLOCATOR.alloc_new<re::Plane>(re::vec3(0.0, 1.0, 0.0), 20.0)));
+  entities.push_back(SHARED_ALLOCATOR.alloc_new<re::Static>(*SHARED_ALLOCATOR.alloc_new<re::Plane>(re::vec3(1.0, 0.0, 0.0), 120.0)));
+
+  for (re::Entity* entity : entities) {
+    ASSERT_TRUE(tree.add(*entity)) <<
+      "should be able to add entities of any shape";
+  }
+  tree.rebalance();
+
+  ASSERT_TRUE(tree.hasChildren()) <<
+    "should split a tree holding triangles and planes";
+
+  // compares every entity with the query shape directly
+  const auto checkShape = [&](const reShape& shape, const re::Transform& transform, re::Entity** found, reUInt count) {
+    for (re::Entity* entity : entities) {
+      bool isFound = false;
+      for (reUInt i = 0; i < count; i++) {
+        isFound = isFound || found[i] == entity;
+      }
+
+      if (shape.type() == reShape::TRIANGLE && entity->baseShape().type() == reShape::TRIANGLE) {
+        re::vec3 center, entityCenter;
+        reFloat radius, entityRadius;
+        re::boundingSphere(shape, transform, center, radius);
+        re::boundingSphere(entity->baseShape(), entity->shapeTransform(), entityCenter, entityRadius);
+        if (isFound) {
+          ASSERT_LT(re::lengthSq(center - entityCenter), re::sq(radius + entityRadius)) <<
+            "should only find triangles with overlapping bounding spheres";
+        }
+      } else {
+        re::Intersect intersect;
+        ASSERT_EQ(re::intersects(shape, transform, entity->baseShape(), entity->shapeTransform(), intersect), isFound) <<
+          "should find exactly the entities overlapping the query shape";
+      }
+    }
+  };
+
+  std::vector<re::Entity*> found(entities.size());
+  for (int i = 0; i < 50; i++) {
+    const re::vec3 center = re::vec3::rand(100.0);
+    const reFloat radius = re::randf(1.0, 30.0);
+
+    reUInt count = tree.queryWithSphere(center, radius, &found[0], found.size());
+    checkShape(re::Sphere(radius), re::Transform(re::mat3(1.0), center), &found[0], count);
+
+    const reTriangle triangle(re::vec3::rand(20.0), re::vec3::rand(20.0), re::vec3::rand(20.0));
+    count = tree.queryWithShape(triangle, re::Transform(re::mat3(1.0), center), &found[0], found.size());
+    checkShape(triangle, re::Transform(re::mat3(1.0), center), &found[0], count);
+
+    const re::Plane plane(re::vec3::rand(1.0), re::randf(-50.0, 50.0));
+    count = tree.queryWithShape(plane, IDEN_TRANS, &found[0], found.size());
+    checkShape(plane, IDEN_TRANS, &found[0], count);
+
+    reAABB aabb;
+    aabb.dimens() = re::vec3(re::randf(1.0, 30.0), re::randf(1.0, 30.0), re::randf(1.0, 30.0));
+    tree.queryWithAABB(aabb, center, &found[0], found.size());
+
+    const re::Frustum frustum(center, re::vec3::rand(), re::vec3::rand(), re::randf(0.5, 1.5), re::randf(0.5, 2.0), 1.0, 80.0);
+    tree.queryWithFrustum(frustum, &found[0], found.size());
+  }
+
+  re::Entity* scaled = entities[400];
+  const reUInt count = tree.queryWithSphere(scaled->pos() + re::vec3(3.5, 0.0, 0.0), 1.0, &found[0], found.size());
+  ASSERT_TRUE(std::find(&found[0], &found[0] + count, scaled) != &found[0] + count) <<
+    "should account for the scaling of proxied spheres";
+
+  tree.clear();
+}
+
+TEST_F(reBSPTreeTest, ProximityQueries) {
+  generateFixtures(1000);
+  
+  for (re::Rigid* body : fixtures) {
+    ASSERT_TRUE(tree.add(*body)) <<
+      "should be able to add new entities";
+  }
+  tree.rebalance();
+  
+  const reUInt K = 10;
+  std::vector<re::SingleResult> results(fixtures.size());
+  std::vector<reFloat> distances;
+  for (int i = 0; i < 50; i++) {
+    const re::vec3 point = re::vec3::rand(120.0);
+    distances.clear();
+    for (re::Rigid* body : fixtures) {
+      distances.push_back(re::lengthSq(body->center() - point));
+    }
+    std::sort(distances.begin(), distances.end());
+    
+    ASSERT_EQ(K, tree.queryNearest(point, &results[0], K)) <<
+      "should find k entities when there are enough";
+    
+    for (reUInt j = 0; j < K; j++) {
+      ASSERT_FLOAT_EQ(distances[j], results[j].distSq) <<
+        "should find the nearest entities in order of distance";
+      
+      ASSERT_FLOAT_EQ(re::lengthSq(results[j].entity->center() - point), results[j].distSq) <<
+        "should report the distance to the entity found";
+    }
+    
+    const reFloat radius = re::randf(1.0, 40.0);
+    const reUInt count = tree.queryWithinRadius(point, radius, &results[0], results.size());
+    const reUInt expected = std::upper_bound(distances.begin(), distances.end(), radius * radius) - distances.begin();
+    ASSERT_EQ(expected, count) <<
+      "should find every entity within the radius";
+    
+    for (reUInt j = 0; j < count; j++) {
+      ASSERT_LE(results[j].distSq, radius * radius) <<
+        "should only find entities within the radius";
+    }
+    
+    ASSERT_EQ(count, tree.queryWithinRadius(point, radius, &results[0], 2)) <<
+      "should count every entity found even when the buffer is too small";
+  }
+  
+  results.resize(fixtures.size() + 5);
+  ASSERT_EQ(fixtures.size(), tree.queryNearest(re::vec3(), &results[0], results.size())) <<
+    "should find every entity when k exceeds the number of entities";
+  
+  tree.clear();
+}
+
+TEST_F(reBSPTreeTest, SweepQueries) {
+  generateFixtures(500);
+  
+  for (re::Rigid* body : fixtures) {
+    ASSERT_TRUE(tree.add(*body)) <<
+      "should be able to add new entities";
+  }
+  tree.rebalance();
+  
+  const re::Sphere sphere(2.0);
+  for (int i = 0; i < NUM_SAMPLES/10; i++) {
+    // starts clear of every entity, so that each hit is a real touch
+    re::vec3 start;
+    bool clear = false;
+    while (!clear) {
+      start = re::vec3::rand(120.0);
+      clear = true;
+      for (re::Rigid* body : fixtures) {
+        clear = clear && re::length(body->center() - start) > 3.0 + 1e-2;
+      }
+    }
+    const re::Segment path(start, re::vec3::rand(120.0));
+    
+    // compare against sweeping past every entity
+    bool found = false;
+    reFloat expected = 1.0;
+    for (re::Rigid* body : fixtures) {
+      const reFloat along = re::dot(body->center() - path.start, re::normalize(path.end - path.start));
+      const reFloat clamped = re::max(0.0, re::min(along, re::length(path.end - path.start)));
+      const re::vec3 closest = path.start + re::normalize(path.end - path.start) * clamped;
+      if (re::length(body->center() - closest) < 3.0) {
+        const reFloat offset = re::sqrt(re::max(0.0, 9.0 - re::lengthSq(body->center() - path.start - re::normalize(path.end - path.start) * along)));
+        expected = re::min(expected, (along - offset) / re::length(path.end - path.start));
+        found = true;
+      }
+    }
+    
+    re::SweepQuery result;
+    const bool hit = tree.querySweep(sphere, path, result);
+    ASSERT_EQ(found, hit) <<
+      "should hit an entity only if one lies along the path";
+    
+    if (hit) {
+      ASSERT_LE(re::abs(expected - result.time), 1e-3) <<
+        "should find the earliest impact along the path";
+      
+      ASSERT_LE(re::abs(re::length(path.start + (path.end - path.start) * result.time - result.entity->center()) - 3.0), 1e-2) <<
+        "should stop the sweep where the spheres touch";
+    }
+  }
+  
+  // a sweep starting inside an entity only hits it when heading further in
+  re::Rigid* body = fixtures[0];
+  const re::vec3 inside = body->center() + re::vec3(1.0, 0.0, 0.0);
+  re::SweepQuery result;
+  ASSERT_TRUE(tree.querySweep(sphere, re::Segment(inside, inside - re::vec3(5.0, 0.0, 0.0)), result)) <<
+    "should hit an entity the sweep starts inside when heading into it";
+
+  ASSERT_FLOAT_EQ(result.time, 0.0) <<
+    "should hit an entity the sweep starts inside at once";
+
+  result = re::SweepQuery();
+  tree.querySweep(sphere, re::Segment(inside, inside + re::vec3(5.0, 0.0, 0.0)), result);
+  ASSERT_NE(result.entity, body) <<
+    "should not hit an entity the sweep starts inside when heading out of it";
+  
+  tree.clear();
+}
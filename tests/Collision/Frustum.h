@@ -0,0 +1,32 @@
+#include "helpers.h"
+
+#include "react/Collision/Frustum.h"
+
+TEST(Frustum, Perspective_test) {
+  const re::vec3 eye(1.0, 2.0, 3.0);
+  const re::Frustum frustum(eye, re::vec3(0.0, 0.0, -1.0), re::vec3(0.0, 1.0, 0.0), 2.0 * std::atan(0.5), 2.0, 1.0, 10.0);
+
+  ASSERT_TRUE(frustum.containsPoint(eye + re::vec3(0.0, 0.0, -5.0))) <<
+    "should contain points along the view direction";
+
+  ASSERT_FALSE(frustum.containsPoint(eye + re::vec3(0.0, 0.0, -0.5))) <<
+    "should not contain points before the near plane";
+
+  ASSERT_FALSE(frustum.containsPoint(eye + re::vec3(0.0, 0.0, -11.0))) <<
+    "should not contain points beyond the far plane";
+
+  ASSERT_FALSE(frustum.containsPoint(eye + re::vec3(0.0, 3.0, -5.0))) <<
+    "should not contain points outside the field of view";
+
+  // the near plane is 2 wide and 1 high, the far plane 20 wide and 10 high
+  ASSERT_LE(re::length(frustum.corner(0) - (eye + re::vec3(-1.0, -0.5, -1.0))), RE_FP_TOLERANCE) <<
+    "should compute the bottom left near corner";
+
+  ASSERT_LE(re::length(frustum.corner(7) - (eye + re::vec3(10.0, 5.0, -10.0))), RE_FP_TOLERANCE) <<
+    "should compute the top right far corner";
+
+  for (reUInt i = 0; i < re::Frustum::NUM_CORNERS; i++) {
+    ASSERT_TRUE(frustum.containsPoint(frustum.corner(i))) <<
+      "should contain its own corners";
+  }
+}
@@ -50,6 +50,9 @@ TEST(IntersectionTests, Plane_Sphere_test) {
       ASSERT_FLOAT_EQ(re::abs(re::dot(plane.normal(), result.normal)), 1.0) <<
         "should return an intersection normal parallel to the plane face normal";
 
+      ASSERT_GT(re::dot(plane.normal(), result.normal) * dist, 0.0) <<
+        "should return an intersection normal pointing towards the sphere";
+
       ASSERT_GE(result.depth, 0.0) <<
         "penetration depth should always be positive";
 
@@ -82,3 +85,290 @@ TEST(IntersectionTests, Plane_Sphere_test) {
     }
   }
 }
+
+TEST(IntersectionTests, Scaled_Sphere_test) {
+  const re::Sphere s(1.0);
+  re::Transform scaled = re::Transform().scale(2.0, 2.0, 2.0);
+  scaled.v = re::vec3(2.5, 0.0, 0.0);
+
+  re::Intersect result;
+  ASSERT_TRUE(re::intersects(s, IDEN_TRANS, s, scaled, result)) <<
+    "should account for the scaling of the sphere transforms";
+
+  ASSERT_TRUE(re::intersects(s, scaled, s, IDEN_TRANS, result)) <<
+    "should account for the scaling regardless of the argument order";
+
+  const re::Plane plane(re::vec3(1.0, 0.0, 0.0), 1.0);
+  ASSERT_TRUE(re::intersects(plane, IDEN_TRANS, s, scaled, result)) <<
+    "should account for the scaling of spheres against planes";
+
+  re::vec3 center;
+  reFloat radius;
+  re::boundingSphere(s, scaled, center, radius);
+  ASSERT_LE(re::abs(radius - 2.0), RE_FP_TOLERANCE) <<
+    "should enclose the scaled sphere";
+}
+
+TEST(IntersectionTests, Sphere_Triangle_test) {
+  const re::Sphere s(1.0);
+  const reTriangle triangle(re::vec3(-1.0, -1.0, 0.0), re::vec3(1.0, -1.0, 0.0), re::vec3(0.0, 1.0, 0.0));
+
+  const auto segmentDist = [](const re::vec3& a, const re::vec3& b, const re::vec3& p) {
+    const reFloat t = re::max(0.0, re::min(1.0, re::dot(p - a, b - a) / re::lengthSq(b - a)));
+    return re::length(p - (a + (b - a) * t));
+  };
+
+  re::Transform transform;
+  re::Intersect result;
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    transform.v = re::vec3::rand(3.0);
+
+    // above the face if the point lies above both slanted edges
+    reFloat dist;
+    if (transform.v.y > -1.0 && transform.v.y < 1.0 - 2.0 * re::abs(transform.v.x)) {
+      dist = re::abs(transform.v.z);
+    } else {
+      dist = re::min(re::min(
+        segmentDist(triangle.vert(0), triangle.vert(1), transform.v),
+        segmentDist(triangle.vert(1), triangle.vert(2), transform.v)),
+        segmentDist(triangle.vert(2), triangle.vert(0), transform.v));
+    }
+
+    const reFloat reach = s.radius() + triangle.shell();
+    if (re::abs(dist - reach) < 1e-3) {
+      continue;
+    }
+
+    const bool intersects = re::intersects(s, transform, triangle, IDEN_TRANS, result);
+    ASSERT_EQ(dist < reach, intersects) <<
+      "should return true if the sphere center is closer to the triangle than the radius";
+
+    if (intersects) {
+      ASSERT_LE(re::abs(result.depth - (reach - dist)), 1e-3) <<
+        "should return the correct penetration depth";
+
+      ASSERT_LE(re::abs(re::length(transform.v - result.point) - dist), 1e-3) <<
+        "should return the closest point on the triangle";
+
+      ASSERT_GE(re::dot(result.normal, transform.v - result.point), 0.0) <<
+        "should return a normal pointing towards the sphere";
+    }
+
+    const re::vec3 norm = result.normal;
+    ASSERT_EQ(intersects, re::intersects(triangle, IDEN_TRANS, s, transform, result)) <<
+      "should give the same result when the arguments are rearranged";
+
+    if (intersects) {
+      ASSERT_FLOAT_EQ(re::dot(norm, result.normal), -1.0) <<
+        "should return the normal vector facing in the opposite direction";
+    }
+  }
+}
+
+TEST(IntersectionTests, Plane_Plane_test) {
+  const re::Plane ground(re::vec3(0.0, 1.0, 0.0), 0.0);
+
+  re::Intersect result;
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    const re::Plane plane(re::vec3::rand(1.0), re::randf(-5.0, 5.0));
+    if (re::abs(plane.normal().y) > 0.999) {
+      continue;
+    }
+
+    ASSERT_TRUE(re::intersects(ground, IDEN_TRANS, plane, IDEN_TRANS, result)) <<
+      "should always intersect planes which are not parallel";
+
+    ASSERT_LE(re::abs(re::dot(ground.normal(), result.point) - ground.offset()), 1e-3) <<
+      "should return a point on the first plane";
+
+    ASSERT_LE(re::abs(re::dot(plane.normal(), result.point) - plane.offset()), 1e-3) <<
+      "should return a point on the second plane";
+  }
+
+  const re::Plane near(re::vec3(0.0, 1.0, 0.0), 0.5 * ground.shell());
+  ASSERT_TRUE(re::intersects(ground, IDEN_TRANS, near, IDEN_TRANS, result)) <<
+    "should intersect parallel planes with overlapping shells";
+
+  ASSERT_LE(re::length(result.normal - re::vec3(0.0, -1.0, 0.0)), RE_FP_TOLERANCE) <<
+    "should return a normal pointing towards the first plane";
+
+  const re::Plane far(re::vec3(0.0, -1.0, 0.0), 3.0);
+  ASSERT_FALSE(re::intersects(ground, IDEN_TRANS, far, IDEN_TRANS, result)) <<
+    "should not intersect parallel planes which are apart";
+}
+
+TEST(IntersectionTests, Plane_Triangle_test) {
+  const re::Plane plane(re::vec3(0.0, 0.0, 1.0), 0.0);
+  const reTriangle triangle(re::vec3(-1.0, -1.0, 0.0), re::vec3(1.0, -1.0, 0.0), re::vec3(0.0, 1.0, 0.0));
+
+  re::Transform transform;
+  re::Intersect result;
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    transform = re::Transform(IDEN_MAT, re::vec3::rand(3.0)).rotate(re::randf(6.0), re::vec3::rand(1.0));
+
+    reFloat minV = RE_INFINITY;
+    reFloat maxV = RE_NEGATIVE_INFINITY;
+    for (reUInt j = 0; j < 3; j++) {
+      const reFloat dist = transform.applyToPoint(triangle.vert(j)).z;
+      minV = re::min(minV, dist);
+      maxV = re::max(maxV, dist);
+    }
+
+    const reFloat shells = plane.shell() + triangle.shell();
+    ASSERT_EQ(minV < shells && maxV > -shells, re::intersects(plane, IDEN_TRANS, triangle, transform, result)) <<
+      "should return true if the triangle reaches the plane";
+
+    ASSERT_EQ(minV < shells && maxV > -shells, re::intersects(triangle, transform, plane, IDEN_TRANS, result)) <<
+      "should give the same result when the arguments are rearranged";
+  }
+}
+
+TEST(IntersectionTests, Ray_Triangle_test) {
+  const reTriangle triangle(re::vec3(-1.0, -1.0, 0.0), re::vec3(1.0, -1.0, 0.0), re::vec3(0.0, 1.0, 0.0));
+
+  re::Intersect result;
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    const re::vec3 target(re::randf(-1.0, 1.0), re::randf(-1.0, 1.0), 0.0);
+    const re::vec3 origin(re::randf(-5.0, 5.0), re::randf(-5.0, 5.0), re::randf(1.0, 5.0));
+    const re::Ray ray(origin, target - origin);
+
+    // inside if the target lies above both slanted edges
+    const bool inside = target.y < 1.0 - 2.0 * re::abs(target.x);
+    if (re::abs(target.y - 1.0 + 2.0 * re::abs(target.x)) < 1e-3) {
+      continue;
+    }
+
+    ASSERT_EQ(inside, re::intersects(triangle, IDEN_TRANS, ray, result)) <<
+      "should return true only if the ray passes through the triangle";
+
+    if (inside) {
+      ASSERT_LE(re::length(result.point - target), 1e-3) <<
+        "should return the point where the ray crosses the triangle";
+
+      ASSERT_LE(re::abs(result.depth - re::length(target - origin)), 1e-3) <<
+        "should return the distance along the ray as the depth";
+
+      ASSERT_LT(re::dot(result.normal, ray.dir()), 0.0) <<
+        "should return a normal facing the ray";
+    }
+
+    const re::Ray away(origin, origin - target);
+    ASSERT_FALSE(re::intersects(triangle, IDEN_TRANS, away, result)) <<
+      "should not intersect a ray pointing away from the triangle";
+  }
+}
+
+TEST(IntersectionTests, Sphere_Sweep_test) {
+  const re::Sphere s(1.0);
+  const re::Sphere target(2.0);
+  const re::Plane plane(re::vec3(0.0, 1.0, 0.0), -5.0);
+
+  reFloat time;
+  re::Intersect result;
+  re::Transform start(IDEN_MAT, re::vec3(-10.0, 0.0, 0.0));
+  ASSERT_TRUE(re::sweep(s, start, re::vec3(20.0, 0.0, 0.0), target, IDEN_TRANS, 1.0, time, result)) <<
+    "should hit a sphere lying along the path";
+
+  ASSERT_LE(re::abs(time - 0.35), RE_FP_TOLERANCE) <<
+    "should stop when the surfaces first touch";
+
+  ASSERT_LE(re::length(result.point - re::vec3(-2.0, 0.0, 0.0)), RE_FP_TOLERANCE) <<
+    "should return the point of impact on the target";
+
+  ASSERT_LE(re::length(result.normal - re::vec3(-1.0, 0.0, 0.0)), RE_FP_TOLERANCE) <<
+    "should return a normal facing the swept shape";
+
+  ASSERT_LE(re::abs(result.depth - 7.0), RE_FP_TOLERANCE) <<
+    "should return the distance travelled";
+
+  ASSERT_FALSE(re::sweep(s, start, re::vec3(5.0, 0.0, 0.0), target, IDEN_TRANS, 1.0, time, result)) <<
+    "should not hit a sphere beyond the end of the path";
+
+  ASSERT_FALSE(re::sweep(s, start, re::vec3(20.0, 12.0, 0.0), target, IDEN_TRANS, 1.0, time, result)) <<
+    "should not hit a sphere the path passes by";
+
+  ASSERT_TRUE(re::sweep(s, IDEN_TRANS, re::vec3(1.0, 0.0, 0.0), target, IDEN_TRANS, 1.0, time, result)) <<
+    "should hit an overlapping sphere";
+
+  ASSERT_FLOAT_EQ(time, 0.0) <<
+    "should hit an overlapping sphere immediately";
+
+  ASSERT_TRUE(re::sweep(s, IDEN_TRANS, re::vec3(0.0, -10.0, 0.0), plane, IDEN_TRANS, 1.0, time, result)) <<
+    "should hit a plane lying across the path";
+
+  ASSERT_LE(re::abs(time - 0.4), RE_FP_TOLERANCE) <<
+    "should stop when the sphere first touches the plane";
+
+  ASSERT_LE(re::length(result.normal - re::vec3(0.0, 1.0, 0.0)), RE_FP_TOLERANCE) <<
+    "should return the plane normal facing the swept shape";
+
+  ASSERT_FALSE(re::sweep(s, IDEN_TRANS, re::vec3(0.0, 10.0, 0.0), plane, IDEN_TRANS, 1.0, time, result)) <<
+    "should not hit a plane when moving away from it";
+}
+
+TEST(IntersectionTests, Triangle_Sweep_test) {
+  const re::Sphere s(0.5);
+  const re::Sphere inflated(0.5 + RE_FP_TOLERANCE);
+  const re::Sphere deflated(0.5 - RE_FP_TOLERANCE);
+  const reTriangle triangle(re::vec3(-1.0, -1.0, 0.0), re::vec3(1.0, -1.0, 0.0), re::vec3(0.0, 1.0, 0.0));
+
+  reFloat time;
+  re::Intersect result;
+  re::Intersect overlap;
+  ASSERT_TRUE(re::sweep(s, re::Transform(IDEN_MAT, re::vec3(0.0, 0.0, 5.0)), re::vec3(0.0, 0.0, -10.0), triangle, IDEN_TRANS, 1.0, time, result)) <<
+    "should hit a triangle lying across the path";
+
+  ASSERT_LE(re::abs(time - (4.5 - triangle.shell()) / 10.0), RE_FP_TOLERANCE) <<
+    "should stop when the sphere first touches the face";
+
+  ASSERT_LE(re::length(result.normal - re::vec3(0.0, 0.0, 1.0)), RE_FP_TOLERANCE) <<
+    "should return the face normal facing the swept shape";
+
+  ASSERT_FALSE(re::sweep(s, re::Transform(IDEN_MAT, re::vec3(0.9, 0.9, 5.0)), re::vec3(0.0, 0.0, -10.0), triangle, IDEN_TRANS, 1.0, time, result)) <<
+    "should not hit a triangle which only the bounding sphere reaches";
+
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    const re::Transform start(IDEN_MAT, re::vec3::rand(4.0));
+    const re::vec3 motion = re::vec3::rand(8.0);
+    re::Transform at = start;
+
+    if (re::sweep(s, start, motion, triangle, IDEN_TRANS, 1.0, time, result)) {
+      at.v += motion * time;
+      ASSERT_TRUE(re::intersects(inflated, at, triangle, IDEN_TRANS, overlap)) <<
+        "should only report impacts which touch the triangle";
+
+      if (time > 0.0) {
+        ASSERT_FALSE(re::intersects(deflated, at, triangle, IDEN_TRANS, overlap)) <<
+          "should report the first impact";
+
+        ASSERT_LE(re::dot(result.normal, motion), RE_FP_TOLERANCE) <<
+          "should return a normal opposing the motion";
+      }
+    } else {
+      for (int j = 0; j <= 100; j++) {
+        at.v = start.v + motion * (j / 100.0);
+        ASSERT_FALSE(re::intersects(deflated, at, triangle, IDEN_TRANS, overlap)) <<
+          "should not miss impacts along the path";
+      }
+    }
+  }
+
+  ASSERT_TRUE(re::sweep(triangle, re::Transform(IDEN_MAT, re::vec3(0.0, 0.0, -5.0)), re::vec3(0.0, 0.0, 10.0), s, IDEN_TRANS, 1.0, time, result)) <<
+    "should hit a sphere with a moving triangle";
+
+  ASSERT_LE(re::abs(time - (4.5 - triangle.shell()) / 10.0), RE_FP_TOLERANCE) <<
+    "should stop when the triangle first touches the sphere";
+
+  ASSERT_LE(re::length(result.normal - re::vec3(0.0, 0.0, -1.0)), RE_FP_TOLERANCE) <<
+    "should return a normal facing the moving triangle";
+
+  const re::Plane plane(re::vec3(0.0, 0.0, 1.0), -3.0);
+  ASSERT_TRUE(re::sweep(triangle, IDEN_TRANS, re::vec3(0.0, 0.0, -10.0), plane, IDEN_TRANS, 1.0, time, result)) <<
+    "should hit a plane with a moving triangle";
+
+  ASSERT_LE(re::abs(time - 0.3), RE_FP_TOLERANCE) <<
+    "should stop when the triangle first touches the plane";
+
+  ASSERT_FALSE(re::sweep(triangle, IDEN_TRANS, re::vec3(0.0, 0.0, -10.0), triangle, re::Transform(IDEN_MAT, re::vec3(0.0, 0.0, -5.0)), 1.0, time, result)) <<
+    "should not report impacts between unsupported shapes";
+}
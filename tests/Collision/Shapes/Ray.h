@@ -12,3 +12,27 @@ TEST(Ray, Constructor_test) {
   ASSERT_LE(re::length(origin - ray.origin()), RE_FP_TOLERANCE) <<
     "should have the correct origin";
 }
+
+TEST(Ray, Interval_test) {
+  const Ray ray(re::vec3(1.0, 2.0, 3.0), re::vec3(0.0, 0.0, 2.0), 1.0, 5.0);
+
+  ASSERT_FLOAT_EQ(ray.tMin(), 1.0) <<
+    "should have the correct minimum distance";
+
+  ASSERT_FLOAT_EQ(ray.tMax(), 5.0) <<
+    "should have the correct maximum distance";
+
+  ASSERT_LE(re::length(ray.pointAt(4.0) - re::vec3(1.0, 2.0, 7.0)), RE_FP_TOLERANCE) <<
+    "should measure distances along the normalized direction";
+
+  const Ray scaled(ray, re::Transform(re::mat3(2.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 2.0), re::vec3(0.0, 0.0, 0.0)));
+  ASSERT_FLOAT_EQ(scaled.tMin(), 2.0) <<
+    "should scale the interval along with the direction when transformed";
+
+  ASSERT_FLOAT_EQ(scaled.tMax(), 10.0) <<
+    "should scale the interval along with the direction when transformed";
+
+  const Ray unbounded(re::vec3(0.0, 0.0, 0.0), re::vec3(1.0, 0.0, 0.0));
+  ASSERT_GE(unbounded.tMax(), RE_INFINITY) <<
+    "should be unbounded by default";
+}
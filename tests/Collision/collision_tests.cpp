@@ -2,6 +2,7 @@
 
 // collision module tests
 #include "BSPTree.h"
+#include "Frustum.h"
 
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,93 @@
+#include "helpers.h"
+
+#include "react/Collision/Shapes/Sphere.h"
+#include "react/Entities/Rigid.h"
+#include "react/Entities/EntityRegistry.h"
+
+TEST(EntityRegistry, AddRemoveClearActions) {
+  {
+    re::Sphere s(1.0);
+    re::Rigid a(s), b(s), c(s);
+    re::EntityRegistry registry(SHARED_ALLOCATOR);
+    
+    ASSERT_TRUE(a.handle().isNull()) <<
+      "should not have a handle before registering";
+    
+    const re::EntityHandle ha = registry.add(a);
+    const re::EntityHandle hb = registry.add(b);
+    ASSERT_FALSE(ha.isNull()) <<
+      "should never issue a null handle";
+    ASSERT_NE(ha, hb) <<
+      "should issue distinct handles";
+    ASSERT_EQ(a.handle(), ha) <<
+      "should store the handle in the entity";
+    ASSERT_EQ(registry.get(hb), &b) <<
+      "should resolve handles to their entities";
+    
+    ASSERT_TRUE(registry.remove(ha)) <<
+      "should remove registered entities";
+    ASSERT_FALSE(registry.contains(ha)) <<
+      "should invalidate handles to removed entities";
+    ASSERT_EQ(registry.get(ha), nullptr) <<
+      "should not resolve stale handles";
+    ASSERT_FALSE(registry.remove(ha)) <<
+      "should reject stale handles";
+    ASSERT_TRUE(a.handle().isNull()) <<
+      "should clear the handle of removed entities";
+    
+    const re::EntityHandle hc = registry.add(c);
+    ASSERT_EQ(hc.index(), ha.index()) <<
+      "should reuse freed slots";
+    ASSERT_NE(hc, ha) <<
+      "should advance the generation of reused slots";
+    ASSERT_EQ(registry.get(ha), nullptr) <<
+      "should not resolve stale handles to the slot's new entity";
+    ASSERT_EQ(registry.get(hc), &c) <<
+      "should resolve handles issued for reused slots";
+    
+    ASSERT_EQ(registry.size(), 2) <<
+      "should count the registered entities";
+    
+    registry.clear();
+    ASSERT_TRUE(registry.empty()) <<
+      "should remove all entities";
+    ASSERT_FALSE(registry.contains(hb)) <<
+      "should invalidate all handles when clearing";
+  }
+  
+  ASSERT_NO_MEM_LEAKS();
+}
+
+TEST(EntityRegistry, PackedIteration) {
+  {
+    re::Sphere s(1.0);
+    std::vector<re::Rigid*> bodies;
+    re::EntityRegistry registry(SHARED_ALLOCATOR);
+    
+    for (reUInt i = 0; i < NUM_SAMPLES; i++) {
+      bodies.push_back(new re::Rigid(s));
+      registry.add(*bodies.back());
+    }
+    
+    for (reUInt i = 0; i < NUM_SAMPLES; i += 2) {
+      registry.remove(bodies[i]->handle());
+    }
+    
+    reUInt count = 0;
+    for (re::Entity* entity : registry) {
+      ASSERT_EQ(registry.get(entity->handle()), entity) <<
+        "should keep handles valid as entities are moved";
+      count++;
+    }
+    
+    ASSERT_EQ(count, registry.size()) <<
+      "should iterate over the registered entities only";
+    
+    registry.clear();
+    for (re::Rigid* body : bodies) {
+      delete body;
+    }
+  }
+  
+  ASSERT_NO_MEM_LEAKS();
+}
@@ -2,6 +2,7 @@
 
 #include "react/Collision/Shapes/shapes.h"
 #include "react/Entities/Rigid.h"
+#include "react/Math/Integrator.h"
 
 TEST(Rigid, Constructor_test) {
   re::Sphere s(1.0);
@@ -36,3 +37,46 @@ TEST(Rigid, SetFacingMethod) {
   }
 }
 
+
+TEST(Rigid, CachedShapeTransform) {
+  re::Sphere s(1.0);
+  re::ShapeProxy inner(&s, re::Transform(re::mat3(2.0), re::vec3(1.0, 0.0, 0.0)));
+  re::ShapeProxy outer(&inner, re::Transform(re::mat3(1.0), re::vec3(0.0, 3.0, 0.0)));
+  re::Rigid body(outer);
+
+  ASSERT_EQ(&body.baseShape(), &s) <<
+    "should flatten all proxies down to the base shape";
+
+  body.at(1.0, 2.0, 3.0).facing(re::vec3(1.0, 0.0, 0.0), re::vec3(0.0, 0.0, 1.0));
+
+  const re::Transform expected = body.transform() * outer.transform() * inner.transform();
+  ASSERT_TRUE(re::similar(body.shapeTransform(), expected)) <<
+    "should combine the entity and proxy transforms";
+  ASSERT_TRUE(re::similar(body.shapeTransformInv(), re::inverse(expected))) <<
+    "should cache the inverse of the combined transform";
+
+  re::Integrator integrator;
+  body.movingAt(0.0, 0.0, 1.0);
+  body.advance(integrator, 1.0);
+  ASSERT_TRUE(re::similar(body.shapeTransform(), body.transform() * outer.transform() * inner.transform())) <<
+    "should update the cached transforms when the entity moves";
+}
+
+TEST(Rigid, ShapeOffset) {
+  re::Sphere s(1.0);
+  const re::RigidTransform offset(re::quat::rotation(0.5, 0.0, 1.0, 0.0), re::vec3(0.0, 2.0, 0.0));
+  re::Rigid body(s, offset);
+
+  ASSERT_EQ(&body.shape(), &s) <<
+    "should use the shape without wrapping it";
+
+  body.at(1.0, 2.0, 3.0).facing(re::vec3(1.0, 0.0, 0.0), re::vec3(0.0, 0.0, 1.0));
+
+  const re::Transform expected = body.transform() * re::toTransform(offset);
+  ASSERT_TRUE(re::similar(body.shapeTransform(), expected)) <<
+    "should combine the entity transform with the shape offset";
+  ASSERT_TRUE(re::similar(body.shapeTransformInv(), re::inverse(expected))) <<
+    "should cache the inverse of the combined transform";
+  ASSERT_TRUE(re::similar(body.center(), body.pos() + offset.v)) <<
+    "should move the center with the shape offset";
+}
@@ -2,6 +2,7 @@
 
 #include "Rigid.h"
 #include "Static.h"
+#include "EntityRegistry.h"
 
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
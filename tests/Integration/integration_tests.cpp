@@ -1,6 +1,9 @@
 #include "helpers.h"
 
 #include "test_case_1.h"
+#include "test_case_2.h"
+#include "test_case_3.h"
+#include "test_case_4.h"
 
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,60 @@
+#include "helpers.h"
+
+#include "react/react.h"
+
+TEST(Integration, TestCase_2) {
+  reWorld world;
+
+  // travels several times its own size in each time step
+  const re::vec3 vel(0.0, -600.0, 0.0);
+  re::Rigid& fast = world.build().Rigid(re::Sphere(0.5)).at(0.0, 10.0, 0.0).movingAt(vel).withContinuousCollision();
+  re::Rigid& tunneling = world.build().Rigid(re::Sphere(0.5)).at(20.0, 10.0, 0.0).movingAt(vel);
+
+  re::Static& plane = world.build().Static(re::Plane(re::vec3(0.0, 1.0, 0.0), 0.0));
+
+  const reFloat dt = 1.0/60.0;
+  world.advance(dt);
+
+  // bounces at the time of impact, and travels back up for the rest of the step
+  const reFloat impact = 9.5 / 600.0;
+  const reFloat bounce = -vel[1] * re::max(fast.restitution(), plane.restitution());
+  ASSERT_GT(fast.vel()[1], 0.0) <<
+    "should resolve the impact within the time step";
+
+  ASSERT_LE(re::abs(fast.pos()[1] - 0.5 - bounce * (dt - impact)), 1e-2) <<
+    "should integrate the rest of the time step after the impact";
+
+  ASSERT_LE(tunneling.pos()[1], 0.0) <<
+    "should let a discrete entity pass through the plane";
+
+  for (int i = 0; i < 100; i++) {
+    world.advance(1.0/60.0);
+
+    ASSERT_GE(fast.pos()[1], 0.5 - 1e-2) <<
+      "should never let a continuous entity pass through the plane";
+  }
+}
+
+TEST(Integration, TestCase_2_Triangles) {
+  reWorld world;
+
+  const re::vec3 vel(0.0, -600.0, 0.0);
+  const reTriangle triangle(re::vec3(-1.0, 0.0, -1.0), re::vec3(1.0, 0.0, -1.0), re::vec3(0.0, 0.0, 1.0));
+  re::Rigid& hit = world.build().Rigid(re::Sphere(0.5)).at(0.0, 10.0, 0.0).movingAt(vel).withContinuousCollision();
+  // passes within the triangle's bounding sphere, but clear of the triangle
+  re::Rigid& miss = world.build().Rigid(re::Sphere(0.5)).at(0.9, 10.0, 0.9).movingAt(vel).withContinuousCollision();
+
+  world.build().Static(triangle);
+
+  const reFloat dt = 1.0/60.0;
+  world.advance(dt);
+
+  ASSERT_GT(hit.vel()[1], 0.0) <<
+    "should bounce a continuous entity off a triangle in its path";
+
+  ASSERT_GE(hit.pos()[1], 0.5 - 1e-2) <<
+    "should not let a continuous entity pass through a triangle";
+
+  ASSERT_LE(re::abs(miss.pos()[1] - 10.0 - vel[1] * dt), 1e-2) <<
+    "should not stop a continuous entity which misses the triangle";
+}
@@ -0,0 +1,32 @@
+#include "helpers.h"
+
+#include "react/react.h"
+
+TEST(Integration, TestCase_3) {
+  reWorld world;
+
+  const reFloat dt = 1.0/60.0;
+  const re::vec3 gravity(0.0, -9.8, 0.0);
+  re::Rigid* stack[3];
+  for (int i = 0; i < 3; i++) {
+    stack[i] = &world.build().Rigid(re::Sphere(0.5)).at(0.0, 0.5 + i, 0.0);
+  }
+
+  world.build().Static(re::Plane(re::vec3(0.0, 1.0, 0.0), 0.0));
+
+  for (int i = 0; i < 300; i++) {
+    for (re::Rigid* sphere : stack) {
+      sphere->addImpulse(gravity * dt * sphere->mass());
+    }
+    world.advance(dt);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_LE(re::abs(stack[i]->pos()[1] - (0.5 + i)), 0.05) <<
+      "should keep the stacked spheres resting on each other";
+
+    // the solver leaves the velocity which cancels the next gravity impulse
+    ASSERT_LE(re::length(stack[i]->vel() + gravity * dt), 1e-2) <<
+      "should bring the stacked spheres to rest";
+  }
+}
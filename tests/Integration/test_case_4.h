@@ -0,0 +1,59 @@
+#include "helpers.h"
+
+#include "react/react.h"
+#include "react/Memory/reLinearAllocator.h"
+#include "react/Memory/reProxyAllocator.h"
+
+TEST(Integration, TestCase_4) {
+  reWorld world;
+  world.broadPhase().contacts().setThreads(4);
+
+  const reFloat dt = 1.0/60.0;
+  const re::vec3 gravity(0.0, -9.8, 0.0);
+  std::vector<re::Rigid*> pile;
+  std::vector<reFloat> heights;
+  for (int x = 0; x < 4; x++) {
+    for (int z = 0; z < 4; z++) {
+      for (int y = 0; y < 3; y++) {
+        // neighbouring stacks touch, so the pile forms a single island
+        pile.push_back(&world.build().Rigid(re::Sphere(0.5)).at(x * 0.99, 0.5 + y, z * 0.99));
+        heights.push_back(0.5 + y);
+      }
+    }
+  }
+
+  world.build().Static(re::Plane(re::vec3(0.0, 1.0, 0.0), 0.0));
+
+  for (int i = 0; i < 300; i++) {
+    for (re::Rigid* sphere : pile) {
+      sphere->addImpulse(gravity * dt * sphere->mass());
+    }
+    world.advance(dt);
+  }
+
+  for (reUInt i = 0; i < pile.size(); i++) {
+    const re::Rigid* sphere = pile[i];
+    ASSERT_LE(re::abs(sphere->pos()[1] - heights[i]), 0.05) <<
+      "should keep the spheres stacked when solving in parallel";
+
+    ASSERT_LE(re::length(sphere->vel() + gravity * dt), 1e-2) <<
+      "should bring the pile to rest when solving in parallel";
+  }
+
+  // once the pile is at rest, stepping should not need any more memory
+  const reBaseAllocator& general = *((reProxyAllocator&)world.allocator()).allocator();
+  const u32 reserved = general.size();
+  const u32 frame = world.frameAllocator().size();
+  for (int i = 0; i < 10; i++) {
+    for (re::Rigid* sphere : pile) {
+      sphere->addImpulse(gravity * dt * sphere->mass());
+    }
+    world.advance(dt);
+  }
+
+  ASSERT_EQ(general.size(), reserved) <<
+    "should not obtain more memory from the system in steady state";
+
+  ASSERT_EQ(world.frameAllocator().size(), frame) <<
+    "should fit each step in the frame allocator";
+}
@@ -0,0 +1,40 @@
+#include "helpers.h"
+
+TEST(RigidTransformTest, Constructor) {
+  re::RigidTransform transform;
+  
+  ASSERT_TRUE(re::similar(re::toTransform(transform), IDEN_TRANS)) <<
+    "should be the identity transform on init";
+}
+
+TEST(RigidTransformTest, Conversion) {
+  for (reUInt i = 0; i < NUM_REPEATS; i++) {
+    re::RigidTransform transform(re::quat::unit(), re::vec3::rand(50.0));
+    re::vec3 point = re::vec3::rand(10.0);
+    
+    ASSERT_TRUE(re::similar(transform.applyToPoint(point), re::toTransform(transform).applyToPoint(point))) <<
+      "should transform points in the same way as the equivalent re::Transform";
+  }
+}
+
+TEST(RigidTransformTest, Concatenation) {
+  for (reUInt i = 0; i < NUM_REPEATS; i++) {
+    re::RigidTransform A(re::quat::unit(), re::vec3::rand(10.0));
+    re::RigidTransform B(re::quat::unit(), re::vec3::rand(10.0));
+    
+    ASSERT_TRUE(re::similar(re::toTransform(A * B), re::toTransform(A) * re::toTransform(B))) <<
+      "should concatenate in the same way as the equivalent re::Transform";
+  }
+}
+
+TEST(RigidTransformTest, Inverse) {
+  for (reUInt i = 0; i < NUM_REPEATS; i++) {
+    re::RigidTransform transform(re::quat::unit(), re::vec3::rand(10.0));
+    
+    ASSERT_TRUE(re::similar(re::inverse(transform) * transform, re::RigidTransform())) <<
+      "multiplication with inverse should return the identity transform";
+    
+    ASSERT_TRUE(re::similar(re::toTransform(re::inverse(transform)), re::inverse(re::toTransform(transform)))) <<
+      "should be equal to the inverse of the equivalent re::Transform";
+  }
+}
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * Micro-benchmarks comparing the math kernels against plain scalar reference
+ * implementations. These are not run as part of the test suite, run the
+ * math_benchmarks executable directly to obtain timings.
+ */
+#include "react/math.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace {
+  const reUInt NUM_ITEMS = 1024;
+  const reUInt NUM_ROUNDS = 2000;
+
+  /** prevents the compiler from discarding the benchmarked results */
+  volatile reFloat sink = 0.0;
+
+  template <class F>
+  double measure(F func) {
+    const auto start = std::chrono::steady_clock::now();
+    for (reUInt round = 0; round < NUM_ROUNDS; round++) {
+      func();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (NUM_ROUNDS * NUM_ITEMS);
+  }
+
+  void report(const char* name, double scalar, double kernel) {
+    printf("%-28s scalar: %7.2f ns  kernel: %7.2f ns  speedup: %5.2fx\n", name, scalar, kernel, scalar / kernel);
+  }
+
+  // scalar reference implementations
+
+  void scalarMultiply(const re::mat3& a, const re::mat3& b, re::mat3& result) {
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        result[i][j] = a[i][0]*b[0][j] + a[i][1]*b[1][j] + a[i][2]*b[2][j];
+      }
+    }
+  }
+
+  void scalarApply(const re::Transform& tm, const re::vec3& p, re::vec3& result) {
+    for (int i = 0; i < 3; i++) {
+      result[i] = tm.m[i][0]*p[0] + tm.m[i][1]*p[1] + tm.m[i][2]*p[2] + tm.v[i];
+    }
+  }
+
+  void scalarInverse(const re::Transform& tm, re::Transform& result) {
+    const reFloat (&m)[9] = tm.m.e;
+    const reFloat c00 = m[4]*m[8] - m[5]*m[7];
+    const reFloat c10 = m[5]*m[6] - m[3]*m[8];
+    const reFloat c20 = m[3]*m[7] - m[4]*m[6];
+    const reFloat det = m[0]*c00 + m[1]*c10 + m[2]*c20;
+
+    result.m = re::mat3(
+      c00, m[2]*m[7] - m[1]*m[8], m[1]*m[5] - m[2]*m[4],
+      c10, m[0]*m[8] - m[2]*m[6], m[2]*m[3] - m[0]*m[5],
+      c20, m[1]*m[6] - m[0]*m[7], m[0]*m[4] - m[1]*m[3]
+    );
+    for (int i = 0; i < 9; i++) {
+      result.m.e[i] /= det;
+    }
+    for (int i = 0; i < 3; i++) {
+      result.v[i] = -(result.m[i][0]*tm.v[0] + result.m[i][1]*tm.v[1] + result.m[i][2]*tm.v[2]);
+    }
+  }
+}
+
+int main() {
+  re::mat3 matrices[NUM_ITEMS];
+  re::mat3 products[NUM_ITEMS];
+  re::Transform transforms[NUM_ITEMS];
+  re::Transform inverses[NUM_ITEMS];
+  re::vec3 points[NUM_ITEMS];
+  re::vec3 results[NUM_ITEMS];
+
+  for (reUInt i = 0; i < NUM_ITEMS; i++) {
+    matrices[i] = re::mat3::rand();
+    transforms[i] = re::Transform().rotate(re::randf(-10.0, 10.0), re::vec3::rand()).translate(re::vec3::rand(10.0));
+    points[i] = re::vec3::rand(10.0);
+  }
+
+#ifdef RE_SIMD
+  printf("math kernels: SSE\n");
+#else
+  printf("math kernels: scalar\n");
+#endif
+
+  report("mat3 multiply",
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        scalarMultiply(matrices[i], matrices[NUM_ITEMS - 1 - i], products[i]);
+      }
+      sink = sink + products[0][0][0];
+    }),
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        products[i] = matrices[i] * matrices[NUM_ITEMS - 1 - i];
+      }
+      sink = sink + products[0][0][0];
+    })
+  );
+
+  report("Transform compose",
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        const re::Transform& a = transforms[i];
+        const re::Transform& b = transforms[NUM_ITEMS - 1 - i];
+        scalarMultiply(a.m, b.m, inverses[i].m);
+        scalarApply(a, b.v, inverses[i].v);
+      }
+      sink = sink + inverses[0].v[0];
+    }),
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        inverses[i] = transforms[i] * transforms[NUM_ITEMS - 1 - i];
+      }
+      sink = sink + inverses[0].v[0];
+    })
+  );
+
+  report("Transform general inverse",
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        scalarInverse(transforms[i], inverses[i]);
+      }
+      sink = sink + inverses[0].v[0];
+    }),
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        inverses[i] = re::inverse(transforms[i]);
+      }
+      sink = sink + inverses[0].v[0];
+    })
+  );
+
+  report("Transform rigid inverse",
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        scalarInverse(transforms[i], inverses[i]);
+      }
+      sink = sink + inverses[0].v[0];
+    }),
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        inverses[i] = re::rigidInverse(transforms[i]);
+      }
+      sink = sink + inverses[0].v[0];
+    })
+  );
+
+  report("Transform applyToPoint",
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        scalarApply(transforms[i], points[i], results[i]);
+      }
+      sink = sink + results[0][0];
+    }),
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        results[i] = transforms[i].applyToPoint(points[i]);
+      }
+      sink = sink + results[0][0];
+    })
+  );
+
+  report("Transform applyToPoints",
+    measure([&]() {
+      for (reUInt i = 0; i < NUM_ITEMS; i++) {
+        scalarApply(transforms[0], points[i], results[i]);
+      }
+      sink = sink + results[0][0];
+    }),
+    measure([&]() {
+      transforms[0].applyToPoints(&points[0], &results[0], NUM_ITEMS);
+      sink = sink + results[0][0];
+    })
+  );
+
+  return 0;
+}
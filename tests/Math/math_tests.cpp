@@ -5,6 +5,7 @@
 #include "mat3x3.h"
 #include "quat.h"
 #include "reTransform.h"
+#include "RigidTransform.h"
 #include "mat4x4.h"
 #include "Integrator.h"
 
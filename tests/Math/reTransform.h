@@ -115,3 +115,28 @@ TEST(TransformTest, Inverse) {
   }
 }
 
+
+TEST(TransformTest, RigidInverse) {
+  for (reUInt i = 0; i < NUM_REPEATS; i++) {
+    re::Transform transform = re::Transform().rotate(re::randf(-1e5, 1e5), re::vec3::rand()).translate(re::vec3::rand(50.0));
+    
+    ASSERT_TRUE(re::similar(re::rigidInverse(transform), re::inverse(transform))) <<
+      "should be equal to the general inverse for rigid transforms";
+  }
+}
+
+TEST(TransformTest, BatchPointTransform) {
+  re::vec3 points[7];
+  re::vec3 results[7];
+  for (reUInt i = 0; i < 7; i++) {
+    points[i] = re::vec3::rand(5.0);
+  }
+  
+  re::Transform transform = re::Transform().translate(re::vec3::rand(5.0)).scale(re::vec3::rand(3.0)).rotate(re::randf(-1e5, 1e5), re::vec3::rand());
+  transform.applyToPoints(&points[0], &results[0], 7);
+  
+  for (reUInt i = 0; i < 7; i++) {
+    ASSERT_TRUE(re::similar(results[i], transform.applyToPoint(points[i]))) <<
+      "should be equal to transforming each point individually";
+  }
+}
@@ -0,0 +1,93 @@
+#include "helpers.h"
+
+#include "react/Memory/reFreeListAllocator.h"
+#include "react/Memory/reChunkedFreeListAllocator.h"
+
+#include <cstring>
+#include <vector>
+
+TEST(FreeListAllocator, Coalescing) {
+  alignas(16) static u8 memory[4096];
+  reFreeListAllocator allocator(sizeof(memory), memory);
+  std::vector<u8*> blocks;
+
+  // fills the memory exactly, including any remainder too small to split
+  while (true) {
+    u8* block = (u8*)allocator.tryAlloc(100, 8);
+    if (block == nullptr) {
+      break;
+    }
+    ASSERT_EQ((uptr)block % 8, 0) <<
+      "should respect the requested alignment";
+
+    memset(block, 0xAB, 100);
+    blocks.push_back(block);
+  }
+
+  ASSERT_LE(allocator.used(), sizeof(memory)) <<
+    "should never account for more memory than it manages";
+
+  // frees every other block, then the rest, in an order that merges both ways
+  for (unsigned int i = 0; i < blocks.size(); i += 2) {
+    allocator.dealloc(blocks[i]);
+  }
+  for (unsigned int i = 1; i < blocks.size(); i += 2) {
+    allocator.dealloc(blocks[i]);
+  }
+
+  ASSERT_EQ(allocator.numAllocs(), 0) <<
+    "should count every deallocation";
+
+  ASSERT_EQ(allocator.used(), 0) <<
+    "should return every byte, including those of blocks too small to split";
+
+  ASSERT_NE(allocator.alloc(sizeof(memory) - 16, 8), nullptr) <<
+    "should merge the free blocks back into one";
+}
+
+TEST(ChunkedFreeListAllocator, Growth) {
+  reChunkedFreeListAllocator allocator;
+  ASSERT_EQ(allocator.size(), 0) <<
+    "should only map memory once it is needed";
+
+  // more than a single chunk can hold
+  const u32 count = 3 * reChunkedFreeListAllocator::CHUNK_SIZE / 1024;
+  std::vector<u8*> blocks;
+  for (u32 i = 0; i < count; i++) {
+    u8* block = (u8*)allocator.alloc(1000, 16);
+    ASSERT_NE(block, nullptr) <<
+      "should map more chunks instead of running out";
+
+    ASSERT_EQ((uptr)block % 16, 0) <<
+      "should respect the requested alignment";
+
+    block[0] = i & 0xFF;
+    blocks.push_back(block);
+  }
+
+  ASSERT_GE(allocator.numChunks(), 3) <<
+    "should map more chunks instead of running out";
+
+  u8* large = (u8*)allocator.alloc(3 * reChunkedFreeListAllocator::CHUNK_SIZE, 16);
+  ASSERT_NE(large, nullptr) <<
+    "should give allocations larger than a chunk a chunk of their own";
+
+  large[3 * reChunkedFreeListAllocator::CHUNK_SIZE - 1] = 1;
+  allocator.dealloc(large);
+
+  for (u32 i = 0; i < count; i++) {
+    ASSERT_EQ(blocks[i][0], i & 0xFF) <<
+      "should never hand out overlapping blocks";
+
+    allocator.dealloc(blocks[i]);
+  }
+
+  ASSERT_EQ(allocator.numAllocs(), 0) <<
+    "should count every deallocation";
+
+  ASSERT_EQ(allocator.used(), 0) <<
+    "should count every deallocation";
+
+  ASSERT_EQ(allocator.numChunks(), 1) <<
+    "should return empty chunks to the system, keeping a single spare";
+}
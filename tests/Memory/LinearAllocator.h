@@ -0,0 +1,55 @@
+#include "helpers.h"
+
+#include "react/Memory/reLinearAllocator.h"
+
+TEST(LinearAllocator, AllocReset) {
+  reLinearAllocator allocator(SHARED_ALLOCATOR, 256);
+
+  u8* a = (u8*)allocator.alloc(10, 1);
+  u8* b = (u8*)allocator.alloc(16, 16);
+  ASSERT_EQ((uptr)b % 16, 0) <<
+    "should respect the requested alignment";
+
+  ASSERT_GE(b, a + 10) <<
+    "should never hand out overlapping blocks";
+
+  allocator.dealloc(a);
+  ASSERT_EQ(allocator.numAllocs(), 2) <<
+    "should only release memory on reset";
+
+  allocator.reset();
+  ASSERT_EQ(allocator.numAllocs(), 0) <<
+    "should release every allocation on reset";
+
+  ASSERT_EQ(allocator.used(), 0) <<
+    "should release every allocation on reset";
+
+  ASSERT_EQ(allocator.alloc(10, 1), a) <<
+    "should reuse the buffer after a reset";
+}
+
+TEST(LinearAllocator, Overflow) {
+  reLinearAllocator allocator(SHARED_ALLOCATOR, 256);
+
+  for (int i = 0; i < 100; i++) {
+    u32* block = (u32*)allocator.alloc(32, 4);
+    ASSERT_NE(block, nullptr) <<
+      "should take overflow pages from the backing allocator";
+
+    *block = i;
+  }
+
+  ASSERT_EQ(allocator.used(), 100 * 32) <<
+    "should count the memory in overflow pages";
+
+  allocator.reset();
+  ASSERT_GE(allocator.size(), 100 * 32) <<
+    "should grow the buffer to the peak usage on reset";
+
+  u8* start = (u8*)allocator.ptr();
+  for (int i = 0; i < 100; i++) {
+    u8* block = (u8*)allocator.alloc(32, 4);
+    ASSERT_TRUE(block >= start && block + 32 <= start + allocator.size()) <<
+      "should fit the same workload in the grown buffer";
+  }
+}
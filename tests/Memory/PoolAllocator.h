@@ -0,0 +1,80 @@
+#include "helpers.h"
+
+#include "react/Memory/rePoolAllocator.h"
+
+#include <cstring>
+#include <vector>
+
+TEST(PoolAllocator, AllocDealloc) {
+  rePoolAllocator allocator;
+  std::vector<u8*> blocks;
+
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    const u32 size = 1 + i % 3000;
+    u8* block = (u8*)allocator.alloc(size, 8);
+    ASSERT_NE(block, nullptr) <<
+      "should allocate blocks of any size";
+
+    ASSERT_EQ((uptr)block % 8, 0) <<
+      "should respect the requested alignment";
+
+    memset(block, i & 0xFF, size);
+    blocks.push_back(block);
+  }
+
+  ASSERT_EQ(allocator.numAllocs(), NUM_SAMPLES) <<
+    "should count every allocation";
+
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    const u32 size = 1 + i % 3000;
+    ASSERT_EQ(blocks[i][0], i & 0xFF) <<
+      "should never hand out overlapping blocks";
+    ASSERT_EQ(blocks[i][size - 1], i & 0xFF) <<
+      "should never hand out overlapping blocks";
+  }
+
+  for (u8* block : blocks) {
+    allocator.dealloc(block);
+  }
+
+  ASSERT_EQ(allocator.numAllocs(), 0) <<
+    "should count every deallocation";
+
+  ASSERT_EQ(allocator.used(), 0) <<
+    "should return all memory once every block is freed";
+}
+
+TEST(PoolAllocator, Reuse) {
+  rePoolAllocator allocator;
+
+  void* a = allocator.alloc(40, 8);
+  allocator.dealloc(a);
+  void* b = allocator.alloc(48, 8);
+  ASSERT_EQ(a, b) <<
+    "should reuse freed blocks of the same size class";
+
+  const u32 reserved = allocator.size();
+  std::vector<void*> blocks;
+  for (int i = 0; i < 100; i++) {
+    blocks.push_back(allocator.alloc(32, 8));
+  }
+  for (void* block : blocks) {
+    allocator.dealloc(block);
+  }
+  for (int i = 0; i < 100; i++) {
+    blocks[i] = allocator.alloc(32, 8);
+  }
+  for (void* block : blocks) {
+    allocator.dealloc(block);
+  }
+
+  ASSERT_EQ(allocator.size(), reserved + rePoolAllocator::CHUNK_SIZE) <<
+    "should only obtain a new chunk for a size class once its blocks run out";
+
+  void* aligned = allocator.alloc(64, 64);
+  ASSERT_EQ((uptr)aligned % 64, 0) <<
+    "should respect alignments larger than the block alignment";
+
+  allocator.dealloc(aligned);
+  allocator.dealloc(b);
+}
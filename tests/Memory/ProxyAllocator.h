@@ -0,0 +1,89 @@
+#include "helpers.h"
+
+#include "react/react.h"
+#include "react/Memory/rePoolAllocator.h"
+#include "react/Memory/reTaggedAllocator.h"
+
+TEST(ProxyAllocator, Tags) {
+  rePoolAllocator pool;
+  reProxyAllocator proxy(&pool);
+  reTaggedAllocator shapes(proxy, re::MEMORY_SHAPES);
+
+  void* a = proxy.alloc(100, 8);
+  void* b = shapes.alloc(200, 32);
+  void* c = shapes.alloc(300, 4);
+  ASSERT_EQ((uptr)b % 32, 0) <<
+    "should respect the requested alignment";
+
+  re::MemoryStats stats = proxy.stats();
+  ASSERT_EQ(stats.tags[re::MEMORY_GENERAL].used, 100) <<
+    "should account untagged allocations to the general tag";
+
+  ASSERT_EQ(stats.tags[re::MEMORY_SHAPES].used, 500) <<
+    "should account the requested bytes to the tag";
+
+  ASSERT_EQ(stats.tags[re::MEMORY_SHAPES].numAllocs, 2) <<
+    "should count the live allocations of the tag";
+
+  ASSERT_EQ(stats.requested, 600) <<
+    "should sum the requested bytes over all tags";
+
+  ASSERT_GE(stats.used, stats.requested) <<
+    "should include rounding and headers in the used bytes";
+
+  ASSERT_GT(stats.internalFragmentation(), 0.0f) <<
+    "should measure the memory lost to rounding and headers";
+
+  // tags are kept with the allocation, so any view may release it
+  proxy.dealloc(b);
+  shapes.dealloc(a);
+
+  stats = proxy.stats();
+  ASSERT_EQ(stats.tags[re::MEMORY_SHAPES].used, 300) <<
+    "should release the bytes from the allocation's own tag";
+
+  ASSERT_EQ(stats.tags[re::MEMORY_SHAPES].peak, 500) <<
+    "should keep the high water mark of the tag";
+
+  ASSERT_EQ(stats.tags[re::MEMORY_GENERAL].totalFrees, 1) <<
+    "should count every deallocation of the tag";
+
+  shapes.dealloc(c);
+}
+
+TEST(ProxyAllocator, WorldStats) {
+  reWorld world;
+  for (int i = 0; i < 10; i++) {
+    world.build().Rigid(re::Sphere(1.0)).at(0.0, 3.0 * i, 0.0);
+  }
+  world.build().Static(re::Plane(re::vec3(0.0, 1.0, 0.0), 0.0));
+
+  re::MemoryStats stats = world.memoryStats();
+  ASSERT_GT(stats.tags[re::MEMORY_ENTITIES].numAllocs, 10) <<
+    "should account the entities to their own tag";
+
+  ASSERT_GT(stats.tags[re::MEMORY_SHAPES].used, 0) <<
+    "should account the shapes to their own tag";
+
+  ASSERT_GT(stats.tags[re::MEMORY_BROAD_PHASE].used, 0) <<
+    "should account the broad phase structure to its own tag";
+
+  for (int i = 0; i < 10; i++) {
+    world.advance(1.0 / 60.0);
+  }
+
+  stats = world.memoryStats();
+  ASSERT_GT(stats.tags[re::MEMORY_FRAME].used, 0) <<
+    "should account the frame allocator to its own tag";
+
+  ASSERT_GE(stats.reserved, stats.used) <<
+    "should never use more memory than was reserved";
+
+  world.clear();
+  stats = world.memoryStats();
+  ASSERT_EQ(stats.tags[re::MEMORY_ENTITIES].used, 0) <<
+    "should release the memory of every entity";
+
+  ASSERT_GE(stats.tags[re::MEMORY_ENTITIES].peak, 10 * sizeof(re::Rigid)) <<
+    "should keep the high water mark after the entities are released";
+}
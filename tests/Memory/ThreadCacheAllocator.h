@@ -0,0 +1,89 @@
+#include "helpers.h"
+
+#include "react/Memory/reThreadCacheAllocator.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+  void wait(std::atomic<int>& barrier, int count) {
+    barrier++;
+    while (barrier.load() < count) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+TEST(ThreadCacheAllocator, AllocDealloc) {
+  reThreadCacheAllocator allocator;
+  std::vector<void*> blocks;
+
+  for (int i = 0; i < 100; i++) {
+    blocks.push_back(allocator.alloc(1 + i * 40, 8));
+  }
+
+  ASSERT_EQ(allocator.numAllocs(), 100) <<
+    "should count every allocation";
+
+  for (void* block : blocks) {
+    allocator.dealloc(block);
+  }
+
+  ASSERT_EQ(allocator.numAllocs(), 0) <<
+    "should return blocks freed by the same thread immediately";
+
+  ASSERT_EQ(allocator.used(), 0) <<
+    "should return blocks freed by the same thread immediately";
+}
+
+TEST(ThreadCacheAllocator, CrossThreadFrees) {
+  const int NUM_THREADS = 4;
+  const int NUM_BLOCKS = 1000;
+  reThreadCacheAllocator allocator;
+  std::vector<u8*> blocks[NUM_THREADS];
+  std::atomic<int> allocated(0);
+  std::atomic<int> freed(0);
+  std::atomic<int> overlaps(0);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < NUM_THREADS; t++) {
+    threads.push_back(std::thread([&, t]() {
+      for (int i = 0; i < NUM_BLOCKS; i++) {
+        const u32 size = 1 + (i * 37) % 512;
+        u8* block = (u8*)allocator.alloc(size, 8);
+        memset(block, t, size);
+        blocks[t].push_back(block);
+      }
+      wait(allocated, NUM_THREADS);
+
+      // frees the blocks allocated by the next thread
+      const int other = (t + 1) % NUM_THREADS;
+      for (int i = 0; i < NUM_BLOCKS; i++) {
+        if (blocks[other][i][0] != other) {
+          overlaps++;
+        }
+        allocator.dealloc(blocks[other][i]);
+      }
+      allocator.flush();
+      wait(freed, NUM_THREADS);
+
+      // collects the blocks handed back by the other threads
+      allocator.flush();
+    }));
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(overlaps.load(), 0) <<
+    "should never hand out the same block to two threads";
+
+  ASSERT_EQ(allocator.numAllocs(), 0) <<
+    "should return every block freed by another thread to its owner";
+
+  ASSERT_EQ(allocator.used(), 0) <<
+    "should return every block freed by another thread to its owner";
+}
@@ -0,0 +1,12 @@
+#include "helpers.h"
+
+#include "FreeListAllocator.h"
+#include "LinearAllocator.h"
+#include "PoolAllocator.h"
+#include "ProxyAllocator.h"
+#include "ThreadCacheAllocator.h"
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
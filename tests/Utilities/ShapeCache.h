@@ -0,0 +1,114 @@
+#include "helpers.h"
+
+#include "react/Utilities/ShapeCache.h"
+
+#include "react/Collision/Shapes/shapes.h"
+
+TEST(ShapeCache, instance_test) {
+  {
+    re::ShapeCache cache(SHARED_ALLOCATOR);
+
+    const reShape& a = cache.instance(re::Sphere(1.0));
+    const reShape& b = cache.instance(re::Sphere(1.0));
+    const reShape& c = cache.instance(re::Sphere(2.0));
+
+    ASSERT_EQ(&a, &b) <<
+      "should share shapes which are equal in value";
+
+    ASSERT_NE(&a, &c) <<
+      "should not share shapes with different values";
+
+    ASSERT_EQ(cache.size(), 2) <<
+      "should only contain unique shapes";
+
+    ASSERT_EQ(a.references(), 3) <<
+      "should hold a reference for the cache and each owner";
+
+    cache.release(a);
+    cache.release(b);
+    cache.purge();
+
+    ASSERT_EQ(cache.size(), 1) <<
+      "should destroy shapes which are no longer shared when purged";
+
+    cache.release(c);
+  }
+
+  ASSERT_NO_MEM_LEAKS();
+}
+
+TEST(ShapeCache, transformed_instance_test) {
+  {
+    re::ShapeCache cache(SHARED_ALLOCATOR);
+
+    const reShape& base = cache.instance(re::Sphere(1.0));
+
+    ASSERT_EQ(&cache.instance(re::Sphere(1.0), re::Transform()), &base) <<
+      "should not create a proxy for the identity transform";
+
+    const reShape& scaled = cache.instance(re::Sphere(1.0), re::Transform().scale(2.0, 2.0, 2.0).rotate(1.3, 0.0, 1.0, 0.0));
+    ASSERT_EQ(scaled.type(), reShape::SPHERE) <<
+      "should absorb uniform scaling into the sphere";
+
+    ASSERT_FLOAT_EQ(((const re::Sphere&)scaled).radius(), 2.0) <<
+      "should scale the sphere radius";
+
+    const reShape& proxy = cache.instance(re::Sphere(1.0), re::Transform().scale(1.0, 2.0, 3.0));
+    ASSERT_EQ(proxy.type(), reShape::PROXY) <<
+      "should wrap shapes when the transform cannot be absorbed";
+
+    ASSERT_EQ(((const re::ShapeProxy&)proxy).shape(), &base) <<
+      "should share the base shape between proxies";
+
+    const reShape& repeated = cache.instance(re::Sphere(1.0), re::Transform().scale(1.0, 2.0, 3.0));
+    ASSERT_EQ(&repeated, &proxy) <<
+      "should share proxies with equal shapes and transforms";
+    cache.release(repeated);
+
+    re::Sphere sphere(1.0);
+    re::ShapeProxy inner(&sphere, re::Transform().scale(1.0, 2.0, 1.0));
+    re::ShapeProxy outer(&inner, re::Transform().scale(1.0, 1.0, 3.0));
+    const reShape& flattened = cache.instance(outer);
+    ASSERT_EQ(((const re::ShapeProxy&)flattened).shape(), &base) <<
+      "should collapse nested proxies into a single proxy";
+
+    ASSERT_TRUE(re::similar(((const re::ShapeProxy&)flattened).transform(), outer.transform() * inner.transform())) <<
+      "should combine the transforms of nested proxies";
+
+    cache.release(flattened);
+    cache.release(proxy);
+    cache.release(scaled);
+    cache.release(base);
+    cache.release(base);
+  }
+
+  ASSERT_NO_MEM_LEAKS();
+}
+
+TEST(ShapeCache, copy_test) {
+  {
+    re::ShapeCache cache(SHARED_ALLOCATOR);
+
+    const reShape& shared = cache.instance(re::Sphere(1.0));
+    re::Sphere copy((const re::Sphere&)shared);
+
+    ASSERT_EQ(copy.references(), 0) <<
+      "should not copy the reference count of a shared shape";
+
+    re::Sphere assigned(2.0);
+    assigned.retain();
+    assigned = (const re::Sphere&)shared;
+
+    ASSERT_EQ(assigned.references(), 1) <<
+      "should keep the reference count of the shape assigned to";
+
+    reShape* unshared = cache.copyOf(shared);
+    ASSERT_EQ(unshared->references(), 0) <<
+      "should create unowned copies of shared shapes";
+
+    cache.release(*unshared);
+    cache.release(shared);
+  }
+
+  ASSERT_NO_MEM_LEAKS();
+}
@@ -0,0 +1,411 @@
+#include "helpers.h"
+
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "react/reWorld.h"
+#include "react/Utilities/Snapshot.h"
+#include "react/Entities/Rigid.h"
+#include "react/Entities/Static.h"
+#include "react/Collision/reBroadPhase.h"
+#include "react/Collision/Shapes/shapes.h"
+#include "react/Utilities/ShapeCache.h"
+
+namespace {
+  /** A shape without a snapshot record format */
+  struct Box : public reShape {
+    Type type() const override { return reShape::RECTANGLE; }
+    reUInt numVerts() const override { return 0; }
+    const re::vec3 vert(reUInt) const override { return re::vec3(0.0, 0.0, 0.0); }
+    reFloat volume() const override { return 1.0; }
+    const re::mat3 computeInertia() const override { return re::mat3(1.0); }
+    const re::vec3 randomPoint() const override { return re::vec3(0.0, 0.0, 0.0); }
+    bool containsPoint(const re::vec3&) const override { return false; }
+  };
+  
+  void populate(reWorld& world) {
+    re::Transform stretch;
+    stretch.scale(1.0, 2.0, 1.0);
+    
+    for (reUInt i = 0; i < 200; i++) {
+      re::Entity* entity;
+      if (i % 10 == 0) {
+        entity = &world.build().Static(re::Sphere(2.0));
+      } else if (i % 3 == 0) {
+        entity = &world.build().Rigid(re::Sphere(1.0), stretch).withMass(3.0);
+      } else {
+        entity = &world.build().Rigid(re::Sphere(1.0)).withFriction(0.1);
+      }
+      entity->setPos(re::vec3::rand(50.0));
+      entity->setVel(re::vec3::rand(5.0));
+      entity->setFacing(re::normalize(re::vec3::rand(1.0)), re::vec3(0.0, 0.0, 1.0));
+    }
+    
+    world.build().GravAction(*world.entities()[1], *world.entities()[2]);
+    world.broadPhase().rebalance();
+  }
+  
+  std::vector<re::vec3> positions(const reWorld& world) {
+    std::vector<re::vec3> result;
+    for (const re::Entity* entity : world.entities()) {
+      result.push_back(entity->pos());
+    }
+    return result;
+  }
+}
+
+TEST(Snapshot, RestoreInMemory) {
+  reWorld world;
+  populate(world);
+  
+  const reUInt size = world.snapshot(nullptr, 0);
+  ASSERT_GT(size, sizeof(re::SnapshotHeader)) <<
+    "should report the size needed when the buffer is too small";
+  
+  std::vector<reFloat> buffer(size / sizeof(reFloat) + 1);
+  ASSERT_EQ(world.snapshot(buffer.data(), size), size) <<
+    "should write the snapshot when the buffer is large enough";
+  
+  const re::SnapshotHeader& header = *(const re::SnapshotHeader*)buffer.data();
+  ASSERT_EQ(header.numEntities, 200) <<
+    "should record every entity";
+  ASSERT_EQ(header.numInteractions, 1) <<
+    "should record the built in interactions";
+  ASSERT_EQ(header.numShapes, world.shapes().size()) <<
+    "should record each shared shape and proxy once";
+  
+  const std::vector<re::vec3> saved = positions(world);
+  const reBPMeasure layout = world.broadPhase().measure();
+  
+  for (reUInt i = 0; i < 10; i++) {
+    world.advance(1.0 / 60.0);
+  }
+  
+  ASSERT_TRUE(world.restore(buffer.data(), size)) <<
+    "should accept its own snapshot";
+  
+  ASSERT_EQ(world.entities().size(), 200) <<
+    "should restore every entity";
+  
+  const std::vector<re::vec3> restored = positions(world);
+  for (reUInt i = 0; i < saved.size(); i++) {
+    for (reUInt j = 0; j < 3; j++) {
+      ASSERT_EQ(saved[i][j], restored[i][j]) <<
+        "should restore the positions exactly";
+    }
+  }
+  
+  const re::Entity& heavy = *world.entities()[3];
+  ASSERT_NEAR(heavy.mass(), 3.0, RE_FP_TOLERANCE) <<
+    "should restore the material properties";
+  ASSERT_EQ(heavy.shape().type(), reShape::PROXY) <<
+    "should restore transformed shapes";
+  ASSERT_EQ(world.entities()[0]->type(), re::Entity::STATIC) <<
+    "should restore the type of each entity";
+  
+  const reBPMeasure after = world.broadPhase().measure();
+  ASSERT_EQ(after.children, layout.children) <<
+    "should restore the broad phase layout";
+  ASSERT_EQ(after.leafs, layout.leafs) <<
+    "should restore the broad phase layout";
+  ASSERT_EQ(after.references, layout.references) <<
+    "should place the entities into the same nodes";
+  
+  for (reUInt i = 0; i < 10; i++) {
+    world.advance(1.0 / 60.0);
+  }
+}
+
+TEST(Snapshot, ReplaysAfterRestore) {
+  reWorld world;
+  re::Entity& a = world.build().Rigid(re::Sphere(1.0)).withRestitution(0.5);
+  re::Entity& b = world.build().Rigid(re::Sphere(1.0)).withMass(2.0);
+  re::Entity& c = world.build().Rigid(re::Sphere(1.0));
+  re::Entity& d = world.build().Rigid(re::Sphere(1.0));
+  a.setPos(-5.0, 0.0, 0.0);
+  a.setVel(4.0, 0.0, 0.0);
+  b.setPos(5.0, 0.5, 0.0);
+  b.setVel(-4.0, 0.0, 0.0);
+  b.setAngVel(0.0, 0.0, 1.0);
+  c.setPos(0.0, 100.0, 0.0);
+  d.setPos(0.0, 110.0, 0.0);
+  world.build().GravAction(c, d);
+  
+  for (reUInt i = 0; i < 10; i++) {
+    world.advance(1.0 / 60.0);
+  }
+  
+  const reUInt size = world.snapshot(nullptr, 0);
+  std::vector<reFloat> buffer(size / sizeof(reFloat) + 1);
+  world.snapshot(buffer.data(), size);
+  const re::EntityHandle handle = a.handle();
+  
+  // the spheres meet after the snapshot, so the replay resolves the impact
+  for (reUInt i = 0; i < 120; i++) {
+    world.advance(1.0 / 60.0);
+  }
+  
+  std::vector<re::vec3> expected;
+  for (const re::Entity* entity : world.entities()) {
+    expected.push_back(entity->pos());
+    expected.push_back(entity->vel());
+    expected.push_back(entity->angVel());
+  }
+  ASSERT_LT(expected[1][0], 0.0) <<
+    "should have bounced the spheres apart";
+  
+  ASSERT_TRUE(world.restore(buffer.data(), size));
+  ASSERT_EQ(world.entity(handle), nullptr) <<
+    "should invalidate the handles issued before restoring";
+  
+  for (reUInt i = 0; i < 120; i++) {
+    world.advance(1.0 / 60.0);
+  }
+  
+  ASSERT_EQ(world.entities().size() * 3, expected.size());
+  for (reUInt i = 0; i < world.entities().size(); i++) {
+    const re::Entity& entity = *world.entities()[i];
+    ASSERT_TRUE(re::similar(entity.pos(), expected[3 * i])) <<
+      "should replay the same positions after restoring";
+    ASSERT_TRUE(re::similar(entity.vel(), expected[3 * i + 1])) <<
+      "should replay the same velocities after restoring";
+    ASSERT_TRUE(re::similar(entity.angVel(), expected[3 * i + 2])) <<
+      "should replay the same angular velocities after restoring";
+  }
+}
+
+TEST(Snapshot, RestoresShapeOffsets) {
+  reWorld world;
+  const re::Transform placement = re::Transform().rotate(0.3, 1.0, 0.0, 0.0).translate(0.0, 0.0, 2.0);
+  re::Rigid& body = world.build().Rigid(re::Sphere(1.0), placement);
+  body.setPos(1.0, 2.0, 3.0);
+  const re::Transform expected = body.shapeTransform();
+  
+  const reUInt size = world.snapshot(nullptr, 0);
+  std::vector<reFloat> buffer(size / sizeof(reFloat) + 1);
+  world.snapshot(buffer.data(), size);
+  ASSERT_TRUE(world.restore(buffer.data(), size));
+  
+  ASSERT_TRUE(re::similar(world.entities()[0]->shapeTransform(), expected)) <<
+    "should restore the placement of the shape on the entity";
+}
+
+TEST(Snapshot, RejectsIncompatibleSnapshots) {
+  reWorld world;
+  populate(world);
+  
+  const reUInt size = world.snapshot(nullptr, 0);
+  std::vector<reFloat> buffer(size / sizeof(reFloat) + 1);
+  world.snapshot(buffer.data(), size);
+  
+  re::SnapshotHeader& header = *(re::SnapshotHeader*)buffer.data();
+  header.version++;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject snapshots of other versions";
+  header.version--;
+  
+  ASSERT_FALSE(world.restore(buffer.data(), size - 1)) <<
+    "should reject truncated snapshots";
+  
+  re::EntityRecord* entities = (re::EntityRecord*)((re::ShapeRecord*)(&header + 1) + header.numShapes);
+  entities[5].shape = header.numShapes;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject snapshots with invalid references";
+  
+  ASSERT_EQ(world.entities().size(), 200) <<
+    "should leave the world unchanged when rejecting a snapshot";
+}
+
+TEST(Snapshot, RejectsDamagedNumbers) {
+  reWorld world;
+  populate(world);
+  
+  const reUInt size = world.snapshot(nullptr, 0);
+  std::vector<reFloat> buffer(size / sizeof(reFloat) + 1);
+  world.snapshot(buffer.data(), size);
+  
+  re::SnapshotHeader& header = *(re::SnapshotHeader*)buffer.data();
+  re::ShapeRecord* shapes = (re::ShapeRecord*)(&header + 1);
+  re::EntityRecord* entities = (re::EntityRecord*)(shapes + header.numShapes);
+  re::EntityRecord& rigid = entities[1];
+  ASSERT_EQ(rigid.type, re::Entity::RIGID);
+  
+  const reFloat x = rigid.pos[0];
+  rigid.pos[0] = std::numeric_limits<reFloat>::quiet_NaN();
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject snapshots with NaN positions";
+  rigid.pos[0] = std::numeric_limits<reFloat>::infinity();
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject snapshots with infinite positions";
+  rigid.pos[0] = x;
+  
+  const reFloat massInv = rigid.massInv;
+  rigid.massInv = 0.0;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject rigid entities without a finite mass";
+  rigid.massInv = -massInv;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject rigid entities with a negative mass";
+  rigid.massInv = massInv;
+  
+  const reFloat w = rigid.orient[0];
+  const reFloat i = rigid.orient[1];
+  const reFloat j = rigid.orient[2];
+  const reFloat k = rigid.orient[3];
+  rigid.orient[0] = rigid.orient[1] = rigid.orient[2] = rigid.orient[3] = 0.0;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject entities without an orientation";
+  rigid.orient[0] = w;
+  rigid.orient[1] = i;
+  rigid.orient[2] = j;
+  rigid.orient[3] = k;
+  
+  reUInt sphere = 0;
+  while (shapes[sphere].type != reShape::SPHERE) {
+    sphere++;
+  }
+  const reFloat radius = shapes[sphere].data[0];
+  shapes[sphere].data[0] = -radius;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject spheres with a negative radius";
+  shapes[sphere].data[0] = radius;
+  
+  ASSERT_EQ(world.entities().size(), 200) <<
+    "should leave the world unchanged when rejecting a snapshot";
+  ASSERT_TRUE(world.restore(buffer.data(), size)) <<
+    "should accept the snapshot once repaired";
+}
+
+TEST(Snapshot, RejectsDamagedLayouts) {
+  reWorld world;
+  populate(world);
+  
+  const reUInt size = world.snapshot(nullptr, 0);
+  std::vector<reFloat> buffer(size / sizeof(reFloat) + 1);
+  world.snapshot(buffer.data(), size);
+  
+  re::SnapshotHeader& header = *(re::SnapshotHeader*)buffer.data();
+  ASSERT_GT(header.numSplits, 1) <<
+    "should have a layout to damage";
+  reBPSplit* splits = (reBPSplit*)((char*)buffer.data() + size - header.numSplits * sizeof(reBPSplit));
+  reBPSplit& last = splits[header.numSplits - 1];
+  ASSERT_EQ(last.children, 0);
+  
+  last.children = 1;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject layouts which end early";
+  last.children = 0;
+  
+  splits[0].children = 0;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject layouts with records left over";
+  splits[0].children = 1;
+  
+  const reFloat normal[3] = { splits[0].normal[0], splits[0].normal[1], splits[0].normal[2] };
+  splits[0].normal[0] = splits[0].normal[1] = splits[0].normal[2] = 0.0;
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject split planes without a normal";
+  splits[0].normal[0] = std::numeric_limits<reFloat>::quiet_NaN();
+  ASSERT_FALSE(world.restore(buffer.data(), size)) <<
+    "should reject split planes with NaN normals";
+  for (reUInt i = 0; i < 3; i++) {
+    splits[0].normal[i] = normal[i];
+  }
+  
+  ASSERT_EQ(world.entities().size(), 200) <<
+    "should leave the world unchanged when rejecting a snapshot";
+  ASSERT_TRUE(world.restore(buffer.data(), size)) <<
+    "should accept the snapshot once repaired";
+}
+
+TEST(Snapshot, RejectsDeepLayouts) {
+  reWorld world;
+  
+  // a chain of nodes, each with a leaf in front and the rest of the chain behind
+  const auto chain = [](reUInt depth) {
+    const reUInt numSplits = 2 * depth + 1;
+    const reUInt size = sizeof(re::SnapshotHeader) + numSplits * sizeof(reBPSplit);
+    std::vector<reFloat> buffer(size / sizeof(reFloat) + 1);
+    reWorld empty;
+    empty.snapshot(buffer.data(), empty.snapshot(nullptr, 0));
+    
+    re::SnapshotHeader& header = *(re::SnapshotHeader*)buffer.data();
+    header.size = size;
+    header.numSplits = numSplits;
+    reBPSplit* splits = (reBPSplit*)(&header + 1);
+    for (reUInt i = 0; i < numSplits; i++) {
+      splits[i] = { { 1.0, 0.0, 0.0 }, 0.0, (i % 2 == 0 && i + 1 < numSplits) ? 1u : 0u, 0 };
+    }
+    return buffer;
+  };
+  
+  std::vector<reFloat> shallow = chain(reBPSplit::MAX_DEPTH);
+  ASSERT_TRUE(world.restore(shallow.data(), ((re::SnapshotHeader*)shallow.data())->size)) <<
+    "should accept layouts as deep as the limit";
+  ASSERT_EQ(world.broadPhase().measure().children, 2 * reBPSplit::MAX_DEPTH) <<
+    "should restore every node of the layout";
+  
+  std::vector<reFloat> deep = chain(reBPSplit::MAX_DEPTH + 1);
+  ASSERT_FALSE(world.restore(deep.data(), ((re::SnapshotHeader*)deep.data())->size)) <<
+    "should reject layouts deeper than the limit";
+  
+  std::vector<reFloat> hostile = chain(1000000);
+  ASSERT_FALSE(world.restore(hostile.data(), ((re::SnapshotHeader*)hostile.data())->size)) <<
+    "should reject very deep layouts without recursing through them";
+  
+  const reBPSplit* splits = (const reBPSplit*)((re::SnapshotHeader*)hostile.data() + 1);
+  ASSERT_FALSE(world.broadPhase().setLayout(splits, 2 * 1000000 + 1)) <<
+    "should bound the depth when the broad phase reads a layout directly";
+  ASSERT_EQ(world.broadPhase().measure().children, 0) <<
+    "should discard a layout which is too deep";
+}
+
+TEST(Snapshot, RefusesUnwritableShapes) {
+  reWorld world;
+  world.build().Rigid(re::Sphere(1.0));
+  const reShape& box = *world.allocator().alloc_new<Box>();
+  world.add(*world.allocator(re::MEMORY_ENTITIES).alloc_new<re::Rigid>(box));
+  
+  ASSERT_EQ(world.snapshot(nullptr, 0), 0) <<
+    "should not report a size for worlds it can not describe";
+  
+  std::vector<reFloat> buffer(1024);
+  ASSERT_EQ(world.snapshot(buffer.data(), buffer.size() * sizeof(reFloat)), 0) <<
+    "should not write snapshots which could never be restored";
+  
+  ASSERT_FALSE(world.save("unwritable_snapshot.bin")) <<
+    "should fail to save worlds it can not describe";
+  ASSERT_EQ(fopen("unwritable_snapshot.bin", "rb"), nullptr) <<
+    "should not create a file for worlds it can not describe";
+}
+
+TEST(Snapshot, SaveAndLoadFile) {
+  const char* path = "snapshot_test.bin";
+  std::vector<re::vec3> saved;
+  
+  {
+    reWorld world;
+    populate(world);
+    saved = positions(world);
+    ASSERT_TRUE(world.save(path)) <<
+      "should write the snapshot to a file";
+  }
+  
+  reWorld world;
+  ASSERT_TRUE(world.load(path)) <<
+    "should load the snapshot from the file";
+  
+  ASSERT_EQ(world.entities().size(), saved.size()) <<
+    "should restore every entity from the file";
+  
+  for (reUInt i = 0; i < saved.size(); i++) {
+    ASSERT_TRUE(re::similar(saved[i], world.entities()[i]->pos())) <<
+      "should restore the positions from the file";
+  }
+  
+  ASSERT_FALSE(world.load("missing_snapshot.bin")) <<
+    "should fail to load missing files";
+  
+  std::remove(path);
+}
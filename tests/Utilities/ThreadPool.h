@@ -0,0 +1,37 @@
+#include "helpers.h"
+
+#include "react/Utilities/ThreadPool.h"
+
+#include <atomic>
+
+TEST(ThreadPool, run_test) {
+  const reUInt NUM_ITEMS = 1000;
+  std::atomic<reUInt> visits[NUM_ITEMS];
+  for (reUInt i = 0; i < NUM_ITEMS; i++) {
+    visits[i] = 0;
+  }
+
+  re::ThreadPool pool(4);
+  ASSERT_EQ(pool.size(), 4) <<
+    "should count the calling thread as part of the pool";
+
+  for (reUInt round = 0; round < 50; round++) {
+    pool.run(NUM_ITEMS, [&visits](reUInt i) {
+      visits[i]++;
+    });
+
+    for (reUInt i = 0; i < NUM_ITEMS; i++) {
+      ASSERT_EQ(visits[i].load(), round + 1) <<
+        "should run every item exactly once before returning";
+    }
+  }
+
+  re::ThreadPool serial(1);
+  reUInt sum = 0;
+  serial.run(10, [&sum](reUInt i) {
+    sum += i;
+  });
+
+  ASSERT_EQ(sum, 45) <<
+    "should run all items on the calling thread when there are no workers";
+}
@@ -0,0 +1,109 @@
+#include "helpers.h"
+
+#include "react/Utilities/reDenseArray.h"
+
+TEST(reDenseArray, AddRemoveClearActions) {
+  {
+    reDenseArray<int> array(SHARED_ALLOCATOR);
+    ASSERT_EQ(array.size(), 0) <<
+      "should have an initial size of zero";
+    
+    for (int i = 0; i < 1000; i++) {
+      ASSERT_EQ(array.add(i), (reUInt)i) <<
+        "should return the index of the added element";
+    }
+    
+    ASSERT_EQ(array.size(), 1000) <<
+      "should have a size reflecting all current elements";
+    
+    array.removeAt(10);
+    ASSERT_EQ(array[10], 999) <<
+      "should move the last element into the gap";
+    
+    ASSERT_TRUE(array.remove(500)) <<
+      "should be able to remove contained elements";
+    
+    ASSERT_FALSE(array.contains(500)) <<
+      "should no longer contain removed elements";
+    
+    ASSERT_FALSE(array.remove(-1)) <<
+      "should not remove elements which are not contained";
+    
+    ASSERT_EQ(array.size(), 998) <<
+      "should have decreased in size when removing elements";
+    
+    int sum = 0;
+    for (int i : array) {
+      sum += i;
+    }
+    ASSERT_EQ(sum, 999 * 1000 / 2 - 10 - 500) <<
+      "should be able to iterate over the remaining contents";
+    
+    const reUInt capacity = array.capacity();
+    array.clear();
+    ASSERT_EQ(array.size(), 0) <<
+      "should remove all elements";
+    
+    ASSERT_EQ(array.capacity(), capacity) <<
+      "should keep the memory for reuse when cleared";
+    
+    array.shrink();
+    ASSERT_EQ(array.capacity(), 0) <<
+      "should release the memory once shrunk";
+  }
+  
+  ASSERT_NO_MEM_LEAKS();
+}
+
+TEST(reDenseArray, Copying) {
+  {
+    reDenseArray<int> array(SHARED_ALLOCATOR);
+    for (int i = 0; i < 100; i++) {
+      array.add(i);
+    }
+    
+    reDenseArray<int> copy(array);
+    ASSERT_EQ(copy.size(), array.size()) <<
+      "should have equal sizes after copying";
+    
+    copy = copy;
+    for (reUInt i = 0; i < array.size(); i++) {
+      ASSERT_EQ(copy[i], array[i]) <<
+        "should have the elements copied correctly";
+    }
+    
+    copy.append(array);
+    ASSERT_EQ(copy.size(), 2 * array.size()) <<
+      "should have new size equal to sum of appended sizes";
+  }
+  
+  ASSERT_NO_MEM_LEAKS();
+}
+
+TEST(reDenseArray, Moving) {
+  {
+    reDenseArray<int> array(SHARED_ALLOCATOR);
+    for (int i = 0; i < 100; i++) {
+      array.add(i);
+    }
+    
+    const reUInt allocs = SHARED_ALLOCATOR.numAllocs();
+    reDenseArray<int> moved(std::move(array));
+    ASSERT_EQ(SHARED_ALLOCATOR.numAllocs(), allocs) <<
+      "should not allocate when moving";
+    ASSERT_EQ(moved.size(), 100) <<
+      "should take over the elements of the moved array";
+    ASSERT_TRUE(array.empty()) <<
+      "should leave the moved array empty";
+    
+    array = std::move(moved);
+    ASSERT_EQ(array.size(), 100) <<
+      "should take over the elements when move assigning";
+    for (reUInt i = 0; i < array.size(); i++) {
+      ASSERT_EQ(array[i], (int)i) <<
+        "should keep the elements in order";
+    }
+  }
+  
+  ASSERT_NO_MEM_LEAKS();
+}
@@ -159,3 +159,35 @@ TEST_F(reLinkedListTest, Copying) {
   ASSERT_NO_MEM_LEAKS();
 }
 
+
+TEST_F(reLinkedListTest, Moving) {
+  generateFixtures(100);
+  
+  for (int* ptr : fixtures) {
+    list.add(ptr);
+  }
+  
+  const reUInt allocs = SHARED_ALLOCATOR.numAllocs();
+  reLinkedList<int*> list2(std::move(list));
+  ASSERT_EQ(SHARED_ALLOCATOR.numAllocs(), allocs) <<
+    "should not allocate when moving";
+  ASSERT_EQ(list2.size(), 100) <<
+    "should take over the elements of the moved list";
+  ASSERT_EQ(list.size(), 0) <<
+    "should leave the moved list empty";
+  
+  list = std::move(list2);
+  ASSERT_EQ(SHARED_ALLOCATOR.numAllocs(), allocs) <<
+    "should not allocate when move assigning";
+  ASSERT_EQ(list.size(), 100) <<
+    "should take over the elements when move assigning";
+  
+  list = list;
+  ASSERT_EQ(list.size(), 100) <<
+    "should be unchanged by self assignment";
+  
+  list.clear();
+  list2.clear();
+  
+  ASSERT_NO_MEM_LEAKS();
+}
@@ -0,0 +1,77 @@
+#include "helpers.h"
+
+#include "react/Utilities/reSmallVector.h"
+
+TEST(reSmallVector, InlineStorage) {
+  {
+    reSmallVector<int, 4> vector(SHARED_ALLOCATOR);
+    for (int i = 0; i < 4; i++) {
+      vector.add(i);
+    }
+    
+    ASSERT_EQ(SHARED_ALLOCATOR.numAllocs(), 0) <<
+      "should not allocate while the elements fit inline";
+    
+    vector.add(4);
+    ASSERT_EQ(SHARED_ALLOCATOR.numAllocs(), 1) <<
+      "should allocate once it grows past the inline storage";
+    
+    ASSERT_TRUE(vector.remove(1)) <<
+      "should be able to remove contained elements";
+    
+    const int expected[] = { 0, 2, 3, 4 };
+    ASSERT_EQ(vector.size(), 4) <<
+      "should have decreased in size when removing an element";
+    
+    for (reUInt i = 0; i < vector.size(); i++) {
+      ASSERT_EQ(vector[i], expected[i]) <<
+        "should keep the remaining elements in order";
+    }
+    
+    reSmallVector<int, 4> copy(vector);
+    ASSERT_TRUE(copy.contains(4)) <<
+      "should have the elements copied correctly";
+    
+    vector.clear();
+    ASSERT_TRUE(vector.empty()) <<
+      "should remove all elements";
+  }
+  
+  ASSERT_NO_MEM_LEAKS();
+}
+
+TEST(reSmallVector, Moving) {
+  {
+    reSmallVector<int, 4> vector(SHARED_ALLOCATOR);
+    vector.add(1);
+    
+    reSmallVector<int, 4> small(std::move(vector));
+    ASSERT_TRUE(small.contains(1)) <<
+      "should copy inline elements when moving";
+    ASSERT_TRUE(vector.empty()) <<
+      "should leave the moved vector empty";
+    
+    for (int i = 0; i < 10; i++) {
+      vector.add(i);
+    }
+    
+    const reUInt allocs = SHARED_ALLOCATOR.numAllocs();
+    reSmallVector<int, 4> large(std::move(vector));
+    ASSERT_EQ(SHARED_ALLOCATOR.numAllocs(), allocs) <<
+      "should take over heap storage without allocating";
+    ASSERT_EQ(large.size(), 10) <<
+      "should take over the elements of the moved vector";
+    ASSERT_TRUE(vector.empty()) <<
+      "should leave the moved vector empty";
+    
+    vector.add(1);
+    ASSERT_EQ(SHARED_ALLOCATOR.numAllocs(), allocs) <<
+      "should return the moved vector to its inline storage";
+    
+    small = std::move(large);
+    ASSERT_EQ(small.size(), 10) <<
+      "should take over the elements when move assigning";
+  }
+  
+  ASSERT_NO_MEM_LEAKS();
+}
@@ -1,7 +1,12 @@
 #include "helpers.h"
 
 #include "reLinkedList.h"
+#include "reDenseArray.h"
+#include "reSmallVector.h"
 #include "ContactFilter.h"
+#include "ShapeCache.h"
+#include "ThreadPool.h"
+#include "Snapshot.h"
 
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
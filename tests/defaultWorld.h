@@ -4,6 +4,7 @@
 #include "react/Collision/Shapes/Sphere.h"
 #include "react/Entities/Rigid.h"
 #include "react/Collision/reBroadPhase.h"
+#include "react/Utilities/ShapeCache.h"
 
 /**
  * Integration test using default world parameters
@@ -33,3 +34,82 @@ TEST_F(DefaultWorldTest, AddRemoveClearActions) {
   ASSERT_EQ(world.entities().size(), 0) << "clear() should remove all entities";
 }
 
+TEST_F(DefaultWorldTest, BulkBuild) {
+  const re::Sphere sphere(1.0);
+  std::vector<re::EntityDesc> descs;
+  for (reUInt i = 0; i < 1000; i++) {
+    descs.push_back(re::EntityDesc(sphere, re::vec3::rand(100.0), i % 10 == 0));
+  }
+  
+  std::vector<re::Entity*> entities(descs.size());
+  ASSERT_EQ(world.build().Entities(descs.data(), descs.size(), entities.data()), descs.size()) << "should build every described entity";
+  ASSERT_EQ(world.entities().size(), descs.size()) << "should attach every entity to the world";
+  ASSERT_EQ(world.shapes().size(), 1) << "should share equal shapes between the entities";
+  
+  for (reUInt i = 0; i < descs.size(); i++) {
+    ASSERT_EQ(world.entity(entities[i]->handle()), entities[i]) << "should register every entity";
+    ASSERT_EQ(entities[i]->type(), descs[i].isStatic ? re::Entity::STATIC : re::Entity::RIGID) << "should build the described type of entity";
+  }
+  
+  world.destroy(*entities[1]);
+  ASSERT_EQ(world.entities().size(), descs.size() - 1) << "should be able to destroy entities built in bulk";
+  
+  re::Entity* extra = world.allocator(re::MEMORY_ENTITIES).alloc_new<re::Rigid>(world.shapes().instance(sphere));
+  re::Entity* const repeated[] = { entities[0], extra, extra };
+  ASSERT_EQ(world.add(repeated, 3), 1) << "should skip entities already in the world or repeated in the array";
+  ASSERT_EQ(world.entities().size(), descs.size()) << "should attach each entity only once";
+  
+  world.clear();
+}
+
+TEST_F(DefaultWorldTest, EntityHandles) {
+  re::Rigid& r = world.build().Rigid(re::Sphere(1.0));
+  const re::EntityHandle handle = r.handle();
+  ASSERT_EQ(world.entity(handle), &r) << "should resolve handles of entities in the world";
+  ASSERT_EQ(world.add(r), handle) << "add() should return the existing handle for repeated entities";
+  
+  ASSERT_TRUE(world.destroy(handle)) << "destroy() should accept valid handles";
+  ASSERT_EQ(world.entity(handle), nullptr) << "should not resolve handles of destroyed entities";
+  ASSERT_FALSE(world.destroy(handle)) << "destroy() should reject stale handles";
+}
+
+TEST_F(DefaultWorldTest, ForeignEntities) {
+  reWorld other;
+  re::Rigid& mine = world.build().Rigid(re::Sphere(1.0));
+  re::Rigid& foreign = other.build().Rigid(re::Sphere(1.0));
+  ASSERT_EQ(foreign.handle(), mine.handle()) << "should issue equal handles in both worlds";
+  const re::EntityHandle foreignHandle = foreign.handle();
+  
+  world.remove(foreign);
+  ASSERT_EQ(world.entities().size(), 1) << "remove() should ignore entities from other worlds";
+  ASSERT_EQ(world.entity(mine.handle()), &mine) << "remove() should not unregister a different entity with the same handle";
+  ASSERT_EQ(foreign.handle(), foreignHandle) << "remove() should leave the handles of entities from other worlds alone";
+  ASSERT_EQ(other.entity(foreignHandle), &foreign) << "remove() should leave other worlds unchanged";
+}
+
+TEST_F(DefaultWorldTest, TransformedShapes) {
+  for (reUInt i = 0; i < 100; i++) {
+    const re::Transform placement = re::Transform().rotate(0.7, 0.0, 0.0, 1.0).translate(i, 2.0, 0.0);
+    re::Rigid& body = world.build().Rigid(re::Sphere(1.0), placement);
+    ASSERT_EQ(body.shape().type(), reShape::SPHERE) <<
+      "should keep rigid placements on the entity instead of wrapping the shape";
+    ASSERT_TRUE(re::similar(body.shapeTransform(), body.transform() * placement)) <<
+      "should place the shape with the rigid transform";
+  }
+  ASSERT_EQ(world.shapes().size(), 1) <<
+    "should share the shape between entities placed differently";
+  
+  const re::Transform stretch = re::Transform().scale(1.0, 2.0, 3.0).translate(1.0, 0.0, 0.0);
+  for (reUInt i = 0; i < 100; i++) {
+    re::Rigid& body = world.build().Rigid(re::Sphere(1.0), stretch);
+    ASSERT_EQ(body.shape().type(), reShape::PROXY) <<
+      "should wrap the shape when the transform is not rigid";
+  }
+  ASSERT_EQ(world.shapes().size(), 2) <<
+    "should share a single proxy between entities with equal transforms";
+  
+  world.clear();
+  world.shapes().purge();
+  ASSERT_EQ(world.shapes().size(), 0) <<
+    "should destroy proxies along with the shapes they wrap when purged";
+}